@@ -0,0 +1,152 @@
+// CPU microbenchmark + equivalence check: the droplet distance-brick splatter (src/launcher/droplet_brick.cpp).
+// For a droplet-sized cluster of 64 particles, prints the splat cost per brick resolution and the largest
+// difference between the brick's trilinear sample and the exact field (droplet_fluid.glsl's map()) at
+// random points near the surface, in voxels; then the cost of the exact field per point for comparison.
+// Exits non-zero if a brick strays more than MAX_ERROR voxels from the field. With a file argument, also
+// writes the cluster and its bricks there as JSON for bench/shader_check.js (brick vs analytic images).
+//
+//   make bench && tmp/bench/droplet_brick_bench [fixture.json]
+
+#include "../src/launcher/droplet_brick.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const size_t PARTICLES   = 64;     // MAX_DROPLET_RAYMARCH_PARTICLES
+const float  RADIUS      = 0.050f; // DROPLET_RAYMARCH_PARTICLE_RADIUS
+const float  INFLUENCE   = 0.075f; // DROPLET_INFLUENCE_RADIUS
+const float  ISO         = -0.04f; // DROPLET_ISO_THRESHOLD
+const float  SPREAD      = 0.12f;  // cluster radius
+const float  BOX_MARGIN  = 1.08f;  // DROPLET_RAYMARCH_BOX_MARGIN
+const size_t REPEATS     = 200;
+const size_t PROBES      = 20000;
+const float  MAX_ERROR   = 0.5f;   // voxels: half the trilinear reach (measured 0.23..0.36)
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void write_array(FILE* file, const float* values, size_t count)
+{
+  fputc('[', file);
+
+  for (size_t i=0; i<count; i++)
+    fprintf(file, i ? ",%.7g" : "%.7g", values[i]);
+
+  fputc(']', file);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  std::mt19937                          random(7);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::vector<float>                    particles;
+  const float                           center[3] = {0.3f, 1.2f, -0.4f};
+  float                                 max_dist  = 0.0f;
+
+  while (particles.size() < PARTICLES * 4)
+  {
+    float x = unit(random), y = unit(random), z = unit(random);
+
+    if (x * x + y * y + z * z > 1.0f)
+      continue;
+
+    particles.insert(particles.end(), {center[0] + x * SPREAD, center[1] + y * SPREAD, center[2] + z * SPREAD, RADIUS});
+    max_dist = std::max(max_dist, std::sqrt(x * x + y * y + z * z) * SPREAD);
+  }
+
+  const float              half = (max_dist + RADIUS + INFLUENCE) * BOX_MARGIN;
+  const DropletBrickParams params {INFLUENCE, ISO};
+
+  DropletBrick brick;
+  bool         ok      = true;
+  FILE*        fixture = argc > 1 ? fopen(argv[1], "w") : nullptr;
+
+  if (argc > 1 && !fixture)
+  {
+    fprintf(stderr, "can't write %s\n", argv[1]);
+    return 1;
+  }
+
+  if (fixture)
+  {
+    fprintf(fixture, "{\"center\":[%.7g,%.7g,%.7g],\"halfExtent\":%.7g,\"influence\":%.7g,\"iso\":%.7g,\"particles\":",
+      center[0], center[1], center[2], half, INFLUENCE, ISO);
+    write_array(fixture, particles.data(), particles.size());
+    fprintf(fixture, ",\"bricks\":{");
+  }
+
+  for (size_t resolution=DROPLET_BRICK_MIN_RESOLUTION; resolution<=DROPLET_BRICK_MAX_RESOLUTION; resolution+=DROPLET_BRICK_RESOLUTION_STEP)
+  {
+    double t0 = now_ms();
+
+    for (size_t r=0; r<REPEATS; r++)
+      brick.splat(particles.data(), PARTICLES, center, half, resolution, params);
+
+    double ms = (now_ms() - t0) / REPEATS;
+
+      //near the surface the brick must match the exact field up to the trilinear error
+
+    float  voxel     = 2.0f * half / float(resolution);
+    float  max_error = 0.0f;
+    size_t probed    = 0;
+
+    for (size_t i=0; i<PROBES; i++)
+    {
+      float x = center[0] + unit(random) * half, y = center[1] + unit(random) * half, z = center[2] + unit(random) * half;
+      float exact = DropletBrick::field(particles.data(), PARTICLES, x, y, z, params);
+
+      if (std::fabs(exact) > voxel)
+        continue;
+
+      max_error = std::max(max_error, std::fabs(brick.sample(x, y, z) - exact));
+      probed++;
+    }
+
+    bool match = max_error / voxel <= MAX_ERROR && probed;
+
+    printf("%2zu^3 brick: splat %7.3f ms, max error %.3f voxels over %zu surface probes%s\n", resolution, ms, max_error / voxel,
+      probed, match ? "" : "  MISMATCH");
+
+    ok = ok && match;
+
+    if (fixture)
+    {
+      fprintf(fixture, "%s\"%zu\":", resolution == DROPLET_BRICK_MIN_RESOLUTION ? "" : ",", resolution);
+      write_array(fixture, brick.data(), resolution * resolution * resolution);
+    }
+  }
+
+  if (fixture)
+  {
+    fprintf(fixture, "}}\n");
+    fclose(fixture);
+  }
+
+    //the analytic path evaluates the whole field at every step of every pixel
+
+  double t0  = now_ms();
+  float  sum = 0.0f;
+
+  for (size_t i=0; i<PROBES; i++)
+    sum += DropletBrick::field(particles.data(), PARTICLES, center[0] + unit(random) * half, center[1], center[2], params);
+
+  double us = (now_ms() - t0) * 1000.0 / PROBES;
+
+  printf("exact field: %.3f us per point (%zu particles; checksum %.1f), brick sample: one trilinear fetch\n", us, PARTICLES, sum);
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// CPU microbenchmark: spatial-hash droplet clustering (src/launcher/droplet_cluster.cpp) vs the
+// linear-scan clustering World::update used before. Same greedy semantics -> same cluster count and
+// centres (within float tolerance); prints both timings per particle budget and exits non-zero on a mismatch.
+//
+//   make bench && tmp/bench/droplet_cluster_bench
+
+#include "../src/launcher/droplet_cluster.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float  CLUSTER_RADIUS  = 0.027f * 20.0f; // live.physical_radius * 20 (World::update)
+const size_t PASSES_COUNT    = 3;              // CLUSTERIZE_STEPS_COUNT
+const float  PASS_FACTOR     = 1.2f;           // CLUSTERIZE_STEP_FACTOR
+const size_t PARTICLES_PER_DROPLET = 20;
+const float  MAX_CENTER_ERROR      = 1.0e-4f;  // incremental vs re-summed centroids (float rounding only)
+
+struct ReferenceDroplet
+{
+  math::vec3f              center;
+  std::vector<math::vec3f> points;
+};
+
+// the pre-hash clustering pass, verbatim modulo containers
+void reference_pass(std::vector<ReferenceDroplet>& droplets, const std::vector<math::vec3f>& particles, float radius)
+{
+  for (ReferenceDroplet& droplet : droplets)
+    droplet.points.clear();
+
+  for (const math::vec3f& position : particles)
+  {
+    bool added = false;
+
+    for (ReferenceDroplet& droplet : droplets)
+    {
+      if (math::length(droplet.center - position) < radius)
+      {
+        droplet.points.push_back(position);
+        droplet.center = math::vec3f(0.0f);
+
+        for (const math::vec3f& point : droplet.points)
+          droplet.center += point;
+
+        droplet.center /= droplet.points.size();
+        added = true;
+        break;
+      }
+    }
+
+    if (!added)
+    {
+      ReferenceDroplet droplet;
+      droplet.center = position;
+      droplet.points.push_back(position);
+      droplets.push_back(droplet);
+    }
+  }
+}
+
+void hashed_pass(DropletClusterer& clusterer, std::vector<math::vec3f>& centers, const std::vector<math::vec3f>& particles, float radius)
+{
+  clusterer.reset(radius);
+
+  for (const math::vec3f& center : centers)
+    clusterer.add_cluster(center);
+
+  for (const math::vec3f& position : particles)
+    clusterer.assign(position);
+
+  centers.resize(clusterer.clusters_count());
+
+  for (size_t i=0; i<centers.size(); i++)
+    centers[i] = clusterer.center(i);
+}
+
+// droplet-sized blobs scattered through the tree volume (the shape the spawner produces)
+std::vector<math::vec3f> make_particles(size_t count, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> spread(-4.0f, 4.0f), height(-6.0f, 6.0f), local(-0.07f, 0.07f);
+  std::vector<math::vec3f> particles;
+
+  particles.reserve(count);
+
+  while (particles.size() < count)
+  {
+    math::vec3f center(spread(rng), height(rng), spread(rng));
+
+    for (size_t i=0; i<PARTICLES_PER_DROPLET && particles.size() < count; i++)
+      particles.push_back(center + math::vec3f(local(rng), local(rng), local(rng)));
+  }
+
+  return particles;
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool run(size_t particles_count, size_t frames)
+{
+  std::vector<math::vec3f> particles = make_particles(particles_count, 1234u);
+
+    //reference
+
+  std::vector<ReferenceDroplet> reference;
+  double t0 = now_ms();
+
+  for (size_t f=0; f<frames; f++)
+  {
+    float radius = CLUSTER_RADIUS;
+
+    for (size_t i=0; i<PASSES_COUNT; i++, radius *= PASS_FACTOR)
+      reference_pass(reference, particles, radius);
+  }
+
+  double reference_ms = (now_ms() - t0) / frames;
+
+    //spatial hash
+
+  DropletClusterer clusterer;
+  std::vector<math::vec3f> centers;
+
+  t0 = now_ms();
+
+  for (size_t f=0; f<frames; f++)
+  {
+    float radius = CLUSTER_RADIUS;
+
+    for (size_t i=0; i<PASSES_COUNT; i++, radius *= PASS_FACTOR)
+      hashed_pass(clusterer, centers, particles, radius);
+  }
+
+  double hashed_ms = (now_ms() - t0) / frames;
+
+    //compare
+
+  float max_error = 0.0f;
+
+  for (size_t i=0; i<centers.size() && i<reference.size(); i++)
+    max_error = std::max(max_error, math::length(centers[i] - reference[i].center));
+
+  bool ok = centers.size() == reference.size() && max_error <= MAX_CENTER_ERROR;
+
+  printf("%6zu particles: linear %9.3f ms/frame, clusterer %7.3f ms/frame (x%.1f), clusters %zu/%zu, max centre error %g%s\n",
+    particles_count, reference_ms, hashed_ms, reference_ms / (hashed_ms > 0.0 ? hashed_ms : 1e-9),
+    centers.size(), reference.size(), max_error, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+}
+
+int main()
+{
+  bool ok = true;
+
+  ok = run(600, 200) && ok;   // MAX_PARTICLES_COUNT: a few dozen clusters -> linear scan
+  ok = run(1500, 50) && ok;   // crosses into the grid during the pass
+  ok = run(5000, 10) && ok;
+  ok = run(50000, 1) && ok;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
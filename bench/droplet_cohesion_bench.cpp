@@ -0,0 +1,159 @@
+// CPU microbenchmark + equivalence check: cell-list SoA cohesion kernel (src/launcher/droplet_cohesion.cpp)
+// vs the O(n^2) pair loop apply_droplet_surface_tension used before. Prints per-droplet cost and the
+// largest per-particle acceleration difference relative to the largest acceleration; exits non-zero when
+// it exceeds MAX_RELATIVE_ERROR.
+//
+//   make bench && tmp/bench/droplet_cohesion_bench
+
+#include "../src/launcher/droplet_cohesion.h"
+
+#include <math/vector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float PARTICLE_RADIUS    = 0.027f;   // DROPLET_PARTICLE_RADIUS
+const float COHESION_RADIUS    = 0.11f;    // DROPLET_COHESION_RADIUS
+const float SURFACE_TENSION    = 1.0f;     // DROPLET_SURFACE_TENSION
+const float VISCOSITY          = 1.0f;     // DROPLET_VISCOSITY
+const float MAX_RELATIVE_ERROR = 1.0e-5f;  // same sums in another order -> float rounding only
+
+// the pre-SoA pair loop, verbatim modulo btVector3 -> math::vec3f
+void reference(const std::vector<math::vec3f>& pos, const std::vector<math::vec3f>& vel, std::vector<math::vec3f>& acc, float h, float gamma, float visc)
+{
+  const size_t n  = pos.size();
+  const float  h2 = h * h;
+
+  acc.assign(n, math::vec3f(0.0f));
+
+  for (size_t i = 0; i < n; i++)
+  {
+    const math::vec3f& pi = pos[i];
+    const math::vec3f& vi = vel[i];
+    for (size_t j = i + 1; j < n; j++)
+    {
+      math::vec3f d  = pi - pos[j];
+      float       r2 = math::dot(d, d);
+      if (r2 >= h2 || r2 < 1.0e-10f)
+        continue;
+      float r   = std::sqrt(r2);
+      float x   = r / h;
+      float w   = 4.0f * x * (1.0f - x);
+      math::vec3f dir = d / r;
+      math::vec3f ai  = dir * (-gamma * w) + (vel[j] - vi) * (visc * w);
+      acc[i] += ai;
+      acc[j] -= ai;
+    }
+  }
+}
+
+// a roughly close-packed ball of particles (spacing ~ particle diameter), like a settled droplet
+void make_droplet(size_t count, std::vector<math::vec3f>& pos, std::vector<math::vec3f>& vel, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  float radius = 2.0f * PARTICLE_RADIUS * std::cbrt(float(count));
+
+  pos.clear();
+  vel.clear();
+
+  while (pos.size() < count)
+  {
+    math::vec3f p(unit(rng), unit(rng), unit(rng));
+
+    if (math::dot(p, p) > 1.0f)
+      continue;
+
+    pos.push_back(p * radius);
+    vel.push_back(math::vec3f(unit(rng), unit(rng) - 2.0f, unit(rng)) * 0.3f);
+  }
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool run(size_t count, size_t iterations)
+{
+  std::vector<math::vec3f> pos, vel, acc;
+
+  make_droplet(count, pos, vel, 4321u);
+
+  double t0 = now_ms();
+
+  for (size_t it=0; it<iterations; it++)
+    reference(pos, vel, acc, COHESION_RADIUS, SURFACE_TENSION, VISCOSITY);
+
+  double reference_ms = (now_ms() - t0) / iterations;
+
+  CohesionParticles particles;
+  CohesionSolver    solver;
+  CohesionParams    params;
+
+  params.radius    = COHESION_RADIUS;
+  params.cohesion  = SURFACE_TENSION;
+  params.viscosity = VISCOSITY;
+
+  t0 = now_ms();
+
+  for (size_t it=0; it<iterations; it++)
+  {
+    particles.resize(count);
+
+    for (size_t i=0; i<count; i++)
+    {
+      particles.px[i] = pos[i].x; particles.py[i] = pos[i].y; particles.pz[i] = pos[i].z;
+      particles.vx[i] = vel[i].x; particles.vy[i] = vel[i].y; particles.vz[i] = vel[i].z;
+    }
+
+    solver.compute(particles, params);
+  }
+
+  double soa_ms = (now_ms() - t0) / iterations;
+
+  float max_acc = 0.0f, max_error = 0.0f;
+
+  for (size_t i=0; i<count; i++)
+  {
+    math::vec3f a(particles.ax[i], particles.ay[i], particles.az[i]);
+
+    max_acc   = std::max(max_acc, math::length(acc[i]));
+    max_error = std::max(max_error, math::length(a - acc[i]));
+  }
+
+  float relative_error = max_acc > 0.0f ? max_error / max_acc : 0.0f;
+  bool  ok             = relative_error <= MAX_RELATIVE_ERROR;
+
+  printf("%6zu particles: pair loop %9.4f ms, cell list %8.4f ms (x%.1f), max relative error %.2e%s\n",
+    count, reference_ms, soa_ms, reference_ms / (soa_ms > 0.0 ? soa_ms : 1e-9), relative_error, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+}
+
+int main()
+{
+  bool ok = true;
+
+  ok = run(20, 20000) && ok;
+  ok = run(100, 2000) && ok;
+  ok = run(400, 200) && ok;
+  ok = run(2000, 20) && ok;
+  ok = run(10000, 2) && ok;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
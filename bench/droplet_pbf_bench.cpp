@@ -0,0 +1,432 @@
+// Headless benchmark of the position-based droplet fluid (src/launcher/droplet_pbf.cpp) vs the rigid-sphere
+// particle path, at 600 (MAX_PARTICLES_COUNT), 2k and 10k particles. Both drop the same droplets (balls of
+// particles) onto a few tilted leaf boxes above a ground box and run 4 simulated seconds at 60 Hz.
+//
+// Bullet is not available natively, so the rigid-sphere path is modelled by its particle-side work: the
+// cohesion kernel the world applies per frame (CohesionSolver), sphere-sphere and sphere-collider contacts
+// found on a grid and resolved by 10 sequential-impulse iterations (btSequentialImpulseConstraintSolver's
+// default), and semi-implicit Euler. Bullet adds a broadphase, manifolds and islands on top, so the rigid
+// timings are a lower bound. Reports ms per step, the deepest particle overlap (fraction of a diameter)
+// and the share of particles at rest at the end.
+//
+//   make bench && tmp/bench/droplet_pbf_bench
+
+#include "../src/launcher/droplet_cohesion.h"
+#include "../src/launcher/droplet_pbf.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float  PARTICLE_RADIUS    = 0.027f;  // DROPLET_PARTICLE_RADIUS
+const float  COHESION_RADIUS    = 0.11f;   // DROPLET_COHESION_RADIUS
+const float  SURFACE_TENSION    = 1.0f;    // DROPLET_SURFACE_TENSION
+const float  VISCOSITY          = 1.0f;    // DROPLET_VISCOSITY
+const float  GRAVITY            = -15.0f;  // World::Impl gravity
+const float  TIME_STEP          = 1.0f / 60.0f;
+const size_t STEPS              = 240;
+const size_t DROPLET_PARTICLES  = 20;      // LiveTuning::particles_per_droplet
+const size_t SOLVER_ITERATIONS  = 10;      // Bullet's default contact solver iterations
+const float  REST_SPEED         = 0.05f;
+
+struct Scene
+{
+  std::vector<PbfCollider> colliders;
+  std::vector<float>       x, y, z;  // initial particles
+};
+
+PbfCollider make_box(float cx, float cy, float cz, float hx, float hy, float hz, float tilt)
+{
+  PbfCollider box;
+
+  float c = std::cos(tilt), s = std::sin(tilt);
+  float axes[3][3] = {{c, s, 0.0f}, {-s, c, 0.0f}, {0.0f, 0.0f, 1.0f}}; // rotated about z
+
+  box.center[0] = cx; box.center[1] = cy; box.center[2] = cz;
+  box.half_extent[0] = hx; box.half_extent[1] = hy; box.half_extent[2] = hz;
+
+  for (int k=0; k<3; k++)
+    for (int m=0; m<3; m++)
+      box.axes[k][m] = axes[k][m];
+
+  for (int m=0; m<3; m++)
+    box.linear_velocity[m] = box.angular_velocity[m] = 0.0f;
+
+  box.friction = 0.6f;
+
+  return box;
+}
+
+// droplets of DROPLET_PARTICLES over an area that grows with the count, falling onto leaves and the ground
+Scene make_scene(size_t count)
+{
+  Scene scene;
+
+  float half = 0.5f * std::sqrt(float(count) / 600.0f) + 0.5f;
+
+  scene.colliders.push_back(make_box(0.0f, -1.0f, 0.0f, half + 1.0f, 0.1f, half + 1.0f, 0.0f)); // ground
+
+  for (int l=0; l<9; l++)
+  {
+    float lx = (float(l % 3) - 1.0f) * half * 0.6f, lz = (float(l / 3) - 1.0f) * half * 0.6f;
+
+    scene.colliders.push_back(make_box(lx, 0.2f + 0.1f * float(l % 2), lz, 0.3f, 0.01f, 0.15f, l % 2 ? 0.35f : -0.35f)); // leaves
+  }
+
+  std::mt19937 rng(99u);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  const float ball = PARTICLE_RADIUS * 20.0f / 8.0f;
+
+  while (scene.x.size() < count)
+  {
+    float cx = unit(rng) * half, cy = 0.8f + 0.5f * (unit(rng) + 1.0f), cz = unit(rng) * half;
+
+    for (size_t k=0; k<DROPLET_PARTICLES && scene.x.size() < count;)
+    {
+      float px = unit(rng), py = unit(rng), pz = unit(rng);
+
+      if (px * px + py * py + pz * pz > 1.0f)
+        continue;
+
+      scene.x.push_back(cx + px * ball);
+      scene.y.push_back(cy + py * ball);
+      scene.z.push_back(cz + pz * ball);
+      k++;
+    }
+  }
+
+  return scene;
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// signed distance to a box collider and its outward normal (droplet_pbf.cpp's SDF)
+float box_distance(const PbfCollider& c, const float p[3], float normal[3])
+{
+  float local[3], q[3], n[3] = {0.0f, 0.0f, 0.0f};
+
+  for (int k=0; k<3; k++)
+  {
+    local[k] = (p[0] - c.center[0]) * c.axes[k][0] + (p[1] - c.center[1]) * c.axes[k][1] + (p[2] - c.center[2]) * c.axes[k][2];
+    q[k]     = std::fabs(local[k]) - c.half_extent[k];
+  }
+
+  float o[3] = {std::max(q[0], 0.0f), std::max(q[1], 0.0f), std::max(q[2], 0.0f)};
+  float ol   = std::sqrt(o[0] * o[0] + o[1] * o[1] + o[2] * o[2]);
+  float distance;
+
+  if (ol > 0.0f)
+  {
+    for (int k=0; k<3; k++)
+      n[k] = std::copysign(o[k] / ol, local[k]);
+
+    distance = ol;
+  }
+  else
+  {
+    int axis = q[0] > q[1] ? (q[0] > q[2] ? 0 : 2) : (q[1] > q[2] ? 1 : 2);
+
+    n[axis]  = std::copysign(1.0f, local[axis]);
+    distance = q[axis];
+  }
+
+  for (int m=0; m<3; m++)
+    normal[m] = n[0] * c.axes[0][m] + n[1] * c.axes[1][m] + n[2] * c.axes[2][m];
+
+  return distance;
+}
+
+// The rigid-sphere particle path: cohesion forces, then sequential impulses on sphere contacts
+class RigidSpheres
+{
+  public:
+    RigidSpheres(const Scene& scene) : colliders(scene.colliders)
+    {
+      size_t n = scene.x.size();
+
+      particles.resize(n);
+
+      for (size_t i=0; i<n; i++)
+      {
+        particles.px[i] = scene.x[i]; particles.py[i] = scene.y[i]; particles.pz[i] = scene.z[i];
+        particles.vx[i] = particles.vy[i] = particles.vz[i] = 0.0f;
+      }
+
+      params.radius    = COHESION_RADIUS;
+      params.cohesion  = SURFACE_TENSION;
+      params.viscosity = VISCOSITY;
+    }
+
+    void step(float dt)
+    {
+      CohesionParticles& p = particles;
+      const size_t       n = p.size();
+
+      cohesion.compute(p, params);
+
+      for (size_t i=0; i<n; i++)
+      {
+        p.vx[i] += p.ax[i] * dt;
+        p.vy[i] += (p.ay[i] + GRAVITY) * dt;
+        p.vz[i] += p.az[i] * dt;
+      }
+
+      find_contacts();
+
+      for (size_t it=0; it<SOLVER_ITERATIONS; it++)
+        solve_contacts(dt);
+
+      for (size_t i=0; i<n; i++)
+      {
+        p.px[i] += p.vx[i] * dt;
+        p.py[i] += p.vy[i] * dt;
+        p.pz[i] += p.vz[i] * dt;
+      }
+    }
+
+    const CohesionParticles& state() const { return particles; }
+
+  private:
+    struct PairContact
+    {
+      uint32_t a, b;       // b == NO_PARTICLE: collider contact, collider index in c
+      uint32_t c;
+      float    n[3];       // from b (or the collider) towards a
+      float    depth;      // > 0 separation, < 0 penetration
+      float    impulse;
+    };
+
+    static const uint32_t NO_PARTICLE = 0xffffffffu;
+
+    void find_contacts()
+    {
+      const CohesionParticles& p = particles;
+      const size_t             n = p.size();
+      const float              d = 2.0f * PARTICLE_RADIUS, margin = 0.5f * d, inv_cell = 1.0f / (d + margin);
+
+      keys.resize(n);
+
+      for (size_t i=0; i<n; i++)
+        keys[i] = std::make_pair(cell_key(int(std::floor(p.px[i] * inv_cell)), int(std::floor(p.py[i] * inv_cell)), int(std::floor(p.pz[i] * inv_cell))), uint32_t(i));
+
+      std::sort(keys.begin(), keys.end());
+
+      contacts.clear();
+
+      for (size_t i=0; i<n; i++)
+      {
+        int cx = int(std::floor(p.px[i] * inv_cell)), cy = int(std::floor(p.py[i] * inv_cell)), cz = int(std::floor(p.pz[i] * inv_cell));
+
+        for (int ox=-1; ox<=1; ox++)
+          for (int oy=-1; oy<=1; oy++)
+            for (int oz=-1; oz<=1; oz++)
+            {
+              uint64_t key = cell_key(cx + ox, cy + oy, cz + oz);
+
+              for (auto it=std::lower_bound(keys.begin(), keys.end(), std::make_pair(key, uint32_t(0))); it!=keys.end() && it->first == key; ++it)
+              {
+                uint32_t j = it->second;
+
+                if (j <= i)
+                  continue;
+
+                float dx = p.px[i] - p.px[j], dy = p.py[i] - p.py[j], dz = p.pz[i] - p.pz[j];
+                float r  = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+                if (r >= d + margin || r < 1.0e-6f)
+                  continue;
+
+                PairContact contact = {uint32_t(i), j, 0, {dx / r, dy / r, dz / r}, r - d, 0.0f};
+
+                contacts.push_back(contact);
+              }
+            }
+
+        const float pi[3] = {p.px[i], p.py[i], p.pz[i]};
+
+        for (size_t c=0; c<colliders.size(); c++)
+        {
+          float normal[3];
+          float depth = box_distance(colliders[c], pi, normal) - PARTICLE_RADIUS;
+
+          if (depth >= margin)
+            continue;
+
+          PairContact contact = {uint32_t(i), NO_PARTICLE, uint32_t(c), {normal[0], normal[1], normal[2]}, depth, 0.0f};
+
+          contacts.push_back(contact);
+        }
+      }
+    }
+
+    void solve_contacts(float dt)
+    {
+      CohesionParticles& p = particles;
+
+      for (PairContact& contact : contacts)
+      {
+        const uint32_t a = contact.a, b = contact.b;
+
+        float rvx = p.vx[a], rvy = p.vy[a], rvz = p.vz[a];
+
+        if (b != NO_PARTICLE)
+        {
+          rvx -= p.vx[b]; rvy -= p.vy[b]; rvz -= p.vz[b];
+        }
+
+        float vn     = rvx * contact.n[0] + rvy * contact.n[1] + rvz * contact.n[2];
+        float target = contact.depth < 0.0f ? -0.2f * contact.depth / dt : -contact.depth / dt; // Baumgarte / speculative
+        float mass   = b != NO_PARTICLE ? 0.5f : 1.0f;
+        float delta  = (target - vn) * mass;
+        float total  = std::max(contact.impulse + delta, 0.0f);
+
+        delta           = total - contact.impulse;
+        contact.impulse = total;
+
+        p.vx[a] += delta * contact.n[0]; p.vy[a] += delta * contact.n[1]; p.vz[a] += delta * contact.n[2];
+
+        if (b != NO_PARTICLE)
+        {
+          p.vx[b] -= delta * contact.n[0]; p.vy[b] -= delta * contact.n[1]; p.vz[b] -= delta * contact.n[2];
+        }
+        else if (total > 0.0f) // friction against the collider
+        {
+          float tvx = p.vx[a] - vn * contact.n[0], tvy = p.vy[a] - vn * contact.n[1], tvz = p.vz[a] - vn * contact.n[2];
+          float keep = 1.0f - colliders[contact.c].friction / float(SOLVER_ITERATIONS);
+
+          p.vx[a] += tvx * (keep - 1.0f); p.vy[a] += tvy * (keep - 1.0f); p.vz[a] += tvz * (keep - 1.0f);
+        }
+      }
+    }
+
+    static uint64_t cell_key(int x, int y, int z)
+    {
+      return (uint64_t(uint32_t(x + (1 << 20)) & 0x1fffff) << 42) | (uint64_t(uint32_t(y + (1 << 20)) & 0x1fffff) << 21) | uint64_t(uint32_t(z + (1 << 20)) & 0x1fffff);
+    }
+
+  private:
+    std::vector<PbfCollider>                   colliders;
+    CohesionParticles                          particles;
+    CohesionSolver                             cohesion;
+    CohesionParams                             params;
+    std::vector<std::pair<uint64_t, uint32_t>> keys;
+    std::vector<PairContact>                   contacts;
+};
+
+// deepest overlap between two particles, as a fraction of a diameter, and the share of particles at rest
+void measure(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z,
+             const std::vector<float>& vx, const std::vector<float>& vy, const std::vector<float>& vz,
+             float& max_overlap, float& resting)
+{
+  const size_t n = x.size();
+  const float  d = 2.0f * PARTICLE_RADIUS;
+
+  std::vector<size_t> order(n);
+
+  for (size_t i=0; i<n; i++)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return x[a] < x[b]; }); // sweep along x
+
+  max_overlap = 0.0f;
+
+  for (size_t a=0; a<n; a++)
+    for (size_t b=a+1; b<n && x[order[b]] - x[order[a]] < d; b++)
+    {
+      size_t i = order[a], j = order[b];
+      float  dx = x[i] - x[j], dy = y[i] - y[j], dz = z[i] - z[j];
+      float  r  = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+      max_overlap = std::max(max_overlap, 1.0f - r / d);
+    }
+
+  size_t at_rest = 0;
+
+  for (size_t i=0; i<n; i++)
+    if (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i] < REST_SPEED * REST_SPEED)
+      at_rest++;
+
+  resting = n ? float(at_rest) / float(n) : 0.0f;
+}
+
+void run(size_t count)
+{
+  Scene scene = make_scene(count);
+
+    //position-based fluid
+
+  PbfSolver solver;
+  PbfParams params;
+
+  params.particle_radius  = PARTICLE_RADIUS;
+  params.smoothing_radius = COHESION_RADIUS;
+  params.gravity          = GRAVITY;
+  params.cohesion         = SURFACE_TENSION;
+  params.viscosity        = VISCOSITY;
+
+  solver.set_params(params);
+  solver.reserve(count);
+
+  for (size_t i=0; i<count; i++)
+    solver.add(scene.x[i], scene.y[i], scene.z[i], 0.0f, 0.0f, 0.0f);
+
+  std::vector<PbfCollider> colliders = scene.colliders;
+
+  double t0 = now_ms();
+
+  for (size_t s=0; s<STEPS; s++)
+    solver.step(TIME_STEP, colliders.data(), colliders.size());
+
+  double pbf_ms = (now_ms() - t0) / STEPS;
+
+  const PbfParticles& fluid = solver.particles();
+
+  float pbf_overlap, pbf_resting;
+
+  measure(fluid.px, fluid.py, fluid.pz, fluid.vx, fluid.vy, fluid.vz, pbf_overlap, pbf_resting);
+
+    //rigid spheres
+
+  RigidSpheres spheres(scene);
+
+  t0 = now_ms();
+
+  for (size_t s=0; s<STEPS; s++)
+    spheres.step(TIME_STEP);
+
+  double rigid_ms = (now_ms() - t0) / STEPS;
+
+  const CohesionParticles& rigid = spheres.state();
+
+  float rigid_overlap, rigid_resting;
+
+  measure(rigid.px, rigid.py, rigid.pz, rigid.vx, rigid.vy, rigid.vz, rigid_overlap, rigid_resting);
+
+  printf("%6zu particles: pbf %8.3f ms/step (%4.1f neighbours, overlap %4.2f, %3.0f%% at rest) | rigid spheres %8.3f ms/step (overlap %4.2f, %3.0f%% at rest) x%.1f\n",
+    count, pbf_ms, solver.average_neighbours(), pbf_overlap, pbf_resting * 100.0f,
+    rigid_ms, rigid_overlap, rigid_resting * 100.0f, rigid_ms / (pbf_ms > 0.0 ? pbf_ms : 1e-9));
+}
+
+}
+
+int main()
+{
+  const size_t counts[] = {600, 2000, 10000};
+
+  for (size_t count : counts)
+    run(count);
+
+  return 0;
+}
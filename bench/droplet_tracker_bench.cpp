@@ -0,0 +1,335 @@
+// CPU microbenchmark: incremental droplet tracking (src/launcher/droplet_tracker.cpp) vs re-clustering
+// every particle every frame with the spatial-hash clusterer (the 3 widening passes World::update ran
+// before). Droplet-sized blobs drift and wobble; every few frames one blob splits in two and two blobs
+// merge. Prints timings, how many particles looked for a droplet, and how many particles changed
+// droplet between frames (the re-clustering's cluster indices shift whenever a droplet before them
+// appears or goes; the tracker's ids don't). First, a short hand-scripted scene checks the tracker
+// exactly: separated blobs, one split and one merge must give exactly the matching events, and every
+// particle must keep its blob's droplet id every frame (forwarded to the survivor once merged); exits
+// non-zero on a mismatch.
+//
+//   make bench && tmp/bench/droplet_tracker_bench
+
+#include "../src/launcher/droplet_cluster.h"
+#include "../src/launcher/droplet_tracker.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float  CLUSTER_RADIUS        = 0.027f * 20.0f; // live.physical_radius * 20 (World::update)
+const size_t PASSES_COUNT          = 3;              // CLUSTERIZE_STEPS_COUNT
+const float  PASS_FACTOR           = 1.2f;           // CLUSTERIZE_STEP_FACTOR
+const size_t PARTICLES_PER_DROPLET = 20;
+const size_t EVENT_INTERVAL        = 60;             // frames between a split and a merge
+
+const size_t CHECK_BLOBS        = 5;     // scripted check: blobs on a line, CHECK_SPACING apart (never merged)
+const float  CHECK_SPACING      = 4.0f;
+const size_t CHECK_FRAMES       = 150;
+const size_t CHECK_SPLIT_FRAME  = 10;    // half of blob CHECK_SPLIT leaves 3 radii away
+const size_t CHECK_SPLIT        = 1;
+const size_t CHECK_MERGE_FRAME  = 20;    // from then blob CHECK_MERGE drifts into CHECK_MERGE + 1
+const size_t CHECK_MERGE        = 3;
+const float  CHECK_MERGE_SPEED  = 0.05f; // per frame, well inside the keep radius
+const float  CHECK_MERGE_GAP    = 0.2f;  // where it stops, from the other blob's centre
+
+// Blobs of particles: every particle follows its blob's centre at a fixed offset plus a wobble
+struct Scene
+{
+  std::vector<math::vec3f> blob_centers, blob_velocities;
+  std::vector<size_t>      blob_of;
+  std::vector<math::vec3f> offsets;
+  std::vector<math::vec3f> positions;
+  std::mt19937             rng;
+
+  Scene(size_t particles_count, unsigned seed) : rng(seed)
+  {
+    std::uniform_real_distribution<float> spread(-4.0f, 4.0f), height(-6.0f, 6.0f), local(-0.07f, 0.07f), drift(-0.01f, 0.01f);
+
+    for (size_t i=0; i<particles_count; i++)
+    {
+      if (i % PARTICLES_PER_DROPLET == 0)
+      {
+        blob_centers.push_back(math::vec3f(spread(rng), height(rng), spread(rng)));
+        blob_velocities.push_back(math::vec3f(drift(rng), drift(rng), drift(rng)));
+      }
+
+      blob_of.push_back(blob_centers.size() - 1);
+      offsets.push_back(math::vec3f(local(rng), local(rng), local(rng)));
+    }
+
+    positions.resize(particles_count);
+  }
+
+  void step(size_t frame)
+  {
+    std::uniform_real_distribution<float> wobble(-0.005f, 0.005f);
+    std::uniform_int_distribution<size_t> pick(0, blob_centers.size() - 1);
+
+    if (frame && frame % EVENT_INTERVAL == 0 && blob_centers.size() > 2)
+    {
+        //split: half of a blob's particles leave as a new blob
+
+      size_t from = pick(rng);
+
+      blob_centers.push_back(blob_centers[from] + math::vec3f(CLUSTER_RADIUS * 3.0f, 0.0f, 0.0f));
+      blob_velocities.push_back(blob_velocities[from]);
+
+      for (size_t i=0, half=0; i<blob_of.size(); i++)
+        if (blob_of[i] == from && half++ % 2)
+          blob_of[i] = blob_centers.size() - 1;
+
+        //merge: another blob's particles join a third one
+
+      size_t a = pick(rng), b = pick(rng);
+
+      for (size_t& blob : blob_of)
+        if (blob == a && a != b)
+          blob = b;
+    }
+
+    for (size_t i=0; i<blob_centers.size(); i++)
+      blob_centers[i] += blob_velocities[i];
+
+    for (size_t i=0; i<positions.size(); i++)
+      positions[i] = blob_centers[blob_of[i]] + offsets[i] + math::vec3f(wobble(rng), wobble(rng), wobble(rng));
+  }
+};
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The scripted scene: CHECK_BLOBS created on the first frame, one split (of CHECK_SPLIT's droplet) and
+// one merge (the droplets are the same size, so the older CHECK_MERGE's absorbs CHECK_MERGE + 1's), no
+// other event; each particle's label is its blob's droplet id every frame
+bool check_scripted()
+{
+  DropletTracker        tracker;
+  DropletTrackerParams  params;
+  std::mt19937          rng(99u);
+  std::uniform_real_distribution<float> local(-0.07f, 0.07f), wobble(-0.005f, 0.005f);
+
+  params.radius = CLUSTER_RADIUS;
+
+  tracker.set_params(params);
+
+  std::vector<math::vec3f> blob_centers;
+  std::vector<size_t>      blob_of;
+  std::vector<math::vec3f> offsets;
+
+  for (size_t blob=0; blob<CHECK_BLOBS; blob++)
+  {
+    blob_centers.push_back(math::vec3f(float(blob) * CHECK_SPACING, 0.0f, 0.0f));
+
+    for (size_t k=0; k<PARTICLES_PER_DROPLET; k++)
+    {
+      blob_of.push_back(blob);
+      offsets.push_back(math::vec3f(local(rng), local(rng), local(rng)));
+    }
+  }
+
+  const size_t particles_count = blob_of.size();
+
+  std::vector<uint32_t> labels(particles_count, DropletTracker::NONE);
+  std::vector<uint32_t> expected;  // droplet id per blob
+  size_t                created = 0, splits = 0, merges = 0, removals = 0, label_mismatches = 0;
+  bool                  events_ok = true;
+
+  for (size_t f=0; f<CHECK_FRAMES; f++)
+  {
+    if (f == CHECK_SPLIT_FRAME)
+    {
+      blob_centers.push_back(blob_centers[CHECK_SPLIT] + math::vec3f(0.0f, 0.0f, CLUSTER_RADIUS * 3.0f));
+
+      for (size_t i=0, half=0; i<particles_count; i++)
+        if (blob_of[i] == CHECK_SPLIT && half++ % 2)
+          blob_of[i] = blob_centers.size() - 1;
+    }
+
+    math::vec3f& merging = blob_centers[CHECK_MERGE];
+    float        target  = blob_centers[CHECK_MERGE + 1].x - CHECK_MERGE_GAP;
+
+    if (f >= CHECK_MERGE_FRAME)
+      merging.x = std::min(merging.x + CHECK_MERGE_SPEED, target);
+
+    tracker.begin();
+
+    for (size_t i=0; i<particles_count; i++)
+    {
+      math::vec3f position = blob_centers[blob_of[i]] + offsets[i] + math::vec3f(wobble(rng), wobble(rng), wobble(rng));
+
+      labels[i] = tracker.track(position, labels[i]);
+    }
+
+    tracker.end();
+
+    for (size_t i=0; i<particles_count; i++)
+      labels[i] = tracker.resolve(labels[i]);
+
+    if (f == 0)
+      for (size_t blob=0; blob<CHECK_BLOBS; blob++)
+        expected.push_back(labels[blob * PARTICLES_PER_DROPLET]); // created in blob order
+
+      //the events this frame may have: the blobs' droplets on the first, then one split and one merge
+
+    for (const DropletEvent& event : tracker.events())
+    {
+      switch (event.type)
+      {
+        case DropletEventType::created:
+          created++;
+          events_ok = events_ok && f == 0;
+          break;
+        case DropletEventType::split:
+          splits++;
+          events_ok = events_ok && f == CHECK_SPLIT_FRAME && event.other == expected[CHECK_SPLIT];
+          expected.push_back(event.droplet);
+          break;
+        case DropletEventType::merged:
+          merges++;
+          events_ok = events_ok && f > CHECK_MERGE_FRAME && event.droplet == expected[CHECK_MERGE + 1] && event.other == expected[CHECK_MERGE];
+          expected[CHECK_MERGE + 1] = event.other;
+          break;
+        case DropletEventType::removed:
+          removals++;
+          break;
+      }
+    }
+
+      //every particle in its blob's droplet (expected ids stay put: a slot never changes while it lives)
+
+    for (size_t i=0; i<particles_count; i++)
+      label_mismatches += blob_of[i] >= expected.size() || labels[i] != expected[blob_of[i]];
+  }
+
+  bool ok = events_ok && created == CHECK_BLOBS && splits == 1 && merges == 1 && removals == 0 && label_mismatches == 0
+         && tracker.droplets_count() == CHECK_BLOBS && tracker.slots_count() == CHECK_BLOBS + 1;
+
+  printf("scripted: %zu created, %zu split, %zu merged, %zu removed; %zu label mismatches; %zu droplets in %zu slots%s\n",
+    created, splits, merges, removals, label_mismatches, tracker.droplets_count(), tracker.slots_count(), ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+void run(size_t particles_count, size_t frames)
+{
+    //re-clustering (every particle, every pass, every frame)
+
+  Scene                    reclustered_scene(particles_count, 1234u);
+  DropletClusterer         clusterer;
+  std::vector<math::vec3f> centers;
+  std::vector<size_t>      clusters(particles_count, 0);
+  size_t                   recluster_changes = 0;
+  double                   recluster_ms = 0.0;
+
+  for (size_t f=0; f<frames; f++)
+  {
+    reclustered_scene.step(f);
+
+    double t0     = now_ms();
+    float  radius = CLUSTER_RADIUS;
+
+    for (size_t pass=0; pass<PASSES_COUNT; pass++, radius *= PASS_FACTOR)
+    {
+      clusterer.reset(radius);
+
+      for (const math::vec3f& center : centers)
+        clusterer.add_cluster(center);
+
+      for (size_t i=0; i<particles_count; i++)
+      {
+        size_t cluster = clusterer.assign(reclustered_scene.positions[i]);
+
+        if (pass == PASSES_COUNT - 1)
+        {
+          recluster_changes += f && cluster != clusters[i];
+          clusters[i]        = cluster;
+        }
+      }
+
+      centers.resize(clusterer.clusters_count());
+
+      for (size_t i=0; i<centers.size(); i++)
+        centers[i] = clusterer.center(i);
+    }
+
+    recluster_ms += now_ms() - t0;
+  }
+
+    //tracking
+
+  Scene                 tracked_scene(particles_count, 1234u);
+  DropletTracker        tracker;
+  DropletTrackerParams  params;
+  std::vector<uint32_t> labels(particles_count, DropletTracker::NONE), previous;
+  size_t                track_changes = 0, reassigned = 0, events = 0;
+  double                track_ms = 0.0;
+
+  params.radius = CLUSTER_RADIUS;
+
+  tracker.set_params(params);
+
+  for (size_t f=0; f<frames; f++)
+  {
+    tracked_scene.step(f);
+
+    previous = labels;
+
+    double t0 = now_ms();
+
+    tracker.begin();
+
+    for (size_t i=0; i<particles_count; i++)
+      labels[i] = tracker.track(tracked_scene.positions[i], labels[i]);
+
+    tracker.end();
+
+    for (size_t i=0; i<particles_count; i++)
+      labels[i] = tracker.resolve(labels[i]);
+
+    track_ms += now_ms() - t0;
+
+      //a merged droplet's old label forwards to the survivor: only particles that really moved count
+
+    if (f)
+    {
+      for (size_t i=0; i<particles_count; i++)
+        track_changes += labels[i] != tracker.resolve(previous[i]);
+
+      reassigned += tracker.reassigned_count();
+    }
+
+    events += tracker.events().size();
+  }
+
+  double steps = double(frames > 1 ? frames - 1 : 1);
+
+  printf("%6zu particles: recluster %8.3f ms/frame, track %7.3f ms/frame (x%.1f); reassigned %.1f/frame; "
+         "droplet changes/frame: recluster %.1f, track %.1f; droplets %zu/%zu, %zu events\n",
+    particles_count, recluster_ms / frames, track_ms / frames, recluster_ms / (track_ms > 0.0 ? track_ms : 1e-9),
+    reassigned / steps, recluster_changes / steps, track_changes / steps, centers.size(), tracker.droplets_count(), events);
+}
+
+}
+
+int main()
+{
+  bool ok = check_scripted();
+
+  run(600, 600);
+  run(5000, 120);
+  run(50000, 12);
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+// Headless stand-ins for the platform layer World touches, so world_bench runs World::update without a
+// window, a GL context or audio: application::Window, low_level::Device / Texture / UniformBuffer (textures
+// keep their size and filters, buffers their size, uploads are dropped, image files are not read),
+// scene::SceneRenderer (device + shared material / texture / property lists, no passes) and
+// SoundPlayer::play_sound. Linked instead of src/application, the GL parts of src/render and
+// src/launcher/sound_player.cpp; Material, MaterialList and TextureList are the real ones.
+
+#include <cstring>    // before the engine headers, which rely on it arriving transitively
+#include <functional>
+
+#include "../src/launcher/shared.h"
+
+#include <application/window.h>
+
+using namespace engine;
+using namespace engine::application;
+using namespace engine::render::low_level;
+using namespace engine::render::scene;
+
+///
+/// Window
+///
+
+struct Window::Impl
+{
+  unsigned int width, height;
+};
+
+Window::Window(const char*, unsigned int width, unsigned int height)
+  : impl(std::make_shared<Impl>())
+{
+  impl->width  = width;
+  impl->height = height;
+}
+
+int Window::width() const
+{
+  return int(impl->width);
+}
+
+int Window::height() const
+{
+  return int(impl->height);
+}
+
+///
+/// Texture
+///
+
+struct Texture::Impl
+{
+  size_t        width, height, layers, mips_count, depth;
+  PixelFormat   format;
+  TextureFilter min_filter = TextureFilter_Linear;
+  TextureFilter mag_filter = TextureFilter_Linear;
+};
+
+Texture::Texture(const DeviceContextPtr&, size_t width, size_t height, size_t layers, PixelFormat format, size_t mips_count, size_t depth)
+  : impl(std::make_shared<Impl>())
+{
+  impl->width      = width;
+  impl->height     = height;
+  impl->layers     = layers;
+  impl->format     = format;
+  impl->mips_count = mips_count;
+  impl->depth      = depth;
+}
+
+size_t Texture::width() const
+{
+  return impl->width;
+}
+
+size_t Texture::height() const
+{
+  return impl->height;
+}
+
+size_t Texture::layers() const
+{
+  return impl->layers;
+}
+
+size_t Texture::depth() const
+{
+  return impl->depth;
+}
+
+size_t Texture::mips_count() const
+{
+  return impl->mips_count;
+}
+
+PixelFormat Texture::format() const
+{
+  return impl->format;
+}
+
+TextureFilter Texture::min_filter() const
+{
+  return impl->min_filter;
+}
+
+void Texture::set_min_filter(TextureFilter filter)
+{
+  impl->min_filter = filter;
+}
+
+TextureFilter Texture::mag_filter() const
+{
+  return impl->mag_filter;
+}
+
+void Texture::set_mag_filter(TextureFilter filter)
+{
+  impl->mag_filter = filter;
+}
+
+void Texture::set_data(size_t, size_t, size_t, size_t, size_t, const void*)
+{
+}
+
+void Texture::set_data(size_t, size_t, size_t, size_t, size_t, size_t, const void*)
+{
+}
+
+///
+/// UniformBuffer
+///
+
+struct engine::render::low_level::BufferImpl
+{
+  size_t count;
+};
+
+UniformBuffer::UniformBuffer(const DeviceContextPtr&, size_t size)
+  : impl(std::make_shared<BufferImpl>())
+{
+  impl->count = size;
+}
+
+size_t UniformBuffer::size() const
+{
+  return impl->count;
+}
+
+void UniformBuffer::set_data(size_t, size_t, const void*)
+{
+}
+
+///
+/// Device
+///
+
+struct Device::Impl
+{
+  Window window;
+
+  Impl(const Window& window) : window(window) {}
+};
+
+Device::Device(const Window& window, const DeviceOptions&)
+  : impl(new Impl(window))
+{
+}
+
+Window& Device::window() const
+{
+  return impl->window;
+}
+
+Texture Device::create_texture2d(size_t width, size_t height, PixelFormat format, size_t mips_count)
+{
+  return Texture(DeviceContextPtr(), width, height, 1, format, mips_count);
+}
+
+Texture Device::create_texture_cubemap(size_t width, size_t height, PixelFormat format, size_t mips_count)
+{
+  return Texture(DeviceContextPtr(), width, height, 6, format, mips_count);
+}
+
+Texture Device::create_texture3d(size_t width, size_t height, size_t depth, PixelFormat format)
+{
+  return Texture(DeviceContextPtr(), width, height, 1, format, 1, depth);
+}
+
+UniformBuffer Device::create_uniform_buffer(size_t size)
+{
+  return UniformBuffer(DeviceContextPtr(), size);
+}
+
+Texture Device::create_texture2d(const char*, size_t mips_count)
+{
+  return create_texture2d(1, 1, PixelFormat_RGBA8, mips_count);
+}
+
+Texture Device::create_texture_cubemap(const char*, size_t mips_count)
+{
+  return create_texture_cubemap(1, 1, PixelFormat_RGBA8, mips_count);
+}
+
+///
+/// Scene renderer
+///
+
+struct SceneRenderer::Impl
+{
+  Device                device;
+  common::PropertyMap   properties;
+  TextureList           textures;
+  MaterialList          materials;
+
+  Impl(const Window& window, const DeviceOptions& options) : device(window, options) {}
+};
+
+SceneRenderer::SceneRenderer(const Window& window, const DeviceOptions& options)
+  : impl(std::make_shared<Impl>(window, options))
+{
+}
+
+Device& SceneRenderer::device() const
+{
+  return impl->device;
+}
+
+common::PropertyMap& SceneRenderer::properties() const
+{
+  return impl->properties;
+}
+
+TextureList& SceneRenderer::textures() const
+{
+  return impl->textures;
+}
+
+MaterialList& SceneRenderer::materials() const
+{
+  return impl->materials;
+}
+
+///
+/// Sound
+///
+
+void SoundPlayer::play_sound(SoundId, float)
+{
+}
@@ -0,0 +1,212 @@
+// CPU microbenchmark: the job system (src/common/job_system.cpp). A parallel_for over a per-item kernel
+// about as heavy as a droplet's raymarch sampling, against the plain loop, for 0 (inline), 1, 3 and the
+// default number of workers; then the overhead of running a small task graph shaped like World::update's
+// (three independent chains joined at the end) with empty tasks. Each also checks that every item and
+// task ran exactly once per call and that no task started before the tasks it depends on had finished
+// (tasks stamp a shared clock and run a nested parallel_for); exits non-zero on a mismatch.
+//
+//   make bench && tmp/bench/job_system_bench
+
+#include <common/job_system.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace engine::common;
+
+namespace
+{
+
+const size_t ITEMS       = 4096;
+const size_t ITEM_WORK   = 256;  // inner iterations per item
+const size_t GRAIN       = 16;
+const size_t REPEATS     = 50;
+const size_t GRAPH_RUNS  = 20000;
+const size_t CHECK_RUNS  = 2000; // checked graph runs
+const size_t NESTED_ITEMS = 64;  // items of each checked task's nested parallel_for
+
+// World::update's graph shape: three independent chains joined at the end
+const char* const GRAPH_TASKS[] = {"water", "meshes", "leaves", "tracking", "raymarch", "cohesion", "join"};
+const size_t      GRAPH_EDGES[][2] = { // {task, on}
+  {4, 3}, {5, 3},                      // raymarch, cohesion after tracking
+  {6, 0}, {6, 1}, {6, 2}, {6, 4}, {6, 5},
+};
+const size_t      GRAPH_TASKS_COUNT = sizeof(GRAPH_TASKS) / sizeof(GRAPH_TASKS[0]);
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+float kernel(size_t item)
+{
+  float x = float(item) * 0.001f, sum = 0.0f;
+
+  for (size_t k=0; k<ITEM_WORK; k++)
+  {
+    x    = std::sin(x) * 0.5f + float(k) * 1e-4f;
+    sum += std::sqrt(x * x + 1.0f);
+  }
+
+  return sum;
+}
+
+double checksum(const std::vector<float>& out)
+{
+  double sum = 0.0;
+
+  for (float value : out)
+    sum += value;
+
+  return sum;
+}
+
+bool run_parallel_for(size_t workers, double serial_ms, double serial_sum)
+{
+  JobSystem          jobs(workers);
+  std::vector<float> out(ITEMS);
+
+  jobs.parallel_for(0, ITEMS, GRAIN, [&](size_t i) { out[i] = kernel(i); }); // warm-up: threads started
+
+  double t0 = now_ms();
+
+  for (size_t r=0; r<REPEATS; r++)
+    jobs.parallel_for(0, ITEMS, GRAIN, [&](size_t i) { out[i] = kernel(i); });
+
+  double ms = (now_ms() - t0) / REPEATS;
+
+    //every item exactly once, from the finest chunks to the timed grain
+
+  std::vector<std::atomic<size_t>> hits(ITEMS);
+  size_t                           miscounted = 0;
+
+  for (size_t grain : {size_t(1), GRAIN})
+  {
+    for (std::atomic<size_t>& hit : hits)
+      hit = 0;
+
+    jobs.parallel_for(0, ITEMS, grain, [&](size_t i) { hits[i]++; });
+
+    for (std::atomic<size_t>& hit : hits)
+      miscounted += hit != 1;
+  }
+
+  bool ok = checksum(out) == serial_sum && miscounted == 0;
+
+  printf("parallel_for %zu workers: %8.3f ms (x%.2f)%s\n", jobs.workers_count(), ms, serial_ms / ms, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+// the graph of GRAPH_TASKS / GRAPH_EDGES, task i running task(i)
+template <class Fn> void build_graph(TaskGraph& graph, Fn task)
+{
+  std::vector<TaskGraph::TaskId> ids;
+
+  for (size_t i=0; i<GRAPH_TASKS_COUNT; i++)
+    ids.push_back(graph.add(GRAPH_TASKS[i], [task, i] { task(i); }));
+
+  for (const size_t* edge : GRAPH_EDGES)
+    graph.depend(ids[edge[0]], ids[edge[1]]);
+}
+
+bool run_graph(size_t workers)
+{
+  JobSystem          jobs(workers);
+  TaskGraph          graph;
+  std::atomic<size_t> ran {0};
+
+  build_graph(graph, [&ran](size_t) { ran.fetch_add(1, std::memory_order_relaxed); });
+
+  double t0 = now_ms();
+
+  for (size_t r=0; r<GRAPH_RUNS; r++)
+    graph.run(jobs);
+
+  double us = (now_ms() - t0) * 1000.0 / GRAPH_RUNS;
+  bool   ok = ran.load() == GRAPH_RUNS * graph.tasks_count();
+
+  printf("task graph (%zu tasks) %zu workers: %6.2f us/run%s\n", graph.tasks_count(), jobs.workers_count(), us, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+// Every task ran once per run, only after the tasks it depends on had finished (start / finish stamps
+// of a shared clock), and every item of its nested parallel_for ran once
+bool check_graph(size_t workers)
+{
+  JobSystem                        jobs(workers);
+  TaskGraph                        graph;
+  std::atomic<size_t>              clock {0};
+  std::vector<std::atomic<size_t>> runs(GRAPH_TASKS_COUNT), started(GRAPH_TASKS_COUNT), finished(GRAPH_TASKS_COUNT);
+  std::vector<std::atomic<size_t>> item_runs(GRAPH_TASKS_COUNT * NESTED_ITEMS);
+
+  build_graph(graph, [&](size_t task) {
+    started[task] = ++clock;
+
+    jobs.parallel_for(0, NESTED_ITEMS, 1, [&item_runs, task](size_t i) { item_runs[task * NESTED_ITEMS + i]++; });
+
+    runs[task]++;
+    finished[task] = ++clock;
+  });
+
+  size_t miscounted = 0, out_of_order = 0;
+
+  for (size_t r=0; r<CHECK_RUNS; r++)
+  {
+    graph.run(jobs);
+
+    for (std::atomic<size_t>& count : runs)
+      miscounted += count != r + 1;
+
+    for (const size_t* edge : GRAPH_EDGES)
+      out_of_order += finished[edge[1]] >= started[edge[0]];
+  }
+
+  for (std::atomic<size_t>& count : item_runs)
+    miscounted += count != CHECK_RUNS;
+
+  bool ok = miscounted == 0 && out_of_order == 0;
+
+  printf("task graph check %zu workers: %zu runs, %zu miscounted, %zu out of order%s\n", jobs.workers_count(), CHECK_RUNS,
+    miscounted, out_of_order, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+}
+
+int main()
+{
+  std::vector<float> out(ITEMS);
+
+  double t0 = now_ms();
+
+  for (size_t r=0; r<REPEATS; r++)
+    for (size_t i=0; i<ITEMS; i++)
+      out[i] = kernel(i);
+
+  double serial_ms  = (now_ms() - t0) / REPEATS;
+  double serial_sum = checksum(out);
+
+  printf("serial loop:           %8.3f ms\n", serial_ms);
+
+  const size_t workers[] = {0, 1, 3, JobSystem::default_workers_count()};
+  bool         ok = true;
+
+  for (size_t count : workers)
+    ok = run_parallel_for(count, serial_ms, serial_sum) && ok;
+
+  for (size_t count : workers)
+    ok = run_graph(count) && ok;
+
+  for (size_t count : workers)
+    ok = check_graph(count) && ok;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,584 @@
+// Headless WebGL2 check of media/shaders, in Chrome's SwiftShader (CPU) rasterizer: every shader of the
+// web pipeline must compile and link as the engine splits it (#shader vertex / pixel, WebGL2 takes the
+// sources as they are), and droplet_fluid.glsl must render the same droplet from the baked distance
+// bricks as from the analytic particle field. The cluster and its bricks come from droplet_brick_bench
+// (the real splatter). Then two overlapping droplets behind a leaf, raymarched at 1/2 .. 1/4 of the
+// view's resolution and upsampled by droplet_composite.glsl, must match the full-resolution render.
+// Images are compared by silhouette (droplet pixels in one image only) and by the colour difference where
+// both have a droplet. Exits non-zero on a compile error or a mismatch.
+//
+//   make shader_check    (node + puppeteer: npm i -g puppeteer)
+//   node bench/shader_check.js tmp/bench/droplet_brick.json [dir: writes the divisor images there as .ppm]
+
+'use strict';
+
+const fs        = require('fs');
+const path      = require('path');
+const puppeteer = require('puppeteer');
+
+const SHADERS_DIR = path.join(__dirname, '..', 'media', 'shaders');
+const IMAGE_SIZE  = 256;
+
+// the programs of the passes main.cpp adds (forward lighting, its shadow maps); the deferred, light
+// pre-pass and projectile shaders are desktop GL only
+const WEB_SHADERS = ['droplet_composite.glsl', 'droplet_fluid.glsl', 'firefly.glsl', 'flower.glsl', 'forward_lighting.glsl',
+                     'fresnel.glsl', 'leaf.glsl', 'shadow.glsl', 'sky.glsl', 'water.glsl'];
+
+// brick resolution / divisor -> largest share of the droplet pixels covered in one image only, and
+// largest mean colour difference (0..255) where both are; about 1.5x the measured values (a coarse
+// brick's normals are visibly flatter, so the bounds only guard against regressions). Resolving the
+// overlap to the far droplet fails on colour, skipping the depth test against the leaf on silhouette
+const BOUNDS = {
+  brick: {
+    8:  {silhouette: 0.200, color: 26.0},
+    16: {silhouette: 0.060, color: 12.0},
+    24: {silhouette: 0.025, color: 6.5},
+    32: {silhouette: 0.017, color: 4.5},
+  },
+  divisor: {
+    2: {silhouette: 0.037, color: 4.5},
+    3: {silhouette: 0.041, color: 7.0},
+    4: {silhouette: 0.050, color: 10.0},
+  },
+};
+
+// Runs in the page: compiles the shaders, renders the droplets, returns the results
+function run_checks(input)
+{
+  const canvas = document.createElement('canvas');
+
+  canvas.width  = input.size;
+  canvas.height = input.size;
+
+  const gl = canvas.getContext('webgl2', {antialias: false});
+
+  if (!gl)
+    return {error: 'no WebGL2'};
+
+  gl.getExtension('EXT_color_buffer_float');
+
+    //shaders, split at the #shader tags like Device::create_program_from_source
+
+  function split_sources(text)
+  {
+    const sources = {};
+    const parts   = text.split(/^#shader[ \t]+/m);
+
+    for (const part of parts.slice(1))
+    {
+      const newline = part.indexOf('\n');
+
+      sources[part.slice(0, newline).trim()] = part.slice(newline + 1).replace(/^[\n ]+/, '');
+    }
+
+    return sources;
+  }
+
+  function create_program(text)
+  {
+    const sources = split_sources(text);
+    const program = gl.createProgram();
+    let   log     = '';
+
+    for (const [type, gl_type] of [['vertex', gl.VERTEX_SHADER], ['pixel', gl.FRAGMENT_SHADER]])
+    {
+      const shader = gl.createShader(gl_type);
+
+      gl.shaderSource(shader, sources[type] || '');
+      gl.compileShader(shader);
+
+      if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS))
+        log += type + ': ' + gl.getShaderInfoLog(shader);
+
+      gl.attachShader(program, shader);
+    }
+
+    if (!log)
+    {
+      gl.linkProgram(program);
+
+      if (!gl.getProgramParameter(program, gl.LINK_STATUS))
+        log = 'link: ' + gl.getProgramInfoLog(program);
+    }
+
+    return {program: log ? null : program, log: log};
+  }
+
+  const compiled = {};
+  const results  = {shaders: [], images: []};
+
+  const variants = {};
+
+  for (const [name, text] of Object.entries(input.shaders))
+    variants[name] = text;
+
+  // droplet_fluid.glsl's reduced-resolution variant: the define after each #version line
+  variants['droplet_fluid.glsl ' + input.offscreen_define] =
+    input.shaders['droplet_fluid.glsl'].replace(/^(#version[^\n]*\n)/gm, '$1#define ' + input.offscreen_define + '\n');
+
+  for (const [name, text] of Object.entries(variants))
+  {
+    const entry = create_program(text);
+
+    compiled[name] = entry.program;
+    results.shaders.push({name: name, log: entry.log});
+  }
+
+  const fluid = compiled['droplet_fluid.glsl'];
+
+  if (!fluid)
+    return results;
+
+    //matrices: rows, uploaded transposed as the engine does; the projection is compute_perspective_proj_tm's
+
+  function multiply(a, b)
+  {
+    const m = new Array(16).fill(0);
+
+    for (let i=0; i<4; i++)
+      for (let j=0; j<4; j++)
+        for (let k=0; k<4; k++)
+          m[i * 4 + j] += a[i * 4 + k] * b[k * 4 + j];
+
+    return m;
+  }
+
+  function perspective(fov_y, aspect, z_near, z_far)
+  {
+    const height = 2 * Math.tan(fov_y / 2) * z_near, width = height * aspect, depth = z_far - z_near;
+
+    return [-2 * z_near / width, 0, 0, 0,
+            0, 2 * z_near / height, 0, 0,
+            0, 0, (z_far + z_near) / depth, -2 * z_near * z_far / depth,
+            0, 0, 1, 0];
+  }
+
+  function look_at(eye, target)
+  {
+    const sub       = (a, b) => [a[0] - b[0], a[1] - b[1], a[2] - b[2]];
+    const cross     = (a, b) => [a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]];
+    const dot       = (a, b) => a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    const normalize = (a) => { const l = Math.sqrt(dot(a, a)); return [a[0] / l, a[1] / l, a[2] / l]; };
+    const forward   = normalize(sub(target, eye));
+    const right     = normalize(cross([0, 1, 0], forward));
+    const up        = cross(forward, right);
+
+    return [...right, -dot(right, eye), ...up, -dot(up, eye), ...forward, -dot(forward, eye), 0, 0, 0, 1];
+  }
+
+  function box_tm(center, half)
+  {
+    return [half, 0, 0, center[0], 0, half, 0, center[1], 0, 0, half, center[2], 0, 0, 0, 1];
+  }
+
+    //proxy box: create_box(2, 2, 2), the unit cube [-1, 1]
+
+  const box_vertices = [];
+  const corners      = (i) => [i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1];
+
+  for (const face of [[0, 2, 6, 4], [1, 5, 7, 3], [0, 4, 5, 1], [2, 3, 7, 6], [0, 1, 3, 2], [4, 6, 7, 5]])
+    for (const i of [0, 1, 2, 0, 2, 3])
+      box_vertices.push(...corners(face[i]));
+
+  const box = gl.createVertexArray();
+
+  gl.bindVertexArray(box);
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer());
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(box_vertices), gl.STATIC_DRAW);
+
+  function bind_position(program)
+  {
+    const location = gl.getAttribLocation(program, 'vPosition');
+
+    gl.bindVertexArray(box);
+    gl.enableVertexAttribArray(location);
+    gl.vertexAttribPointer(location, 3, gl.FLOAT, false, 0, 0);
+  }
+
+    //textures: a checker behind the droplet (refraction) and a cubemap with a colour per face (reflection)
+
+  const checker = new Uint8Array(64 * 64 * 4);
+
+  for (let y=0; y<64; y++)
+    for (let x=0; x<64; x++)
+    {
+      const on = ((x >> 3) ^ (y >> 3)) & 1;
+
+      checker.set(on ? [40, 150, 60, 255] : [200, 220, 120, 255], (y * 64 + x) * 4);
+    }
+
+  const refraction = gl.createTexture();
+
+  gl.bindTexture(gl.TEXTURE_2D, refraction);
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA8, 64, 64, 0, gl.RGBA, gl.UNSIGNED_BYTE, checker);
+  gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.LINEAR);
+
+  const environment = gl.createTexture();
+  const face_colors = [[255, 200, 160], [120, 160, 255], [230, 240, 255], [60, 90, 40], [180, 210, 250], [200, 190, 150]];
+
+  gl.bindTexture(gl.TEXTURE_CUBE_MAP, environment);
+
+  face_colors.forEach((color, face) =>
+    gl.texImage2D(gl.TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, gl.RGBA8, 1, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array([...color, 255])));
+
+  gl.texParameteri(gl.TEXTURE_CUBE_MAP, gl.TEXTURE_MIN_FILTER, gl.LINEAR);
+
+  function create_brick(resolution, distances)
+  {
+    const texture = gl.createTexture();
+
+    gl.bindTexture(gl.TEXTURE_3D, texture);
+    gl.texImage3D(gl.TEXTURE_3D, 0, gl.R16F, resolution, resolution, resolution, 0, gl.RED, gl.FLOAT, new Float32Array(distances));
+
+    for (const [name, value] of [['TEXTURE_MIN_FILTER', 'LINEAR'], ['TEXTURE_MAG_FILTER', 'LINEAR'], ['TEXTURE_WRAP_S', 'CLAMP_TO_EDGE'],
+                                 ['TEXTURE_WRAP_T', 'CLAMP_TO_EDGE'], ['TEXTURE_WRAP_R', 'CLAMP_TO_EDGE']])
+      gl.texParameteri(gl.TEXTURE_3D, gl[name], gl[value]);
+
+    return texture;
+  }
+
+  const empty_brick = create_brick(1, [1]);
+
+    //targets: the view (RGBA8 + depth) and the reduced-resolution droplet target (ScaledRenderTarget:
+    //RGBA8 + D24 textures, point-sampled)
+
+  function create_target(size, depth_texture)
+  {
+    const frame_buffer = gl.createFramebuffer();
+    const color        = gl.createTexture();
+    const depth        = depth_texture ? gl.createTexture() : gl.createRenderbuffer();
+
+    gl.bindFramebuffer(gl.FRAMEBUFFER, frame_buffer);
+    gl.bindTexture(gl.TEXTURE_2D, color);
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA8, size, size, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+    gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, color, 0);
+
+    if (depth_texture)
+    {
+      gl.bindTexture(gl.TEXTURE_2D, depth);
+      gl.texImage2D(gl.TEXTURE_2D, 0, gl.DEPTH_COMPONENT24, size, size, 0, gl.DEPTH_COMPONENT, gl.UNSIGNED_INT, null);
+      gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.DEPTH_ATTACHMENT, gl.TEXTURE_2D, depth, 0);
+    }
+    else
+    {
+      gl.bindRenderbuffer(gl.RENDERBUFFER, depth);
+      gl.renderbufferStorage(gl.RENDERBUFFER, gl.DEPTH_COMPONENT24, size, size);
+      gl.framebufferRenderbuffer(gl.FRAMEBUFFER, gl.DEPTH_ATTACHMENT, gl.RENDERBUFFER, depth);
+    }
+
+    for (const texture of depth_texture ? [color, depth] : [color])
+    {
+      gl.bindTexture(gl.TEXTURE_2D, texture);
+      gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+      gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
+    }
+
+    return {frame_buffer: frame_buffer, color: color, depth: depth, size: size};
+  }
+
+  function begin(target)
+  {
+    gl.bindFramebuffer(gl.FRAMEBUFFER, target.frame_buffer);
+    gl.viewport(0, 0, target.size, target.size);
+    gl.depthMask(true);
+    gl.clearColor(0, 0, 0, 0);
+    gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
+    gl.enable(gl.DEPTH_TEST);
+    gl.depthFunc(gl.LESS);
+  }
+
+  function read(target)
+  {
+    const pixels = new Uint8Array(target.size * target.size * 4);
+
+    gl.bindFramebuffer(gl.FRAMEBUFFER, target.frame_buffer);
+    gl.readPixels(0, 0, target.size, target.size, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+
+    return pixels;
+  }
+
+  const view_target = create_target(input.size, false);
+
+    //view and light: one white point light; the unused slots get no range (and no division by zero)
+
+  const droplet = input.droplet;
+  const eye     = [droplet.center[0] + 0.25, droplet.center[1] + 0.35, droplet.center[2] - 0.7];
+  const view    = look_at(eye, droplet.center);
+  const proj    = perspective(Math.PI / 3, 1, 0.05, 50);
+  const lights  = {positions: new Float32Array(32 * 3), colors: new Float32Array(32 * 3), attenuations: new Float32Array(32 * 3), ranges: new Float32Array(32)};
+
+  for (let i=0; i<32; i++)
+    lights.attenuations[i * 3] = 1;
+
+  lights.positions.set([droplet.center[0] + 0.6, droplet.center[1] + 1.0, droplet.center[2] - 0.4]);
+  lights.colors.set([1, 1, 1]);
+  lights.ranges[0] = 1;
+
+  function setup_fluid(program)
+  {
+    const uniform = (name) => gl.getUniformLocation(program, name);
+
+    gl.useProgram(program);
+    gl.uniformBlockBinding(program, gl.getUniformBlockIndex(program, 'DropletBlock'), 0);
+    gl.uniformMatrix4fv(uniform('viewMatrix'), true, view);
+    gl.uniformMatrix4fv(uniform('viewProjectionMatrix'), true, multiply(proj, view));
+    gl.uniform3fv(uniform('worldViewPosition'), eye);
+    gl.uniform1i(uniform('environmentMap'), 0);
+    gl.uniform1i(uniform('refractionTexture'), 1);
+    gl.uniform1i(uniform('distanceBrick'), 2);
+    gl.uniform3fv(uniform('pointLightPositions'), lights.positions);
+    gl.uniform3fv(uniform('pointLightColors'), lights.colors);
+    gl.uniform3fv(uniform('pointLightAttenuations'), lights.attenuations);
+    gl.uniform1fv(uniform('pointLightRanges'), lights.ranges);
+    gl.uniform3fv(uniform('spotLightAttenuations'), new Float32Array([1, 0, 0, 1, 0, 0]));
+    gl.uniform3fv(uniform('spotLightDirections'), new Float32Array([0, -1, 0, 0, -1, 0]));
+
+    bind_position(program);
+  }
+
+    //a droplet: its DropletBlock (std140, DropletUniforms in world.cpp), brick and reflection cubemap
+
+  function create_droplet(offset, brick_resolution, environment_map)
+  {
+    const block  = new ArrayBuffer(48 + 16 * 64);
+    const floats = new Float32Array(block);
+    const ints   = new Int32Array(block);
+    const center = droplet.center.map((value, axis) => value + offset[axis]);
+    const buffer = gl.createBuffer();
+
+    floats.set(center, 0);
+    floats[3] = droplet.halfExtent;
+    floats[4] = droplet.influence;
+    floats[5] = droplet.iso;
+    ints[6]   = droplet.particles.length / 4;
+    ints[7]   = brick_resolution;
+    ints[8]   = 0;  // lodLevel: full
+    ints[9]   = 64; // stepBudget: DROPLET_LOD_FULL_STEPS
+    floats.set(droplet.particles.map((value, i) => i % 4 == 3 ? value : value + offset[i % 4]), 12);
+
+    gl.bindBuffer(gl.UNIFORM_BUFFER, buffer);
+    gl.bufferData(gl.UNIFORM_BUFFER, block, gl.STATIC_DRAW);
+
+    return {block: buffer, model: box_tm(center, droplet.halfExtent), environment: environment_map,
+            brick: brick_resolution ? create_brick(brick_resolution, droplet.bricks[brick_resolution]) : empty_brick};
+  }
+
+  function draw_droplet(program, item)
+  {
+    gl.bindBufferBase(gl.UNIFORM_BUFFER, 0, item.block);
+    gl.uniformMatrix4fv(gl.getUniformLocation(program, 'MVP'), true, multiply(proj, multiply(view, item.model)));
+    gl.uniformMatrix4fv(gl.getUniformLocation(program, 'modelMatrix'), true, item.model);
+
+    gl.activeTexture(gl.TEXTURE0);
+    gl.bindTexture(gl.TEXTURE_CUBE_MAP, item.environment);
+    gl.activeTexture(gl.TEXTURE1);
+    gl.bindTexture(gl.TEXTURE_2D, refraction);
+    gl.activeTexture(gl.TEXTURE2);
+    gl.bindTexture(gl.TEXTURE_3D, item.brick);
+
+    gl.drawArrays(gl.TRIANGLES, 0, 36);
+  }
+
+    //the analytic field is the reference; alpha 255 marks the droplets (the leaf below writes 128)
+
+  function compare(a, b)
+  {
+    let covered = 0, differing = 0, shared = 0, color = 0;
+
+    for (let i=0; i<a.length; i+=4)
+    {
+      const in_a = a[i + 3] == 255, in_b = b[i + 3] == 255;
+
+      covered   += in_a || in_b ? 1 : 0;
+      differing += in_a != in_b ? 1 : 0;
+
+      if (in_a && in_b)
+      {
+        shared++;
+        color += (Math.abs(a[i] - b[i]) + Math.abs(a[i + 1] - b[i + 1]) + Math.abs(a[i + 2] - b[i + 2])) / 3;
+      }
+    }
+
+    return {covered: covered, silhouette: covered ? differing / covered : 1, color: shared ? color / shared : 255};
+  }
+
+    //bricks: one droplet, in the view
+
+  function render_single(brick_resolution)
+  {
+    setup_fluid(fluid);
+    begin(view_target);
+    draw_droplet(fluid, create_droplet([0, 0, 0], brick_resolution, environment));
+
+    return read(view_target);
+  }
+
+  const analytic = render_single(0);
+
+  for (const resolution of Object.keys(droplet.bricks).map(Number))
+    results.images.push({name: 'brick ' + resolution + '^3 vs analytic', kind: 'brick', key: resolution, ...compare(analytic, render_single(resolution))});
+
+    //reduced resolution: two droplets overlapping on screen, the nearer one reflecting another cubemap,
+    //and a leaf in front of both. droplet_fluid.glsl's offscreen variant (as create_program_variant in
+    //forward_render_passes.cpp) goes to the reduced target, droplet_composite.glsl upsamples it
+
+  const offscreen = compiled['droplet_fluid.glsl ' + input.offscreen_define];
+  const composite = compiled['droplet_composite.glsl'];
+
+  if (!offscreen || !composite)
+    return results;
+
+  const red_environment = gl.createTexture();
+
+  gl.bindTexture(gl.TEXTURE_CUBE_MAP, red_environment);
+
+  for (let face=0; face<6; face++)
+    gl.texImage2D(gl.TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, gl.RGBA8, 1, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array([255, 40, 40, 255]));
+
+  gl.texParameteri(gl.TEXTURE_CUBE_MAP, gl.TEXTURE_MIN_FILTER, gl.LINEAR);
+
+  const droplets = [create_droplet([0, 0, 0], 0, environment), create_droplet([0.12, 0.05, -0.22], 0, red_environment)];
+  const leaf     = [0.25, 0, 0, droplet.center[0] - 0.07, 0, 0.3, 0, droplet.center[1], 0, 0, 0.002, droplet.center[2] - 0.55, 0, 0, 0, 1];
+  const scene    = create_program('#shader vertex\n#version 300 es\nuniform mat4 MVP;\nin vec3 vPosition;\n' +
+                                  'void main() { gl_Position = MVP * vec4(vPosition, 1.0); }\n' +
+                                  '#shader pixel\n#version 300 es\nprecision highp float;\nout vec4 fragColor;\n' +
+                                  'void main() { fragColor = vec4(0.2, 0.45, 0.15, 128.0 / 255.0); }\n').program;
+
+  function render_scene()
+  {
+    begin(view_target);
+    gl.useProgram(scene);
+    gl.uniformMatrix4fv(gl.getUniformLocation(scene, 'MVP'), true, multiply(proj, multiply(view, leaf)));
+    bind_position(scene);
+    gl.drawArrays(gl.TRIANGLES, 0, 36);
+  }
+
+  render_scene();
+  setup_fluid(fluid);
+
+  for (const item of droplets)
+    draw_droplet(fluid, item);
+
+  const full = read(view_target);
+
+  const plane = gl.createVertexArray();
+
+  gl.bindVertexArray(plane);
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer());
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 0, -1, 1, 0, 1, 1, 0, -1, -1, 0, 1, 1, 0, 1, -1, 0]), gl.STATIC_DRAW);
+
+  const plane_position = gl.getAttribLocation(composite, 'vPosition');
+
+  gl.enableVertexAttribArray(plane_position);
+  gl.vertexAttribPointer(plane_position, 3, gl.FLOAT, false, 0, 0);
+
+  for (const divisor of input.divisors)
+  {
+    const target = create_target(Math.ceil(input.size / divisor), true);
+
+    begin(target);
+    setup_fluid(offscreen);
+
+    for (const item of droplets)
+      draw_droplet(offscreen, item);
+
+    render_scene();
+
+    gl.useProgram(composite);
+    gl.uniformMatrix4fv(gl.getUniformLocation(composite, 'projectionMatrix'), true, proj);
+    gl.uniform1i(gl.getUniformLocation(composite, 'dropletTarget'), 0);
+    gl.uniform1i(gl.getUniformLocation(composite, 'dropletDepth'), 1);
+    gl.activeTexture(gl.TEXTURE0);
+    gl.bindTexture(gl.TEXTURE_2D, target.color);
+    gl.activeTexture(gl.TEXTURE1);
+    gl.bindTexture(gl.TEXTURE_2D, target.depth);
+    gl.bindVertexArray(plane);
+    gl.drawArrays(gl.TRIANGLES, 0, 6);
+
+    const pixels = read(view_target);
+
+    results.images.push({name: 'divisor ' + divisor + ' vs full resolution', kind: 'divisor', key: divisor, ...compare(full, pixels)});
+
+    if (input.keep_images)
+      results.pictures = Object.assign(results.pictures || {full: Array.from(full)}, {['divisor' + divisor]: Array.from(pixels)});
+  }
+
+  results.renderer = gl.getParameter(gl.RENDERER);
+
+  return results;
+}
+
+async function main()
+{
+  const fixture_file = process.argv[2];
+
+  if (!fixture_file)
+  {
+    console.error('usage: node bench/shader_check.js <droplet_brick_bench fixture.json>');
+    return 1;
+  }
+
+  const shaders = {};
+
+  for (const name of WEB_SHADERS)
+    shaders[name] = fs.readFileSync(path.join(SHADERS_DIR, name), 'utf8');
+
+  const images_dir = process.argv[3];
+  const input      = {size: IMAGE_SIZE, shaders: shaders, droplet: JSON.parse(fs.readFileSync(fixture_file, 'utf8')),
+                      offscreen_define: 'DROPLET_OFFSCREEN_TARGET', divisors: Object.keys(BOUNDS.divisor).map(Number), keep_images: !!images_dir};
+  const browser = await puppeteer.launch({headless: 'shell', args: ['--no-sandbox', '--use-angle=swiftshader', '--enable-unsafe-swiftshader', '--ignore-gpu-blocklist']});
+  let   results;
+
+  try
+  {
+    const page = await browser.newPage();
+
+    results = await page.evaluate(run_checks, input);
+  }
+  finally
+  {
+    await browser.close();
+  }
+
+  if (results.error)
+  {
+    console.error(results.error);
+    return 1;
+  }
+
+  let ok = true;
+
+  console.log('renderer: ' + results.renderer);
+
+  for (const shader of results.shaders)
+  {
+    console.log((shader.name + ' ').padEnd(44) + (shader.log ? 'FAILED\n' + shader.log.trim() : 'compiled'));
+    ok = ok && !shader.log;
+  }
+
+  for (const image of results.images)
+  {
+    const bound = BOUNDS[image.kind][image.key];
+    const match = image.covered > 0 && image.silhouette <= bound.silhouette && image.color <= bound.color;
+
+    console.log(`${image.name}: ${image.covered} pixels, silhouette ${(image.silhouette * 100).toFixed(2)}%, colour ${image.color.toFixed(2)}${match ? '' : '  MISMATCH'}`);
+    ok = ok && match;
+  }
+
+  for (const [name, pixels] of Object.entries(images_dir && results.pictures || {}))
+  {
+    const rows = [];
+
+    for (let y=IMAGE_SIZE-1; y>=0; y--) // GL rows are bottom-up
+      for (let x=0; x<IMAGE_SIZE; x++)
+        rows.push(...pixels.slice((y * IMAGE_SIZE + x) * 4, (y * IMAGE_SIZE + x) * 4 + 3));
+
+    fs.writeFileSync(path.join(images_dir, name + '.ppm'), Buffer.concat([Buffer.from(`P6 ${IMAGE_SIZE} ${IMAGE_SIZE} 255\n`), Buffer.from(rows)]));
+  }
+
+  console.log(ok ? 'OK' : 'MISMATCH');
+
+  return ok ? 0 : 1;
+}
+
+main().then((code) => process.exit(code), (error) => { console.error(error); process.exit(1); });
@@ -0,0 +1,180 @@
+// CPU check + microbenchmark of the water clipmap mesh (src/launcher/water_clipmap.cpp).
+// Builds the scene's layout and verifies it: every interior edge is shared by exactly two triangles
+// (no cracks or T-junctions between levels), only the outer square is open, all triangles face up and
+// tile the square exactly, and each vertex's cell matches the level level_at() selects for it. Then
+// moves the viewer and checks that snapping keeps every vertex on its level's world lattice. Reports
+// vertices vs the uniform grid and the cell size under the tree for the scene's camera positions.
+//
+//   make bench && tmp/bench/water_clipmap_bench
+
+#include "../src/launcher/water_clipmap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const size_t UNIFORM_GRID_SIZE = 160;     // WATER_SURFACE_GRID_SIZE
+const float  UNIFORM_CELL      = 3.125f;  // 2 * WATER_SURFACE_SIZE / WATER_SURFACE_GRID_SIZE
+
+const float CAMERA_X[] = {31.0f, 35.0f, 40.0f};  // CAM_POS_AR_1_1 / 9_16 / 16_9 (main.cpp)
+const float CAMERA_Z   = -1.0f;
+
+WaterClipmapParams make_params()
+{
+  WaterClipmapParams params; // WATER_CLIPMAP_* defaults
+
+  return params;
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool check_topology(const WaterClipmap& clipmap)
+{
+  const std::vector<WaterClipmapVertex>& v = clipmap.vertices();
+  const std::vector<uint16_t>&           ind = clipmap.indices();
+
+  std::map<std::pair<uint16_t, uint16_t>, int> edges;
+
+  double area = 0.0;
+  size_t flipped = 0;
+
+  for (size_t t=0; t<ind.size(); t+=3)
+  {
+    const WaterClipmapVertex &a = v[ind[t]], &b = v[ind[t + 1]], &c = v[ind[t + 2]];
+
+    double up = double(b.z - a.z) * double(c.x - a.x) - double(b.x - a.x) * double(c.z - a.z);
+
+    if (up <= 0.0)
+      flipped++;
+
+    area += 0.5 * up;
+
+    for (size_t k=0; k<3; k++)
+    {
+      uint16_t i0 = ind[t + k], i1 = ind[t + (k + 1) % 3];
+
+      edges[std::make_pair(std::min(i0, i1), std::max(i0, i1))]++;
+    }
+  }
+
+  const float H = clipmap.half_extent();
+
+  size_t open = 0, open_inside = 0, overused = 0;
+
+  for (const auto& edge : edges)
+  {
+    if (edge.second > 2)
+      overused++;
+
+    if (edge.second != 1)
+      continue;
+
+    open++;
+
+    const WaterClipmapVertex &a = v[edge.first.first], &b = v[edge.first.second];
+
+    bool on_border = (a.x == b.x && std::fabs(a.x) == H) || (a.z == b.z && std::fabs(a.z) == H);
+
+    if (!on_border)
+      open_inside++;
+  }
+
+  size_t mismatched_cells = 0;
+
+  for (const WaterClipmapVertex& vertex : v)
+    if (vertex.cell != clipmap.cell_size(clipmap.level_at(vertex.x, vertex.z)))
+      mismatched_cells++;
+
+  double expected_area = 4.0 * double(H) * double(H);
+
+  printf("  triangles %zu, edges %zu: open %zu (outer border %zu), cracks %zu, overused %zu, flipped %zu\n",
+    ind.size() / 3, edges.size(), open, clipmap.ring_cells() * 8, open_inside, overused, flipped);
+  printf("  area %.1f of %.1f, vertices with a wrong level %zu\n", area, expected_area, mismatched_cells);
+
+  return open_inside == 0 && overused == 0 && flipped == 0 && open == clipmap.ring_cells() * 8
+      && std::fabs(area - expected_area) < 1e-6 * expected_area && mismatched_cells == 0;
+}
+
+bool check_snapping(WaterClipmap& clipmap)
+{
+    //walk the viewer along a diagonal; every level's vertices must stay on their world lattice
+
+  size_t moves = 0, off_lattice = 0;
+
+  for (int s=0; s<2000; s++)
+  {
+    float x = -60.0f + 0.071f * float(s), z = 30.0f - 0.037f * float(s);
+
+    if (!clipmap.set_viewer(x, z))
+      continue;
+
+    moves++;
+
+    for (const WaterClipmapVertex& v : clipmap.vertices())
+    {
+      double wx = double(clipmap.center_x()) + v.x, wz = double(clipmap.center_z()) + v.z;
+      double rx = std::remainder(wx, double(v.cell)), rz = std::remainder(wz, double(v.cell));
+
+      if (std::fabs(rx) > 1e-3 || std::fabs(rz) > 1e-3)
+        off_lattice++;
+    }
+  }
+
+  printf("  viewer walk: %zu recentres over 2000 steps, vertices off their lattice %zu\n", moves, off_lattice);
+
+  return off_lattice == 0 && moves > 0;
+}
+
+}
+
+int main()
+{
+  WaterClipmapParams params = make_params();
+
+  double t0 = now_ms();
+
+  WaterClipmap clipmap(params);
+
+  double build_ms = now_ms() - t0;
+
+  size_t uniform_vertices = UNIFORM_GRID_SIZE * UNIFORM_GRID_SIZE;
+
+  printf("clipmap: %zu levels x %zu ring cells, cells %.2f..%.2f, half extent %.0f\n",
+    clipmap.levels_count(), clipmap.ring_cells(), clipmap.cell_size(0), clipmap.cell_size(clipmap.levels_count() - 1),
+    clipmap.half_extent());
+  printf("  vertices %zu vs uniform %zu^2 grid %zu (x%.2f), built in %.3f ms\n",
+    clipmap.vertices().size(), UNIFORM_GRID_SIZE, uniform_vertices,
+    double(clipmap.vertices().size()) / double(uniform_vertices), build_ms);
+
+  bool ok = check_topology(clipmap);
+
+  for (float camera_x : CAMERA_X)
+  {
+    clipmap.set_viewer(camera_x, CAMERA_Z);
+
+    size_t level = clipmap.level_at(0.0f, 0.0f);
+
+    printf("  camera at (%.0f, %.0f): centre (%.0f, %.0f), tree in level %zu, cell %.2f (uniform grid %.3f)\n",
+      camera_x, CAMERA_Z, clipmap.center_x(), clipmap.center_z(), level, clipmap.cell_size(level), UNIFORM_CELL);
+
+    ok = ok && level == 0;
+  }
+
+  ok = check_snapping(clipmap) && ok;
+
+  printf("%s\n", ok ? "OK" : "FAILED");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// CPU microbenchmark: WaterGrid::step (separable swell + simd::float4 wave kernel, src/launcher/water_grid.cpp)
+// vs the per-cell scalar loop WaterSurface::update used before (10 sinf per cell). Reports the cost of
+// one water update at several grid sizes and the largest height/normal difference between the two; exits
+// non-zero when either exceeds its bound.
+//
+//   make bench && tmp/bench/water_grid_bench && tmp/bench/water_grid_bench_scalar
+
+#include "../src/launcher/water_grid.h"
+#include "../src/launcher/simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float HALF_EXTENT = 250.0f;  // WATER_SURFACE_SIZE
+const float TIME_STEP   = 0.016f;  // WATER_SWELL_TIME_STEP
+
+const float MAX_HEIGHT_ERROR = 1.0e-5f;  // same swell, factored -> float rounding only
+const float MAX_NORMAL_ERROR = 1.0e-4f;
+
+WaterParams make_params()
+{
+  WaterParams params;
+
+  params.min_height = -(1.0f - 0.15f); // -(WATER_DEPTH - 0.15)
+
+  return params;
+}
+
+// the pre-SIMD WaterSurface::update, with fixed-size arrays replaced by size x size vectors
+struct ReferenceWater
+{
+  size_t N;
+  WaterParams params;
+  std::vector<float> A, B, height, nx, nz;
+  float* p;
+  float* n;
+
+  ReferenceWater(size_t size, const WaterParams& params)
+    : N(size), params(params), A(size * size, 0.0f), B(size * size, 0.0f)
+    , height(size * size, 0.0f), nx(size * size, 0.0f), nz(size * size, 0.0f), p(&A[0]), n(&B[0]) {}
+
+  void step(float t)
+  {
+    const float CELL = 2.0f * HALF_EXTENT / float(N);
+    const float VIS  = params.viscosity;
+
+    for (size_t i=1; i<N-1; i++)
+      for (size_t j=1; j<N-1; j++)
+      {
+        float wx = HALF_EXTENT * (1.0f - 2.0f * i / float(N)), wz = HALF_EXTENT * (1.0f - 2.0f * j / float(N));
+        float S   = params.swell.height(wx, wz, t);
+        float Sim = params.swell.height(wx + CELL, wz, t);
+        float Sip = params.swell.height(wx - CELL, wz, t);
+        float Sjm = params.swell.height(wx, wz + CELL, t);
+        float Sjp = params.swell.height(wx, wz - CELL, t);
+
+        float h = n[i*N+j] * params.height_scale + S;
+        height[i*N+j] = h < params.min_height ? params.min_height : h;
+        nx[i*N+j] = (n[(i-1)*N+j] - n[(i+1)*N+j]) * params.normal_steepness + (Sim - Sip) * params.swell_steepness;
+        nz[i*N+j] = (n[i*N+j-1] - n[i*N+j+1]) * params.normal_steepness + (Sjm - Sjp) * params.swell_steepness;
+
+        float laplas = (n[(i-1)*N+j] + n[(i+1)*N+j] + n[i*N+j+1] + n[i*N+j-1]) * 0.25f - n[i*N+j];
+
+        p[i*N+j] = (2.0f - VIS) * n[i*N+j] - p[i*N+j] * (1.0f - VIS) + laplas * params.wave_speed;
+      }
+
+    std::swap(p, n);
+  }
+};
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool run(size_t size, size_t steps)
+{
+  WaterParams    params = make_params();
+  ReferenceWater reference(size, params);
+  WaterGrid      grid(size, HALF_EXTENT, params);
+
+    //identical scripted splashes in both
+
+  std::mt19937 rng(99u);
+  std::uniform_int_distribution<size_t> cell(1, size - 2);
+
+  for (size_t k=0; k<32; k++)
+  {
+    size_t i = cell(rng), j = cell(rng);
+
+    reference.n[i * size + j] -= 0.015f;
+    grid.ripples()[i * size + j] -= 0.015f;
+  }
+
+  float t = 0.0f;
+  double t0 = now_ms();
+
+  for (size_t s=0; s<steps; s++)
+    reference.step(t += TIME_STEP);
+
+  double reference_ms = (now_ms() - t0) / steps;
+
+  t  = 0.0f;
+  t0 = now_ms();
+
+  for (size_t s=0; s<steps; s++)
+    grid.step(t += TIME_STEP);
+
+  double grid_ms = (now_ms() - t0) / steps;
+
+  float max_height_error = 0.0f, max_normal_error = 0.0f;
+
+  for (size_t k=0; k<size*size; k++)
+  {
+    max_height_error = std::max(max_height_error, std::fabs(grid.heights()[k] - reference.height[k]));
+    max_normal_error = std::max(max_normal_error, std::fabs(grid.normals_x()[k] - reference.nx[k]));
+    max_normal_error = std::max(max_normal_error, std::fabs(grid.normals_z()[k] - reference.nz[k]));
+  }
+
+  bool ok = max_height_error <= MAX_HEIGHT_ERROR && max_normal_error <= MAX_NORMAL_ERROR;
+
+  printf("%4zu x %-4zu: per-cell sinf %8.3f ms/update, %s %7.3f ms/update (x%.1f), max |dh| %.1e, max |dn| %.1e%s\n",
+    size, size, reference_ms, simd::backend_name(), grid_ms, reference_ms / (grid_ms > 0.0 ? grid_ms : 1e-9),
+    max_height_error, max_normal_error, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+}
+
+int main()
+{
+  bool ok = true;
+
+  ok = run(160, 200) && ok;
+  ok = run(256, 100) && ok;
+  ok = run(512, 25) && ok;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// CPU check + microbenchmark of the water GPU-displacement split (src/launcher/water_ripple_upload.cpp).
+// Runs the scene's water workload (ambient ripples + droplet splashes) twice: the CPU vertex path
+// (WaterGrid::step, dense) and the texture path (sparse WaterGrid::integrate + tiled WaterRippleUpload::pack
+// into a mirror of the ripple texture). The surface is rebuilt from the mirror with water.glsl's arithmetic at the
+// texel centres (where its bilinear taps reduce to single texels and a slope spacing of one cell matches the grid)
+// and compared to the CPU heights/normals. Reports bytes sent per frame for both paths and the pack cost.
+//
+//   make bench && tmp/bench/water_ripple_upload_bench
+
+#include "../src/launcher/water_grid.h"
+#include "../src/launcher/water_ripple_upload.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const size_t GRID_SIZE        = 160;      // WATER_SURFACE_GRID_SIZE
+const float  HALF_EXTENT      = 250.0f;   // WATER_SURFACE_SIZE
+const float  TIME_STEP        = 0.016f;   // WATER_SWELL_TIME_STEP
+const float  EPSILON          = 1.0e-5f;  // WATER_RIPPLE_UPLOAD_EPSILON
+const float  AMBIENT_CHANCE   = 0.05f;    // WATER_AMBIENT_SPLASH_CHANCE
+const float  AMBIENT_STRENGTH = 0.004f;   // WATER_AMBIENT_SPLASH_STRENGTH
+const float  DROPLET_DIP      = 0.015f;   // WATER_SPLASH_MAX_DIP
+const size_t VERTEX_BYTES     = 48;       // sizeof(media::geometry::Vertex)
+
+WaterParams make_params()
+{
+  WaterParams params;
+
+  params.min_height = -(1.0f - 0.15f);
+  params.idle_epsilon = 1.0e-12f; // (near) exact sparse simulation: this checks the upload; water_tiles_bench checks the tiling
+
+  return params;
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// water.glsl vertex stage on the CPU: height and normal of interior vertex (i, j) from the texture mirror
+void reconstruct(const WaterGrid& grid, const WaterParams& params, const std::vector<float>& texture, float t,
+                 size_t i, size_t j, float& height, float& nx, float& nz)
+{
+  const size_t N    = grid.size();
+  const float  cell = grid.cell_size();
+  const float  x    = grid.coord(i), z = grid.coord(j);
+
+  auto U = [&](size_t r, size_t c) { return texture[r * N + c]; };
+
+  height = std::max(U(i, j) * params.height_scale + params.swell.height(x, z, t), params.min_height);
+  nx     = (U(i - 1, j) - U(i + 1, j)) * params.normal_steepness
+         + (params.swell.height(x + cell, z, t) - params.swell.height(x - cell, z, t)) * params.swell_steepness;
+  nz     = (U(i, j - 1) - U(i, j + 1)) * params.normal_steepness
+         + (params.swell.height(x, z + cell, t) - params.swell.height(x, z - cell, t)) * params.swell_steepness;
+}
+
+void splash(WaterGrid& grid, size_t i, size_t j, float strength)
+{
+  float& u = grid.ripples()[i * grid.size() + j];
+
+  u = std::max(u - strength, -DROPLET_DIP);
+
+  grid.disturb(i, j);
+}
+
+}
+
+int main()
+{
+  const size_t FRAMES = 2000;
+  const size_t N      = GRID_SIZE;
+
+  WaterParams       params = make_params();
+  WaterGrid         cpu_grid(N, HALF_EXTENT, params), gpu_grid(N, HALF_EXTENT, params);
+  WaterRippleUpload upload(N, EPSILON);
+  std::vector<float> texture(N * N, 0.0f); // what the GPU would hold
+
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+  std::uniform_int_distribution<size_t> cell(1, N - 2);
+
+  float  t = 0.0f, max_height_error = 0.0f, max_normal_error = 0.0f;
+  double pack_ms = 0.0;
+  size_t idle_frames = 0;
+
+  for (size_t frame=0; frame<FRAMES; frame++)
+  {
+      //ambient ripple most frames, a droplet landing every ~2 seconds
+
+    if (chance(rng) < AMBIENT_CHANCE)
+    {
+      size_t i = cell(rng), j = cell(rng);
+
+      splash(cpu_grid, i, j, AMBIENT_STRENGTH);
+      splash(gpu_grid, i, j, AMBIENT_STRENGTH);
+    }
+
+    if (frame % 120 == 60)
+    {
+      size_t i = cell(rng), j = cell(rng);
+
+      for (size_t di=0; di<3; di++)
+        for (size_t dj=0; dj<3; dj++)
+        {
+          splash(cpu_grid, std::min(i + di, N - 2), std::min(j + dj, N - 2), DROPLET_DIP);
+          splash(gpu_grid, std::min(i + di, N - 2), std::min(j + dj, N - 2), DROPLET_DIP);
+        }
+    }
+
+      //step() derives the surface from U before advancing it, so pack the same U the CPU path displays
+
+    t += TIME_STEP;
+
+    double t0 = now_ms();
+    bool   changed = upload.pack(gpu_grid.ripples(), gpu_grid.tile_size(), gpu_grid.changed_tiles());
+
+    gpu_grid.clear_changed_tiles();
+
+    pack_ms += now_ms() - t0;
+
+    cpu_grid.step(t);
+    gpu_grid.integrate();
+
+    for (size_t r=0; r<upload.rects_count(); r++)
+    {
+      const TexelRect& rect = upload.rect(r);
+
+      for (size_t row=0; row<rect.height; row++)
+        std::memcpy(&texture[(rect.y + row) * N + rect.x], upload.texels(r) + row * rect.width, rect.width * sizeof(float));
+    }
+
+    if (!changed)
+      idle_frames++;
+
+      //the shader's surface vs the CPU vertex path
+
+    if (frame % 50 != 49)
+      continue;
+
+    for (size_t i=1; i<N-1; i++)
+      for (size_t j=1; j<N-1; j++)
+      {
+        float h, nx, nz;
+
+        reconstruct(gpu_grid, params, texture, t, i, j, h, nx, nz);
+
+        max_height_error = std::max(max_height_error, std::fabs(h - cpu_grid.heights()[i * N + j]));
+        max_normal_error = std::max(max_normal_error, std::fabs(nx - cpu_grid.normals_x()[i * N + j]));
+        max_normal_error = std::max(max_normal_error, std::fabs(nz - cpu_grid.normals_z()[i * N + j]));
+      }
+  }
+
+  double vertex_bytes  = double(N * N * VERTEX_BYTES);
+  double texture_bytes = double(upload.texels_uploaded() * sizeof(float)) / FRAMES;
+
+  printf("%zu x %zu, %zu frames\n", N, N, FRAMES);
+  printf("  vertex path : %9.0f bytes/frame (whole vertex buffer)\n", vertex_bytes);
+  printf("  texture path: %9.0f bytes/frame average (%zu uploads, %zu idle frames), x%.0f less\n",
+    texture_bytes, upload.uploads_count(), idle_frames, vertex_bytes / (texture_bytes > 0.0 ? texture_bytes : 1.0));
+  printf("  pack        : %9.4f ms/frame\n", pack_ms / FRAMES);
+  printf("  max |dh| %.1e (epsilon x height scale = %.1e), max |dn| %.1e\n",
+    max_height_error, EPSILON * params.height_scale, max_normal_error);
+
+  bool ok = max_height_error < 1.0e-4f && max_normal_error < 1.0e-3f;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// Headless benchmark of the sparse active-tile ripple simulation (WaterGrid::integrate,
+// src/launcher/water_grid.cpp) vs a dense integration of every interior cell. Drives both with the same
+// scripted splash pattern and reports active tiles (average / peak), per-substep time and the largest
+// ripple difference to the dense field, for several grid sizes. Grids below WaterParams::sparse_min_size
+// take WaterGrid's dense path and must match exactly; sparse grids drop sub-epsilon ripples, and the bench
+// exits non-zero when max |dU| exceeds MAX_ERROR_PER_EPSILON x idle_epsilon.
+//
+//   make bench && tmp/bench/water_tiles_bench
+
+#include "../src/launcher/water_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace engine::launcher;
+
+namespace
+{
+
+const float  HALF_EXTENT      = 250.0f;   // WATER_SURFACE_SIZE
+const float  AMBIENT_CHANCE   = 0.05f;    // WATER_AMBIENT_SPLASH_CHANCE
+const float  AMBIENT_STRENGTH = 0.004f;   // WATER_AMBIENT_SPLASH_STRENGTH
+const float  DROPLET_DIP      = 0.015f;   // WATER_SPLASH_MAX_DIP
+const size_t SUBSTEPS         = 3000;
+
+const float  MAX_ERROR_PER_EPSILON = 50.0f; // sparse drift bound: 5e-4 (a 30th of the dip) at the default epsilon
+
+enum Pattern
+{
+  Pattern_Calm,      // only the faint ambient ripples
+  Pattern_Droplets,  // ambient + a droplet landing near the centre every ~2 seconds
+  Pattern_Storm,     // ambient + several droplets every substep all over the plane
+};
+
+const char* pattern_name(Pattern pattern)
+{
+  switch (pattern)
+  {
+    case Pattern_Calm:     return "calm";
+    case Pattern_Droplets: return "droplets";
+    case Pattern_Storm:    return "storm";
+    default:               return "?";
+  }
+}
+
+// the dense pre-tiling integration of every interior cell
+struct DenseRipples
+{
+  size_t N;
+  WaterParams params;
+  std::vector<float> a, b;
+  float* current;
+  float* previous;
+
+  DenseRipples(size_t size, const WaterParams& params)
+    : N(size), params(params), a(size * size, 0.0f), b(size * size, 0.0f), current(&a[0]), previous(&b[0]) {}
+
+  void integrate()
+  {
+    const float VIS = params.viscosity;
+
+    for (size_t i=1; i<N-1; i++)
+      for (size_t j=1; j<N-1; j++)
+      {
+        const float* u = current + i * N;
+        float laplacian = (u[j - N] + u[j + N] + u[j + 1] + u[j - 1]) * 0.25f - u[j];
+
+        previous[i * N + j] = (2.0f - VIS) * u[j] - previous[i * N + j] * (1.0f - VIS) + laplacian * params.wave_speed;
+      }
+
+    std::swap(current, previous);
+  }
+};
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool run(size_t size, Pattern pattern, float idle_epsilon)
+{
+  WaterParams params;
+
+  params.idle_epsilon = idle_epsilon;
+
+  WaterGrid    grid(size, HALF_EXTENT, params);
+  DenseRipples dense(size, params);
+
+  std::mt19937 rng(11u);
+  std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+  std::uniform_int_distribution<size_t> anywhere(1, size - 2), centre(size * 3 / 8, size * 5 / 8);
+
+  auto splash = [&](size_t i, size_t j, float strength)
+  {
+    float& u = grid.ripples()[i * size + j];
+    float& d = dense.current[i * size + j];
+
+    u = std::max(u - strength, -DROPLET_DIP);
+    d = std::max(d - strength, -DROPLET_DIP);
+
+    grid.disturb(i, j);
+  };
+
+  double sparse_ms = 0.0, dense_ms = 0.0;
+  size_t active_sum = 0, active_peak = 0;
+  float  max_error = 0.0f;
+
+  for (size_t s=0; s<SUBSTEPS; s++)
+  {
+    if (chance(rng) < AMBIENT_CHANCE)
+      splash(anywhere(rng), anywhere(rng), AMBIENT_STRENGTH);
+
+    if (pattern == Pattern_Droplets && s % 120 == 60)
+      splash(centre(rng), centre(rng), DROPLET_DIP);
+
+    if (pattern == Pattern_Storm)
+      for (size_t k=0; k<4; k++)
+        splash(anywhere(rng), anywhere(rng), DROPLET_DIP);
+
+    double t0 = now_ms();
+
+    grid.integrate();
+
+    double t1 = now_ms();
+
+    dense.integrate();
+
+    double t2 = now_ms();
+
+    sparse_ms += t1 - t0;
+    dense_ms  += t2 - t1;
+
+    size_t active = grid.active_tiles_count();
+
+    active_sum  += active;
+    active_peak  = std::max(active_peak, active);
+
+    grid.clear_changed_tiles();
+
+    if (s % 100 == 99)
+      for (size_t k=0; k<size*size; k++)
+        max_error = std::max(max_error, std::fabs(grid.ripples()[k] - dense.current[k]));
+  }
+
+  size_t tiles = grid.tiles_per_row() * grid.tiles_per_row();
+
+  float max_allowed = grid.is_sparse() ? MAX_ERROR_PER_EPSILON * idle_epsilon : 0.0f;
+  bool  ok          = max_error <= max_allowed;
+
+  printf("%4zu^2 %-8s eps %.0e: active tiles avg %6.1f peak %4zu of %4zu, %s %7.4f ms/substep, dense %7.4f ms (x%5.1f), max |dU| %.1e%s\n",
+    size, pattern_name(pattern), idle_epsilon, double(active_sum) / SUBSTEPS, active_peak, tiles,
+    grid.is_sparse() ? "sparse" : "grid  ", sparse_ms / SUBSTEPS, dense_ms / SUBSTEPS, dense_ms / (sparse_ms > 0.0 ? sparse_ms : 1e-9),
+    max_error, ok ? "" : "  MISMATCH");
+
+  return ok;
+}
+
+}
+
+int main()
+{
+  const size_t  sizes[]    = {160, 512, 1024};
+  const Pattern patterns[] = {Pattern_Calm, Pattern_Droplets, Pattern_Storm};
+
+  bool ok = true;
+
+  for (size_t size : sizes)
+    for (Pattern pattern : patterns)
+      ok = run(size, pattern, WaterParams().idle_epsilon) && ok;
+
+    //accuracy / cost of the sleep threshold
+
+  for (float epsilon : {1.0e-5f, 1.0e-6f, 1.0e-7f})
+    ok = run(512, Pattern_Droplets, epsilon) && ok;
+
+  printf("%s\n", ok ? "OK" : "MISMATCH");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+// Headless, deterministic benchmark of World::update (src/launcher/world.cpp): the whole simulation -
+// Bullet, droplets, plants, water - on the real scene, against the stubbed platform layer in
+// headless_render_stub.cpp (no window, GL context or audio). The world's random generator is seeded,
+// every frame advances by the same dt and a scripted pointer grabs and drags a leaf every few seconds,
+// so two runs with the same arguments simulate the same thing. Reports per-phase wall time (avg / p99 /
+// max per frame) after a warm-up, from World::phase_timings (the phases of the update graph overlap on
+// the worker threads; "parallel" is their wall time), and the average share of droplets / leaves
+// settled at rest (World::settle_counters), the droplet/leaf contact events per frame
+// (World::contact_stats), the droplets drawn per level of detail (World::droplet_lod_counters) and the
+// leaf collision shape cache's counters (World::leaf_shape_stats). A wind acceleration of 0 gives the
+// calm scene. Heap allocations per frame are counted by the global operator new below and Bullet's
+// allocator hook (btAlignedAllocSetCustom), so they cover the engine's containers and Bullet's own.
+//
+// physics 0 / 1 steps Bullet on the calling thread / on the update's workers (World::set_physics_threads).
+// It only differs in a build with the multithreaded Bullet world (`make world_bench BULLET_MT=1`, against
+// a Bullet built with BT_THREADSAFE=1). The droplet budget (600 particles) fills after ~150 s of game
+// time, so compare the two at full load over ~12000 frames; the average particle count is printed.
+//
+// Needs Bullet and the native build's GL loader headers (render/low_level/shared.h includes them; no GL
+// call is made), so it is not part of `make bench`:
+//
+// Any argument NAME=VALUE sets a live parameter by its page name (DROPLET.force=2, WIND.stiffness=3000, see
+// LIVE_PARAMETERS in world.cpp) and @FILE applies a file of them, one per line, so a script can sweep them.
+//
+//   make world_bench && tmp/bench/world_bench [frames] [seed] [wind] [physics] [NAME=VALUE | @FILE]...
+//   (from the repo root: World loads media/)
+
+#include <cstring>    // before the engine headers, which rely on it arriving transitively
+#include <functional>
+
+#include "../src/launcher/shared.h"
+
+#include <application/window.h>
+
+#include <common/log.h>
+#include <math/utility.h>
+
+#include "LinearMath/btAlignedAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace engine;
+using namespace engine::application;
+using namespace engine::render::low_level;
+using namespace engine::render::scene;
+using namespace engine::scene;
+
+namespace
+{
+
+const float       FRAME_DT     = 1.0f / 60.0f;
+const size_t      WARMUP       = 120;                        // frames skipped in the report (plant sprouting, first droplet)
+const math::vec3f CAMERA_POSITION(40.f, 4.f, -1.f);          // CAM_POS_AR_16_9 (main.cpp)
+const math::vec3f GRAB_TARGET(0.f, 6.f, 0.f);                // into the plant's crown
+const size_t      GRAB_PERIOD  = 300;                        // frames between grabs
+const size_t      GRAB_FRAMES  = 90;                         // frames a grab is held and dragged
+const float       DRAG_RADIUS  = 1.5f;
+
+struct PhaseSamples
+{
+  const char*                 name;
+  double WorldPhaseTimings::* field;
+  std::vector<double>         samples;
+};
+
+// every heap allocation of the process, from any thread: operator new (new[] and the containers'
+// allocators go through it) and Bullet's btAlignedAlloc (installed in main)
+std::atomic<size_t> heap_allocations(0);
+
+void* counted_malloc(size_t size)
+{
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+  return std::malloc(size ? size : 1);
+}
+
+double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void report(const char* name, std::vector<double>& samples)
+{
+  if (samples.empty())
+    return;
+
+  double sum = 0.0;
+
+  for (double sample : samples)
+    sum += sample;
+
+  std::sort(samples.begin(), samples.end());
+
+  printf("  %-16s avg %8.4f  p99 %8.4f  max %8.4f ms\n", name, sum / samples.size(),
+    samples[std::min(samples.size() - 1, samples.size() * 99 / 100)], samples.back());
+}
+
+// the input main.cpp feeds on a mouse drag: a grab ray from the camera, then drag offsets each frame
+void script_input(World& world, size_t frame)
+{
+  size_t phase = frame % GRAB_PERIOD;
+
+  if (phase == 0)
+  {
+    math::vec3f ray_end = CAMERA_POSITION + (GRAB_TARGET - CAMERA_POSITION) * 2.0f;
+
+    world.inputGrab(CAMERA_POSITION.x, CAMERA_POSITION.y, CAMERA_POSITION.z, ray_end.x, ray_end.y, ray_end.z);
+  }
+
+  if (phase < GRAB_FRAMES)
+  {
+    float angle = float(phase) / float(GRAB_FRAMES) * 6.2831853f;
+
+    world.inputDrag(0.0f, DRAG_RADIUS * std::sin(angle), DRAG_RADIUS * (1.0f - std::cos(angle)));
+  }
+
+  if (phase == GRAB_FRAMES)
+    world.inputRelease();
+}
+
+}
+
+void* operator new(size_t size)
+{
+  if (void* p = counted_malloc(size))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+    //positional arguments, then live tuning assignments / files (World::assign_tuning, load_tuning)
+
+  std::vector<const char*> positional, tuning;
+
+  for (int i=1; i<argc; i++)
+    (strchr(argv[i], '=') || argv[i][0] == '@' ? tuning : positional).push_back(argv[i]);
+
+  size_t       frames  = positional.size() > 0 ? size_t(atol(positional[0])) : 3600;
+  unsigned int seed    = positional.size() > 1 ? unsigned(atol(positional[1])) : 1u;
+  float        wind    = positional.size() > 2 ? float(atof(positional[2])) : -1.0f; // < 0: the world's default
+  int          physics = positional.size() > 3 ? atoi(positional[3]) : -1;           // < 0: the world's default
+
+  World::seed_random(seed);
+  btAlignedAllocSetCustom(counted_malloc, std::free);
+
+    //the scene main.cpp builds, minus lights and helpers World does not read
+
+  Window        window("World bench", 1280, 720);
+  SceneRenderer scene_renderer(window, DeviceOptions());
+
+  Node::Pointer               scene_root = Node::create();
+  PerspectiveCamera::Pointer  camera = PerspectiveCamera::create();
+
+  camera->set_fov_x(math::degree(90.f));
+  camera->set_fov_y(math::degree(90.f * 720.f / 1280.f));
+  camera->set_z_near(1.f);
+  camera->set_z_far(1000.f);
+  camera->set_position(CAMERA_POSITION);
+  camera->set_orientation(math::to_quat(math::anglef(math::degree(4.f)), math::anglef(math::degree(-90.f)), math::anglef(math::degree(0.f))));
+  camera->bind_to_parent(*scene_root);
+
+  Material     mtl1;
+  MaterialList materials = scene_renderer.materials();
+
+  materials.insert("mtl1", mtl1);
+
+  double t0 = now_ms();
+
+  World world(scene_root, scene_renderer, camera);
+
+  if (wind >= 0.0f)
+    world.set_wind_accel(wind);
+
+  if (physics >= 0)
+    world.set_physics_threads(physics != 0);
+
+  for (const char* assignment : tuning)
+  {
+    if (assignment[0] == '@')
+    {
+      world.load_tuning(assignment + 1);
+    }
+    else if (!world.assign_tuning(assignment))
+    {
+      fprintf(stderr, "unknown tuning parameter or bad value: %s\n", assignment);
+      return 1;
+    }
+
+    printf("tuning: %s\n", assignment);
+  }
+
+#ifdef WORLD_BULLET_MT
+  const char* physics_world = physics == 0 ? "multithreaded world, sequential scheduler" : "multithreaded world, job system scheduler";
+#else
+  const char* physics_world = "single-threaded world";
+#endif
+
+  printf("world created in %.1f ms; %zu frames at %.4f s, seed %u; physics: %s\n", now_ms() - t0, frames, FRAME_DT, seed, physics_world);
+
+  PhaseSamples phases[] = {
+    {"step",            &WorldPhaseTimings::step,            {}},
+    {"spawn",           &WorldPhaseTimings::spawn,           {}},
+    {"plants",          &WorldPhaseTimings::plants,          {}},
+    {"clustering",      &WorldPhaseTimings::clustering,      {}},
+    {"raymarch upload", &WorldPhaseTimings::raymarch_upload, {}},
+    {"cohesion",        &WorldPhaseTimings::cohesion,        {}},
+    {"water",           &WorldPhaseTimings::water,           {}},
+    {"parallel",        &WorldPhaseTimings::parallel,        {}},
+    {"other",           &WorldPhaseTimings::other,           {}},
+  };
+
+  std::vector<double> totals;
+  WorldSettleCounters settled;  // sums over the reported frames
+  double              particles = 0.0;
+  WorldContactStats   contacts;     // sums over the reported frames
+  WorldDropletLodCounters lods;     // sums over the reported frames
+  std::vector<double> allocations;  // heap allocations per reported frame
+
+  for (size_t frame=0; frame<frames; frame++)
+  {
+    script_input(world, frame);
+
+    size_t allocations_start = heap_allocations.load();
+    double frame_start = now_ms();
+
+    world.update(FRAME_DT);
+
+    double frame_ms = now_ms() - frame_start;
+    size_t frame_allocations = heap_allocations.load() - allocations_start;
+
+    if (frame < WARMUP)
+      continue;
+
+    const WorldPhaseTimings& timings = world.phase_timings();
+
+    for (PhaseSamples& phase : phases)
+      phase.samples.push_back(timings.*phase.field);
+
+    totals.push_back(frame_ms);
+    allocations.push_back(double(frame_allocations));
+
+    const WorldSettleCounters& counters = world.settle_counters();
+
+    settled.droplets               += counters.droplets;
+    settled.droplets_settled       += counters.droplets_settled;
+    settled.droplet_particles_held += counters.droplet_particles_held;
+    settled.leaves                 += counters.leaves;
+    settled.leaves_settled         += counters.leaves_settled;
+
+    particles += double(world.droplet_particles_count());
+
+    contacts.events  += world.contact_stats().events;
+    contacts.pairs   += world.contact_stats().pairs;
+    contacts.dropped += world.contact_stats().dropped;
+
+    lods.full     += world.droplet_lod_counters().full;
+    lods.reduced  += world.droplet_lod_counters().reduced;
+    lods.impostor += world.droplet_lod_counters().impostor;
+  }
+
+  printf("per frame after %zu warm-up frames:\n", WARMUP);
+
+  for (PhaseSamples& phase : phases)
+    report(phase.name, phase.samples);
+
+  report("update", totals);
+
+  double reported = double(std::max<size_t>(totals.size(), 1));
+
+  printf("droplet particles per frame: %.1f\n", particles / reported);
+
+  if (!allocations.empty())
+  {
+    double sum = 0.0;
+
+    for (double count : allocations)
+      sum += count;
+
+    std::sort(allocations.begin(), allocations.end());
+
+    printf("heap allocations per frame: avg %.1f  p99 %.0f  max %.0f\n", sum / allocations.size(),
+      allocations[std::min(allocations.size() - 1, allocations.size() * 99 / 100)], allocations.back());
+  }
+  printf("contacts per frame: %.1f events, %.1f pairs, %.1f dropped\n",
+    contacts.events / reported, contacts.pairs / reported, contacts.dropped / reported);
+  printf("settled per frame: %.1f/%.1f droplets (%.1f particles held), %.1f/%.1f leaves\n",
+    settled.droplets_settled / reported, settled.droplets / reported, settled.droplet_particles_held / reported,
+    settled.leaves_settled / reported, settled.leaves / reported);
+
+  printf("droplet LOD per frame: %.1f full, %.1f reduced, %.1f impostor\n",
+    lods.full / reported, lods.reduced / reported, lods.impostor / reported);
+
+  const WorldLeafShapeStats& shapes = world.leaf_shape_stats();
+
+  printf("leaf shapes: %zu cached (%zu KB), %zu hits, %zu misses, %zu uncached, %zu evicted\n",
+    shapes.shapes, shapes.bytes / 1024, shapes.hits, shapes.misses, shapes.uncached, shapes.evictions);
+
+  return 0;
+}
@@ -0,0 +1,48 @@
+/// Parallel for
+template <class Fn> void JobSystem::parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn)
+{
+  typedef typename std::remove_reference<Fn>::type Body;
+
+  if (begin >= end)
+    return;
+
+  const size_t count   = end - begin;
+  const size_t workers = workers_count();
+
+  if (grain < 1)
+    grain = 1;
+
+  if (!workers || count <= grain)
+  {
+    for (size_t i=begin; i<end; i++)
+      fn(i);
+
+    return;
+  }
+
+    //a few chunks per thread, so a thread that finishes early steals the rest
+
+  size_t chunks = count / grain;
+
+  if (chunks > (workers + 1) * 4)
+    chunks = (workers + 1) * 4;
+
+  const size_t chunk = (count + chunks - 1) / chunks;
+
+  JobFunction run = [](void* context, size_t first, size_t last) {
+    Body& body = *static_cast<Body*>(context);
+
+    for (size_t i=first; i<last; i++)
+      body(i);
+  };
+
+  void*      context = const_cast<void*>(static_cast<const void*>(&fn));
+  JobCounter counter;
+
+  for (size_t first=begin+chunk; first<end; first+=chunk)
+    submit(run, context, first, first + chunk < end ? first + chunk : end, counter);
+
+  run(context, begin, begin + chunk); // the first chunk on this thread
+
+  wait(counter);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace engine {
+namespace common {
+
+/// Small job system: a fixed pool of worker threads, one work-stealing deque per thread (the owner
+/// pushes and pops at the back, idle threads steal from the front), parallel-for and dependency
+/// counters. A thread waiting on a counter runs queued jobs meanwhile, so jobs may submit and wait
+/// on jobs of their own (nested parallel_for).
+///
+/// Without thread support (an Emscripten build without -pthread) or with 0 workers every job runs
+/// inline in submit(), in submission order. Jobs must not throw.
+
+/// Job: runs the items [begin, end) of a range with its context
+typedef void (*JobFunction)(void* context, size_t begin, size_t end);
+
+/// Jobs of a group still to finish
+class JobCounter
+{
+  public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator = (const JobCounter&) = delete;
+
+    /// Every job counted has finished
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<size_t> pending {0};
+};
+
+/// Worker pool
+class JobSystem
+{
+  public:
+    /// Start workers_count worker threads (0: inline execution)
+    explicit JobSystem(size_t workers_count = default_workers_count());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator = (const JobSystem&) = delete;
+
+    /// Hardware threads besides the calling one, at most MAX_DEFAULT_WORKERS; 0 without thread support
+    static size_t default_workers_count();
+
+    static const size_t MAX_DEFAULT_WORKERS = 7;
+
+    /// Worker threads
+    size_t workers_count() const;
+
+    /// Queue a job counted by counter (runs it right away without workers)
+    void submit(JobFunction fn, void* context, size_t begin, size_t end, JobCounter& counter);
+
+    /// Run queued jobs until every job of the counter has finished
+    void wait(JobCounter& counter);
+
+    /// fn(i) for every i in [begin, end), in chunks of at least grain items; returns when all have run
+    template <class Fn> void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn);
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+/// Tasks with dependencies: a task is queued once every task it depends on has finished. A task may
+/// only depend on tasks added before it, so a graph has no cycles. Build once, run every frame.
+class TaskGraph
+{
+  public:
+    typedef size_t TaskId;
+
+    /// Add a task (name: a literal, the task's profiler zone)
+    TaskId add(const char* name, std::function<void ()> fn);
+
+    /// task starts after on has finished
+    void depend(TaskId task, TaskId on);
+
+    /// Run every task once; returns when all have finished
+    void run(JobSystem& jobs);
+
+    size_t tasks_count() const { return tasks.size(); }
+
+  private:
+    struct Task
+    {
+      const char*            name;
+      std::function<void ()> fn;
+      std::vector<TaskId>    dependents;
+      size_t                 dependencies_count = 0;
+      std::atomic<size_t>    remaining {0};  // unfinished dependencies in the current run
+
+      Task(const char* name, std::function<void ()>&& fn) : name(name), fn(std::move(fn)) {}
+    };
+
+    static void run_task(void* graph, size_t task, size_t);
+
+  private:
+    std::deque<Task> tasks;     // deque: tasks hold atomics and stay in place
+    JobSystem*       jobs = nullptr;
+    JobCounter*      counter = nullptr;
+};
+
+#include <common/detail/job_system.inl>
+
+}}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace engine {
+namespace common {
+namespace profiler {
+
+/// Scoped-zone frame profiler. Zones are recorded into a fixed ring buffer per thread (no locks and no
+/// allocation on the recording path; the owner thread is the only writer), nest by time, and feed
+/// rolling per-zone statistics once per frame (end_frame). The last ring-buffer's worth of zones of
+/// every thread can be exported as Chrome trace JSON (about:tracing, Perfetto).
+///
+/// The engine_profile_* macros below compile to nothing unless ENGINE_PROFILER is defined
+/// (`make PROFILE=1`); the functions are always available but see no zones then.
+
+/// Rolling statistics of one zone over its last samples
+struct ZoneStats
+{
+  const char* name;
+  size_t      calls;   // since the start
+  size_t      samples; // in the rolling window
+  double      min_ms;
+  double      avg_ms;
+  double      p99_ms;
+  double      last_ms;
+};
+
+/// Monotonic timestamp, nanoseconds
+uint64_t timestamp();
+
+/// Record a zone [start, end] on the calling thread at the current nesting depth
+void record_zone(const char* name, uint64_t start, uint64_t end);
+
+/// Name stored for the profiler's lifetime (zones keep name pointers; use for names that are not literals)
+const char* intern(const char* name);
+
+/// Name of the calling thread in traces
+void set_thread_name(const char* name);
+
+/// Record the frame zone since the previous call and fold every thread's new zones into the statistics
+void end_frame();
+
+/// Statistics of every zone seen so far (as of the last end_frame), by name
+std::vector<ZoneStats> stats();
+
+/// Log the statistics (engine_log_info, one line per zone)
+void log_stats();
+
+/// Chrome trace JSON of the zones still in the ring buffers
+std::string chrome_trace();
+
+/// Scoped zone
+class Zone
+{
+  public:
+    Zone(const char* name);
+    ~Zone();
+
+    Zone(const Zone&) = delete;
+    Zone& operator = (const Zone&) = delete;
+
+  private:
+    const char* name;
+    uint64_t    start;
+};
+
+}}}
+
+/// Profiling macroses
+
+#define ENGINE_PROFILER_CONCAT_IMPL(a, b) a##b
+#define ENGINE_PROFILER_CONCAT(a, b) ENGINE_PROFILER_CONCAT_IMPL(a, b)
+
+#ifdef ENGINE_PROFILER
+  #define engine_profile_zone(name) engine::common::profiler::Zone ENGINE_PROFILER_CONCAT(profile_zone_, __LINE__)(name)
+  #define engine_profile_record(name, start, end) engine::common::profiler::record_zone(name, start, end)
+  #define engine_profile_end_frame() engine::common::profiler::end_frame()
+#else
+  #define engine_profile_zone(name)
+  #define engine_profile_record(name, start, end)
+  #define engine_profile_end_frame()
+#endif
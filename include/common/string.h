@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <cstdarg>
+#include <cstring>
 
 namespace engine {
 namespace common {
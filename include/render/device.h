@@ -36,6 +36,7 @@ struct ShaderImpl;
 struct TextureLevelInfo;
 struct RenderBufferInfo;
 struct ProgramParameter;
+struct ProgramUniformBlock;
 
 typedef std::shared_ptr<DeviceContextImpl> DeviceContextPtr;
 
@@ -63,6 +64,9 @@ enum PixelFormat
 {
   PixelFormat_RGBA8,
   PixelFormat_RGB16F,
+  PixelFormat_R16F,
+  PixelFormat_R32F,
+  PixelFormat_RGBA32F,
   PixelFormat_D24,
   PixelFormat_D16,
 };
@@ -120,8 +124,8 @@ struct Viewport
 class Texture
 {
   public:
-    /// Constructor
-    Texture(const DeviceContextPtr& context, size_t width, size_t height, size_t layers, PixelFormat format, size_t mips_count = (size_t)-1);
+    /// Constructor (depth > 1: 3D texture of one layer and one mip level)
+    Texture(const DeviceContextPtr& context, size_t width, size_t height, size_t layers, PixelFormat format, size_t mips_count = (size_t)-1, size_t depth = 1);
 
     /// Texture width
     size_t width() const;
@@ -132,6 +136,9 @@ class Texture
     /// Layers count
     size_t layers() const;
 
+    /// Depth (1 unless a 3D texture)
+    size_t depth() const;
+
     /// Mipmaps count
     size_t mips_count() const;
 
@@ -153,6 +160,9 @@ class Texture
     /// Set texture data
     void set_data(size_t layer, size_t x, size_t y, size_t width, size_t height, const void* data);
 
+    /// Set 3D texture data
+    void set_data(size_t x, size_t y, size_t z, size_t width, size_t height, size_t depth, const void* data);
+
     /// Get texture data
     void get_data(size_t layer, size_t x, size_t y, size_t width, size_t height, void* data);
 
@@ -374,6 +384,26 @@ class IndexBuffer
     std::shared_ptr<BufferImpl> impl;
 };
 
+/// Uniform buffer: the data of a program's uniform block (std140 layout), kept and updated in place
+class UniformBuffer
+{
+  public:
+    /// Constructor
+    UniformBuffer(const DeviceContextPtr& context, size_t size);
+
+    /// Size in bytes
+    size_t size() const;
+
+    /// Load a byte range
+    void set_data(size_t offset, size_t size, const void* data);
+
+    /// Bind buffer to a uniform block binding point
+    void bind(size_t binding) const;
+
+  private:
+    std::shared_ptr<BufferImpl> impl;
+};
+
 /// Shader
 class Shader
 {
@@ -422,6 +452,9 @@ class Program
     /// Parameters
     const ProgramParameter* parameters() const;
 
+    /// Per-primitive uniform block (nullptr if the program has none); bound at its binding point
+    const ProgramUniformBlock* uniform_block() const;
+
     /// Bind
     void bind() const;
 
@@ -661,16 +694,18 @@ class Pass
       const Primitive& primitive,
       const math::mat4f& model_tm = math::mat4f(1.0f),
       const common::PropertyMap& properties = default_primitive_properties(),
-      const TextureList& textures = default_primitive_textures());
+      const TextureList& textures = default_primitive_textures(),
+      const UniformBuffer* uniform_buffer = nullptr);
 
-    /// Add mesh to a pass
+    /// Add mesh to a pass (the uniform buffer is not owned: it must outlive the pass rendering)
     void add_mesh(
       const Mesh& mesh,
       const math::mat4f& model_tm = math::mat4f(1.0f),
       size_t first_primitive=0,
       size_t primitives_count=(size_t)-1,
       const common::PropertyMap& properties = default_primitive_properties(),
-      const TextureList& textures = default_primitive_textures());
+      const TextureList& textures = default_primitive_textures(),
+      const UniformBuffer* uniform_buffer = nullptr);
 
     /// Remove all primitives from the pass
     /// will be automaticall called after the Pass::render
@@ -734,7 +769,8 @@ class PassGroup
       size_t first_primitive=0,
       size_t primitives_count=(size_t)-1,
       const common::PropertyMap& properties = Pass::default_primitive_properties(),
-      const TextureList& textures = Pass::default_primitive_textures());
+      const TextureList& textures = Pass::default_primitive_textures(),
+      const UniformBuffer* uniform_buffer = nullptr);
 
   private:
     struct Impl;
@@ -776,6 +812,9 @@ class Device
     /// Create index buffer
     IndexBuffer create_index_buffer(size_t count);
 
+    /// Create uniform buffer
+    UniformBuffer create_uniform_buffer(size_t size);
+
     /// Create vertex shader
     Shader create_vertex_shader(const char* name, const char* source_code, int lineno_offset=0);
 
@@ -812,6 +851,9 @@ class Device
     /// Create texture cubemap
     Texture create_texture_cubemap(size_t width, size_t height, PixelFormat format, size_t mips_count = 100);
 
+    /// Create 3D texture (no mips)
+    Texture create_texture3d(size_t width, size_t height, size_t depth, PixelFormat format);
+
     /// Load texture2d
     Texture create_texture2d(const char* image_path, size_t mips_count = 100);
 
@@ -0,0 +1,110 @@
+#shader vertex
+#version 300 es
+precision highp float;
+
+// Fullscreen plane (Device::create_plane, [-1, 1] in x and y), drawn once over the view for all droplets.
+
+in vec3 vPosition;
+
+out vec2 screenUV;
+
+void main()
+{
+  gl_Position = vec4(vPosition.xy, 0.0, 1.0);
+  screenUV    = vPosition.xy * 0.5 + 0.5;
+}
+
+#shader pixel
+#version 300 es
+precision highp float;
+
+// Upsamples the droplets raymarched at a fraction of the view resolution (droplet_fluid.glsl with
+// DROPLET_OFFSCREEN_TARGET) into the view. Each low-resolution texel holds the nearest droplet hit and its
+// depth, so overlapping droplets are already resolved there. Of the 4 nearest texels, only those at about
+// the view depth of the one weighing most contribute (depth-aware bilinear), so droplets don't bleed into
+// each other. The blended depth is written per full-resolution pixel and depth-tested against the scene,
+// so edges against leaves stay sharp.
+
+in vec2 screenUV;
+
+out vec4 fragColor;
+
+uniform mat4      projectionMatrix; // view -> clip: linearizes the target's depth
+uniform sampler2D dropletTarget;    // rgb: shaded droplet
+uniform sampler2D dropletDepth;     // hit depth, 1 (the clear value) where no droplet was hit
+
+const float DEPTH_TOLERANCE = 0.02; // view depth (world units) within which texels count as one surface
+const float MIN_COVERAGE    = 0.5;  // bilinear share of covered texels below which the pixel is outside
+
+// window depth -> distance along the view axis (either sign convention of the projection)
+float viewDepth(float depth)
+{
+  float ndc = depth * 2.0 - 1.0;
+
+  return abs(projectionMatrix[3][2] / (ndc * projectionMatrix[2][3] - projectionMatrix[2][2]));
+}
+
+void main()
+{
+  // the 4 low-resolution texels around this pixel and their bilinear weights
+  ivec2 size = textureSize(dropletDepth, 0);
+  vec2  st   = screenUV * vec2(size) - 0.5;
+  ivec2 base = ivec2(floor(st));
+  vec2  f    = st - floor(st);
+
+  ivec2 coords[4];
+  float depths[4];
+  float weights[4];
+
+  coords[0] = clamp(base,               ivec2(0), size - 1);
+  coords[1] = clamp(base + ivec2(1, 0), ivec2(0), size - 1);
+  coords[2] = clamp(base + ivec2(0, 1), ivec2(0), size - 1);
+  coords[3] = clamp(base + ivec2(1, 1), ivec2(0), size - 1);
+
+  weights[0] = (1.0 - f.x) * (1.0 - f.y);
+  weights[1] = f.x * (1.0 - f.y);
+  weights[2] = (1.0 - f.x) * f.y;
+  weights[3] = f.x * f.y;
+
+  // coverage decides the silhouette; the covered texel weighing most is the reference surface
+  float coverage  = 0.0;
+  float reference = 0.0;
+  float heaviest  = -1.0;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    depths[i] = texelFetch(dropletDepth, coords[i], 0).r;
+
+    if (depths[i] < 1.0)
+    {
+      coverage += weights[i];
+
+      if (weights[i] > heaviest)
+      {
+        heaviest  = weights[i];
+        reference = viewDepth(depths[i]);
+      }
+    }
+  }
+
+  if (coverage < MIN_COVERAGE)
+    discard;
+
+  vec3  color  = vec3(0.0);
+  float depth  = 0.0;
+  float weight = 0.0;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    if (depths[i] < 1.0 && abs(viewDepth(depths[i]) - reference) < DEPTH_TOLERANCE)
+    {
+      color  += texelFetch(dropletTarget, coords[i], 0).rgb * weights[i];
+      depth  += depths[i] * weights[i];
+      weight += weights[i];
+    }
+  }
+
+  // weight > 0: with coverage >= MIN_COVERAGE the reference weighs at least 1/8
+  gl_FragDepth = depth / weight;
+  fragColor    = vec4(color / weight, 1.0);
+}
@@ -1,4 +1,5 @@
 #shader vertex
+#version 300 es
 precision highp float;
 
 // Proxy geometry is a unit cube positioned at the droplet centre and scaled to enclose the metaball.
@@ -8,10 +9,10 @@ precision highp float;
 uniform mat4 MVP;
 uniform mat4 modelMatrix;
 
-attribute vec3 vPosition;
+in vec3 vPosition;
 
-varying vec3 worldPos;
-varying vec4 clipPos;
+out vec3 worldPos;
+out vec4 clipPos;
 
 void main()
 {
@@ -21,18 +22,28 @@ void main()
 }
 
 #shader pixel
+#version 300 es
 precision highp float;
 
 // Metaball droplet: a sum-of-spheres SDF, sphere-traced inside the proxy box. The hit point's analytic
-// gradient is the surface normal. Shading:
+// gradient is the surface normal. With brickResolution > 0 the same field comes baked into a 3D texture
+// (launcher::DropletBrick, see world.cpp): one fetch per step instead of a loop over the particles.
+// Smaller droplets on screen come at a lower LOD: fewer particles and steps, or (impostor) a single
+// sphere intersected analytically, shaded the same way.
+// Optionally the droplets are raymarched at a fraction of the view resolution into an offscreen target
+// and droplet_composite.glsl upsamples them into the view: the forward pass compiles this file a second
+// time with DROPLET_OFFSCREEN_TARGET defined, which also writes the hit's depth.
+// Shading:
 //   - REFRACTION: screen-space — sample the real scene behind the droplet (the leaf), rendered without
 //     droplets by the water pass into refractionTexture, warped by the surface tilt. This makes the
 //     droplet read as clear water showing the magnified/distorted leaf, instead of the flat opaque blob
 //     the per-droplet cubemap gave (the cubemap, shot from the droplet centre on a leaf, is just flat green).
 //   - REFLECTION: the per-droplet environment cubemap (sky/surroundings on the grazing edges).
 
-varying vec3 worldPos;
-varying vec4 clipPos;
+in vec3 worldPos;
+in vec4 clipPos;
+
+out vec4 fragColor;
 
 #define MAX_DROPLET_PARTICLES 64   // must match MAX_DROPLET_RAYMARCH_PARTICLES in world.cpp
 #define MAX_POINT_LIGHTS 32
@@ -42,14 +53,25 @@ uniform vec3       worldViewPosition;
 uniform mat4       viewMatrix;        // world -> view: expresses the surface tilt in screen space
 uniform samplerCube environmentMap;   // per-droplet cubemap (reflection)
 uniform sampler2D  refractionTexture; // scene minus droplets (the leaf behind), from the water pass
+uniform highp sampler3D distanceBrick; // per-droplet baked field over the proxy box (brickResolution > 0)
+
+#ifdef DROPLET_OFFSCREEN_TARGET
+uniform mat4       viewProjectionMatrix; // world -> clip: the hit's depth
+#endif
 
-// per-droplet (set via the mesh node's PropertyMap user-data, see world.cpp)
-uniform vec4  particles[MAX_DROPLET_PARTICLES]; // .xyz world-space centre, .w radius
-uniform int   particleCount;
-uniform vec3  dropletCenter;
-uniform float influenceRadius;        // smooth-min blend k (blobbiness / merge)
-uniform float isoThreshold;           // surface iso level (inflate / thin)
-uniform float boxHalfExtent;          // world half-size of the proxy box (for ray clipping)
+// per-droplet: the mesh node's uniform buffer, updated in place (DropletUniforms in world.cpp, same layout)
+layout(std140) uniform DropletBlock
+{
+  vec3  dropletCenter;
+  float boxHalfExtent;                // world half-size of the proxy box (for ray clipping)
+  float influenceRadius;              // smooth-min blend k (blobbiness / merge)
+  float isoThreshold;                 // surface iso level (inflate / thin)
+  int   particleCount;
+  int   brickResolution;              // > 0: march the distanceBrick of that size instead of the particles
+  int   lodLevel;                     // 0 full, 1 reduced, 2 impostor (particles[0] is the sphere)
+  int   stepBudget;                   // march steps, up to MAX_STEPS
+  vec4  particles[MAX_DROPLET_PARTICLES]; // .xyz world-space centre, .w radius
+};
 
 // lights: same names + model as fresnel.glsl, populated by the forward pass frame properties
 uniform vec3  pointLightPositions[MAX_POINT_LIGHTS];
@@ -77,10 +99,12 @@ const vec3  DROPLET_COLOR           = vec3(1.0);
 const float DROPLET_SHININESS       = 200.0; // tight, crisp glint -> reads as a wet bead
 const float DROPLET_SPECULAR_AMOUNT = 0.8;
 
-const int   MAX_STEPS  = 64;
+const int   MAX_STEPS  = 64;    // MUST match DROPLET_LOD_FULL_STEPS in world.cpp
 const float SURF_EPS   = 0.0015;
 const float NORMAL_EPS = 0.0015;
 
+const int   LOD_IMPOSTOR = 2;   // lodLevel: DROPLET_LOD_IMPOSTOR in world.cpp
+
 // IQ polynomial smooth-min: blends the sphere fields so neighbours neck/merge instead of intersecting
 float smin(float a, float b, float k)
 {
@@ -93,6 +117,10 @@ float smin(float a, float b, float k)
 
 float map(vec3 p)
 {
+  // baked: one trilinear fetch (the brick's texels sit at the voxel centres of the proxy box)
+  if (brickResolution > 0)
+    return texture(distanceBrick, (p - dropletCenter) / (2.0 * boxHalfExtent) + 0.5).r;
+
   float d = 1.0e9;
 
   for (int i = 0; i < MAX_DROPLET_PARTICLES; ++i)
@@ -109,7 +137,9 @@ float map(vec3 p)
 
 vec3 calcNormal(vec3 p)
 {
-  vec2 e = vec2(NORMAL_EPS, 0.0);
+  // a brick's gradient is taken across one voxel (finer taps only see the trilinear facets)
+  float eps = brickResolution > 0 ? 2.0 * boxHalfExtent / float(brickResolution) : NORMAL_EPS;
+  vec2  e   = vec2(eps, 0.0);
   return normalize(vec3(
     map(p + e.xyy) - map(p - e.xyy),
     map(p + e.yxy) - map(p - e.yxy),
@@ -134,14 +164,14 @@ vec3 shade(vec3 p, vec3 n, vec2 screenUV)
   vec3 V = -I;                                 // surface -> eye
 
   // --- reflection: per-droplet cubemap ---
-  vec3 reflectCol = textureCube(environmentMap, reflect(I, n)).xyz;
+  vec3 reflectCol = texture(environmentMap, reflect(I, n)).xyz;
 
   // --- refraction: the real scene behind the droplet, warped by the surface tilt (screen space) ---
   // the view-space normal xy is the surface slope on screen; offsetting the lookup by it bends the
   // background like a lens (centre ~undistorted, edges warp), showing the magnified leaf through the drop.
   vec2 viewN     = (viewMatrix * vec4(n, 0.0)).xy;
   vec2 uv        = clamp(screenUV - viewN * REFR_STRENGTH, 0.0, 1.0);
-  vec3 refractCol = texture2D(refractionTexture, uv).xyz * REFR_TINT;
+  vec3 refractCol = texture(refractionTexture, uv).xyz * REFR_TINT;
 
   float fresnel  = clamp(F + (1.0 - F) * pow(1.0 + dot(I, n), fresnelPower), 0.0, 1.0);
   vec3  envColor = mix(refractCol, reflectCol, fresnel);
@@ -189,34 +219,70 @@ void main()
   vec3 rd = normalize(worldPos - ro);
 
   vec2  iv = boxInterval(ro, rd);
-  float t  = max(iv.x, 0.0);
+  float t0 = max(iv.x, 0.0);
+  float t  = t0;
   float tf = iv.y;
 
   if (t > tf)
     discard;
 
-  bool hit = false;
+  vec3 p, n;
 
-  for (int i = 0; i < MAX_STEPS; ++i)
+  if (lodLevel == LOD_IMPOSTOR)
   {
-    float d = map(ro + rd * t);
+    // ray vs the impostor sphere
+    vec3  oc = ro - particles[0].xyz;
+    float b  = dot(oc, rd);
+    float h  = b * b - dot(oc, oc) + particles[0].w * particles[0].w;
 
-    if (d < SURF_EPS) { hit = true; break; }
+    if (h < 0.0)
+      discard;
 
-    t += d;
+    t = -b - sqrt(h);
 
-    if (t > tf)
-      break;
+    if (t < 0.0)
+      discard;
+
+    p = ro + rd * t;
+    n = normalize(p - particles[0].xyz);
   }
+  else
+  {
+    bool hit = false;
 
-  if (!hit)
-    discard;
+    for (int i = 0; i < MAX_STEPS; ++i)
+    {
+      if (i >= stepBudget)
+        break;
 
-  vec3 p = ro + rd * t;
-  vec3 n = calcNormal(p);
+      float d = map(ro + rd * t);
+
+      if (d < SURF_EPS) { hit = true; break; }
+
+      t += d;
+
+      if (t > tf)
+        break;
+    }
+
+    if (!hit)
+      discard;
+
+    p = ro + rd * t;
+    n = calcNormal(p);
+  }
 
   // the hit point lies on the ray through this pixel, so its screen position IS this fragment's
   vec2 screenUV = clipPos.xy / clipPos.w * 0.5 + 0.5;
 
-  gl_FragColor = vec4(shade(p, n, screenUV), 1.0);
+#ifdef DROPLET_OFFSCREEN_TARGET
+  // the hit's own depth, not the box's: the target's depth test keeps the nearest droplet where several
+  // overlap, and the composite tests it against the scene. Only this variant writes it, so the direct
+  // pass keeps the early depth test against the box.
+  vec4 hitClip = viewProjectionMatrix * vec4(p, 1.0);
+
+  gl_FragDepth = clamp(hitClip.z / hitClip.w * 0.5 + 0.5, 0.0, 1.0);
+#endif
+
+  fragColor = vec4(shade(p, n, screenUV), 1.0);
 }
@@ -1,12 +1,23 @@
 // Procedural-flower shader: the vertex colour IS the (lit) albedo, so the generator can paint
 // petals / florets / stem without any texture. Same point-light interface as forward_lighting.glsl,
 // plus a small ambient so blooms still read at night. Two-sided (petals are single-strip surfaces).
+//
+// A growing plant (plant_gen.cpp) is tessellated once at full growth: its material's plantGrowth (g)
+// swells each tube ring out of the branch centreline over the g span in vTexCoord, by the ring radius in
+// vColor.a. plantGrowth < 0 draws the mesh as is.
+//
+// A grown plant's skeleton mesh is skinned: its material's bonePalette holds one 3x4 bone matrix (rest
+// pose -> posed) per row, as three RGBA32F texels, and boneCount its rows. A vertex follows bone
+// vTexCoord.x with weight vColor.a and bone vTexCoord.y with the rest. boneCount 0: not skinned.
 
 #shader vertex
-precision mediump float;
+precision highp float; // bone matrices hold world translations; mediump would make the branches jitter
 
 uniform mat4 MVP;
 uniform mat4 modelMatrix;
+uniform float plantGrowth;
+uniform sampler2D bonePalette;
+uniform float boneCount;
 attribute vec4 vColor;
 attribute vec3 vPosition;
 attribute vec3 vNormal;
@@ -15,12 +26,36 @@ varying vec4 position;
 varying vec4 normal;
 varying vec4 color;
 
+mat4 bone_matrix(float bone)
+{
+  float v  = (bone + 0.5) / boneCount;
+  vec4  r0 = texture2D(bonePalette, vec2(0.5 / 3.0, v));
+  vec4  r1 = texture2D(bonePalette, vec2(1.5 / 3.0, v));
+  vec4  r2 = texture2D(bonePalette, vec2(2.5 / 3.0, v));
+
+  return mat4(r0.x, r1.x, r2.x, 0.0, r0.y, r1.y, r2.y, 0.0, r0.z, r1.z, r2.z, 0.0, r0.w, r1.w, r2.w, 1.0);
+}
+
 void main()
 {
-  gl_Position = MVP * vec4(vPosition, 1.0);
-  position = modelMatrix * vec4(vPosition, 1.0);
-  normal   = modelMatrix * vec4(vNormal, 0.0);
-  color    = vColor;
+  vec3 P = vPosition;
+  vec3 N = vNormal;
+
+  if (plantGrowth >= 0.0)
+    P -= vNormal * vColor.a * (1.0 - clamp((plantGrowth - vTexCoord.x) / max(vTexCoord.y - vTexCoord.x, 1e-4), 0.0, 1.0));
+
+  if (boneCount > 0.0)
+  {
+    mat4 skin = bone_matrix(vTexCoord.x) * vColor.a + bone_matrix(vTexCoord.y) * (1.0 - vColor.a);
+
+    P = (skin * vec4(P, 1.0)).xyz;
+    N = (skin * vec4(N, 0.0)).xyz;
+  }
+
+  gl_Position = MVP * vec4(P, 1.0);
+  position = modelMatrix * vec4(P, 1.0);
+  normal   = modelMatrix * vec4(N, 0.0);
+  color    = vec4(vColor.rgb, 1.0);
 }
 
 #shader pixel
@@ -3,12 +3,19 @@
 // generated leaf blades. No alpha discard (the blade geometry is already leaf-shaped), which is why
 // this is a dedicated pass rather than reusing forward_lighting (whose discard/normal-map path left
 // the leaves black).
+//
+// Generated leaves are batched (world.cpp LeafBatch): a batch mesh holds copies of one unit-length blade,
+// each tagged with its instance in vColor.a. The material's instancePalette holds per instance (row) the
+// three rows of its 3x4 transform and its tint rgb + wilt (tip droop), as four RGBA32F texels, and
+// instanceCount its rows. instanceCount 0: the mesh is drawn as is.
 
 #shader vertex
-precision mediump float;
+precision highp float; // instance matrices hold world translations
 
 uniform mat4 MVP;
 uniform mat4 modelMatrix;
+uniform sampler2D instancePalette;
+uniform float instanceCount;
 attribute vec4 vColor;
 attribute vec3 vPosition;
 attribute vec3 vNormal;
@@ -16,12 +23,38 @@ attribute vec2 vTexCoord;
 varying vec4 position;
 varying vec4 normal;
 varying vec2 texCoord;
+varying vec3 tint;
 
 void main()
 {
-  gl_Position = MVP * vec4(vPosition, 1.0);
-  position = modelMatrix * vec4(vPosition, 1.0);
-  normal   = modelMatrix * vec4(vNormal, 0.0);
+  vec3 P = vPosition;
+  vec3 N = vNormal;
+
+  tint = vec3(1.0);
+
+  if (instanceCount > 0.0)
+  {
+    float v     = (vColor.a + 0.5) / instanceCount;
+    vec4  r0    = texture2D(instancePalette, vec2(0.5 / 4.0, v));
+    vec4  r1    = texture2D(instancePalette, vec2(1.5 / 4.0, v));
+    vec4  r2    = texture2D(instancePalette, vec2(2.5 / 4.0, v));
+    vec4  extra = texture2D(instancePalette, vec2(3.5 / 4.0, v));
+
+      // wilt: the blade (along +X, unit length) droops as y -= wilt * x^2; tilt the normal to match
+
+    N.x += 2.0 * extra.w * P.x * N.y;
+    P.y -= extra.w * P.x * P.x;
+
+    mat4 M = mat4(r0.x, r1.x, r2.x, 0.0, r0.y, r1.y, r2.y, 0.0, r0.z, r1.z, r2.z, 0.0, r0.w, r1.w, r2.w, 1.0);
+
+    P    = (M * vec4(P, 1.0)).xyz;
+    N    = (M * vec4(N, 0.0)).xyz; // uniform scale: normalized per pixel
+    tint = extra.rgb;
+  }
+
+  gl_Position = MVP * vec4(P, 1.0);
+  position = modelMatrix * vec4(P, 1.0);
+  normal   = modelMatrix * vec4(N, 0.0);
   texCoord = vTexCoord;
 }
 
@@ -31,6 +64,7 @@ precision mediump float;
 varying vec4 position;
 varying vec4 normal;
 varying vec2 texCoord;
+varying vec3 tint;
 
 #define outColor gl_FragColor
 #define texture texture2D
@@ -57,7 +91,7 @@ void main()
   if (dot(N, eyeDir) < 0.0)
     N = -N;
 
-  vec3 albedo = texture(diffuseTexture, texCoord).rgb;
+  vec3 albedo = texture(diffuseTexture, texCoord).rgb * tint;
   vec3 lit = albedo * AMBIENT;
 
   for (int i = 0; i < MAX_POINT_LIGHTS; ++i)
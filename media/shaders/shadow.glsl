@@ -1,17 +1,65 @@
 #shader vertex
-precision mediump float;
+precision highp float; // skinned plant bones (see flower.glsl)
 #ifndef GL_ES
 #version 410 core
 in vec3 vPosition;
+in vec3 vNormal;
+in vec4 vColor;
+in vec2 vTexCoord;
+#define texture2D texture
 #else
 attribute vec3 vPosition;
+attribute vec3 vNormal;
+attribute vec4 vColor;
+attribute vec2 vTexCoord;
 #endif
 
 uniform mat4 MVP;
+uniform float plantGrowth;     // a growing plant's material (see flower.glsl); the pass default < 0 casts the mesh as is
+uniform sampler2D bonePalette; // a skinned plant skeleton's material (see flower.glsl); the pass default boneCount 0 skips it
+uniform float boneCount;
+uniform sampler2D instancePalette; // a leaf batch's material (see leaf.glsl); the pass default instanceCount 0 skips it
+uniform float instanceCount;
+
+mat4 bone_matrix(float bone)
+{
+  float v  = (bone + 0.5) / boneCount;
+  vec4  r0 = texture2D(bonePalette, vec2(0.5 / 3.0, v));
+  vec4  r1 = texture2D(bonePalette, vec2(1.5 / 3.0, v));
+  vec4  r2 = texture2D(bonePalette, vec2(2.5 / 3.0, v));
+
+  return mat4(r0.x, r1.x, r2.x, 0.0, r0.y, r1.y, r2.y, 0.0, r0.z, r1.z, r2.z, 0.0, r0.w, r1.w, r2.w, 1.0);
+}
+
+mat4 instance_matrix(float instance)
+{
+  float v  = (instance + 0.5) / instanceCount;
+  vec4  r0 = texture2D(instancePalette, vec2(0.5 / 4.0, v));
+  vec4  r1 = texture2D(instancePalette, vec2(1.5 / 4.0, v));
+  vec4  r2 = texture2D(instancePalette, vec2(2.5 / 4.0, v));
+
+  return mat4(r0.x, r1.x, r2.x, 0.0, r0.y, r1.y, r2.y, 0.0, r0.z, r1.z, r2.z, 0.0, r0.w, r1.w, r2.w, 1.0);
+}
 
 void main()
 {
-  gl_Position = MVP * vec4(vPosition, 1.0);
+  vec3 P = vPosition;
+
+  if (plantGrowth >= 0.0)
+    P -= vNormal * vColor.a * (1.0 - clamp((plantGrowth - vTexCoord.x) / max(vTexCoord.y - vTexCoord.x, 1e-4), 0.0, 1.0));
+
+  if (boneCount > 0.0)
+    P = ((bone_matrix(vTexCoord.x) * vColor.a + bone_matrix(vTexCoord.y) * (1.0 - vColor.a)) * vec4(P, 1.0)).xyz;
+
+  if (instanceCount > 0.0)
+  {
+    float wilt = texture2D(instancePalette, vec2(3.5 / 4.0, (vColor.a + 0.5) / instanceCount)).w;
+
+    P.y -= wilt * P.x * P.x;
+    P    = (instance_matrix(vColor.a) * vec4(P, 1.0)).xyz;
+  }
+
+  gl_Position = MVP * vec4(P, 1.0);
 }
 
 #shader pixel
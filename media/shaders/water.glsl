@@ -1,22 +1,87 @@
 #shader vertex
-precision mediump float;
+precision highp float; // the swell phase grows with the clock; mediump (fp16 on mobile) would lose it
 
 uniform mat4 MVP;
 uniform mat4 modelMatrix;
 
+// Ripple fields U uploaded from the CPU (R16F, bilinear): one over the whole sea and a finer one around
+// the tree, both anchored at the world origin. The mesh is a camera-centred clipmap (water_clipmap.h),
+// so vertices fall anywhere on the fields: height = U * scale + swell, clamped above the platform; normal
+// = (central differences of U and of the swell, 1), taken over the vertex's own clipmap cell and scaled
+// back to the far field's cell the steepness constants were tuned for. Ripples are faded out on levels
+// too coarse to carry them.
+uniform sampler2D rippleTexture;      // far field (whole sea)
+uniform sampler2D rippleNearTexture;  // near field (around the tree)
+uniform float waterDisplacement;  // 1: displace here; 0: vertices were already displaced on the CPU
+uniform vec4  waterRipple;        // height scale, ripple normal steepness, swell normal steepness, min height
+uniform vec3  waterSwell1;        // amplitude, wave number (2pi / length), angular speed; travels along x
+uniform vec3  waterSwell2;        // same, travels along (0.7, 0.7)
+uniform vec3  waterGrid;          // swell time, far field half extent, far field texel size (1 / grid size)
+uniform vec3  waterNearGrid;      // near field half extent, near field texel size, width of its fade into the far field
+
 attribute vec3 vPosition;
 attribute vec3 vNormal;
+attribute vec2 vTexCoord;         // x: cell size of the clipmap level owning the vertex
 
 varying vec3 worldPos;
 varying vec3 worldNormal;
 varying vec4 clipPos;
 
+float swell(vec2 xz)
+{
+  float t = waterGrid.x;
+
+  return waterSwell1.x * sin(xz.x * waterSwell1.y + t * waterSwell1.z)
+       + waterSwell2.x * sin((xz.x * 0.7 + xz.y * 0.7) * waterSwell2.y + t * waterSwell2.z);
+}
+
+// texture coordinates of world (x, z) in a field: row i runs along v and world x decreases with i,
+// texel centres at (index + 0.5) / size (see WaterGrid::coord)
+vec2 field_uv(vec2 xz, float half_extent, float texel)
+{
+  return 0.5 - xz.yx / (2.0 * half_extent) + 0.5 * texel;
+}
+
+// 1 inside [0, 1]^2; the fields' border texels are zero, so this also stops the repeat wrap
+float field_mask(vec2 uv)
+{
+  return step(0.0, uv.x) * step(uv.x, 1.0) * step(0.0, uv.y) * step(uv.y, 1.0);
+}
+
+float ripple(vec2 xz)
+{
+  vec2  far_uv  = field_uv(xz, waterGrid.y, waterGrid.z);
+  vec2  near_uv = field_uv(xz, waterNearGrid.x, waterNearGrid.y);
+  float u_far   = texture2D(rippleTexture, far_uv).r * field_mask(far_uv);
+  float u_near  = texture2D(rippleNearTexture, near_uv).r;
+  float inside  = clamp((waterNearGrid.x - max(abs(xz.x), abs(xz.y))) / waterNearGrid.z, 0.0, 1.0);
+
+  return mix(u_far, u_near, inside);
+}
+
 void main()
 {
-  gl_Position = MVP * vec4(vPosition, 1.0);
+  vec2  xz   = (modelMatrix * vec4(vPosition, 1.0)).xz; // the clipmap node follows the camera
+  float d    = vTexCoord.x;                             // slope sample spacing: the vertex's clipmap cell
+  float cell = 2.0 * waterGrid.y * waterGrid.z;         // far field cell
+  float fade = clamp(2.0 - d / (2.0 * cell), 0.0, 1.0); // ripples alias on cells past ~2 far cells
+  float k    = cell / d;
+  vec2  dx   = vec2(d, 0.0);
+  vec2  dz   = vec2(0.0, d);
+
+  float height = max(ripple(xz) * fade * waterRipple.x + swell(xz), waterRipple.w);
+  float nx     = ((ripple(xz + dx) - ripple(xz - dx)) * fade * waterRipple.y + (swell(xz + dx) - swell(xz - dx)) * waterRipple.z) * k;
+  float nz     = ((ripple(xz + dz) - ripple(xz - dz)) * fade * waterRipple.y + (swell(xz + dz) - swell(xz - dz)) * waterRipple.z) * k;
+
+  float displace = waterDisplacement;
+
+  vec3 position = vec3(vPosition.x, mix(vPosition.y, height, displace), vPosition.z);
+  vec3 normal   = mix(vNormal, vec3(nx, 1.0, nz), displace); // static mesh: vNormal is flat up
+
+  gl_Position = MVP * vec4(position, 1.0);
   clipPos     = gl_Position;                               // for screen-space sampling
-  worldPos    = (modelMatrix * vec4(vPosition, 1.0)).xyz;
-  worldNormal = (modelMatrix * vec4(vNormal, 0.0)).xyz;    // uniform node scale -> correct
+  worldPos    = (modelMatrix * vec4(position, 1.0)).xyz;
+  worldNormal = (modelMatrix * vec4(normal, 0.0)).xyz;     // uniform node scale -> correct
 }
 
 #shader pixel
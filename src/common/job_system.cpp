@@ -0,0 +1,300 @@
+#include <common/job_system.h>
+#include <common/exception.h>
+#include <common/profiler.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Emscripten builds have threads only with -pthread (SharedArrayBuffer; `make THREADS=1`)
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  #define ENGINE_JOB_SYSTEM_THREADS 0
+#else
+  #define ENGINE_JOB_SYSTEM_THREADS 1
+#endif
+
+namespace engine {
+namespace common {
+
+namespace
+{
+
+/// Queued job
+struct Job
+{
+  JobFunction fn;
+  void*       context;
+  size_t      begin;
+  size_t      end;
+  JobCounter* counter;
+};
+
+/// Deque of one thread. The owner pushes and pops at the back (the newest job: its data is still in
+/// cache), thieves take the oldest from the front. A short lock per operation: the jobs here are coarse
+/// (world phases, chunks of a parallel-for), so a lock-free deque would not pay off.
+struct JobQueue
+{
+  std::mutex      mutex;
+  std::deque<Job> jobs;
+
+  void push(const Job& job)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    jobs.push_back(job);
+  }
+
+  bool pop(Job& job)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (jobs.empty())
+      return false;
+
+    job = jobs.back();
+
+    jobs.pop_back();
+
+    return true;
+  }
+
+  bool steal(Job& job)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (jobs.empty())
+      return false;
+
+    job = jobs.front();
+
+    jobs.pop_front();
+
+    return true;
+  }
+};
+
+}
+
+/// Implementation details of job system
+struct JobSystem::Impl
+{
+  std::vector<std::unique_ptr<JobQueue>> queues;        // [0]: threads outside the pool, [1 + i]: worker i
+  std::vector<std::thread>               workers;
+  std::atomic<size_t>                    queued {0};    // jobs in the queues
+  std::atomic<bool>                      stopping {false};
+  std::mutex                             sleep_mutex;
+  std::condition_variable                wake;
+
+  static thread_local Impl*  current_system;            // pool of the calling worker thread
+  static thread_local size_t current_queue;
+
+  // The calling thread's queue: its own on a worker of this pool, the shared one elsewhere
+  size_t queue_index() const
+  {
+    return current_system == this ? current_queue : 0;
+  }
+
+  void push(const Job& job)
+  {
+    queued.fetch_add(1, std::memory_order_release); // before the push: never below the queued jobs
+
+    queues[queue_index()]->push(job);
+
+      //touch the mutex so a worker between its queued check and wait() does not miss the notify
+
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+
+    wake.notify_one();
+  }
+
+  // Run one job: the newest of the own queue, else the oldest of another one
+  bool run_one()
+  {
+    if (!queued.load(std::memory_order_acquire))
+      return false;
+
+    const size_t own   = queue_index();
+    const size_t count = queues.size();
+
+    Job job;
+
+    bool found = queues[own]->pop(job);
+
+    for (size_t i=1; !found && i<count; i++)
+      found = queues[(own + i) % count]->steal(job);
+
+    if (!found)
+      return false;
+
+    queued.fetch_sub(1, std::memory_order_relaxed);
+
+    job.fn(job.context, job.begin, job.end);
+
+    job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+  }
+
+  void worker(size_t index)
+  {
+    current_system = this;
+    current_queue  = index;
+
+    char name[32];
+
+    snprintf(name, sizeof name, "job worker %u", unsigned(index));
+
+    profiler::set_thread_name(name);
+
+    while (!stopping.load(std::memory_order_acquire))
+    {
+      if (run_one())
+        continue;
+
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+
+      wake.wait(lock, [this] { return stopping.load(std::memory_order_acquire) || queued.load(std::memory_order_acquire) > 0; });
+    }
+  }
+};
+
+thread_local JobSystem::Impl* JobSystem::Impl::current_system = nullptr;
+thread_local size_t           JobSystem::Impl::current_queue  = 0;
+
+/// Constructor / destructor
+
+JobSystem::JobSystem(size_t workers_count)
+  : impl(new Impl)
+{
+  if (!ENGINE_JOB_SYSTEM_THREADS)
+    workers_count = 0;
+
+  impl->queues.resize(workers_count + 1);
+
+  for (std::unique_ptr<JobQueue>& queue : impl->queues)
+    queue.reset(new JobQueue);
+
+  impl->workers.reserve(workers_count);
+
+  for (size_t i=0; i<workers_count; i++)
+    impl->workers.emplace_back(&Impl::worker, impl.get(), i + 1);
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(impl->sleep_mutex);
+
+    impl->stopping.store(true, std::memory_order_release);
+  }
+
+  impl->wake.notify_all();
+
+  for (std::thread& worker : impl->workers)
+    worker.join();
+}
+
+/// Workers
+
+size_t JobSystem::default_workers_count()
+{
+  if (!ENGINE_JOB_SYSTEM_THREADS)
+    return 0;
+
+  size_t hardware = std::thread::hardware_concurrency();
+
+  if (hardware <= 1)
+    return 0;
+
+  return hardware - 1 < MAX_DEFAULT_WORKERS ? hardware - 1 : MAX_DEFAULT_WORKERS;
+}
+
+size_t JobSystem::workers_count() const
+{
+  return impl->workers.size();
+}
+
+/// Jobs
+
+void JobSystem::submit(JobFunction fn, void* context, size_t begin, size_t end, JobCounter& counter)
+{
+  engine_check_null(fn);
+
+  if (impl->workers.empty())
+  {
+    fn(context, begin, end);
+    return;
+  }
+
+  counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+  impl->push({fn, context, begin, end, &counter});
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+  while (!counter.done())
+    if (!impl->run_one())
+      std::this_thread::yield(); // the last jobs run elsewhere
+}
+
+/// Task graph
+
+TaskGraph::TaskId TaskGraph::add(const char* name, std::function<void ()> fn)
+{
+  engine_check_null(name);
+
+  tasks.emplace_back(name, std::move(fn));
+
+  return tasks.size() - 1;
+}
+
+void TaskGraph::depend(TaskId task, TaskId on)
+{
+  engine_check_range(task, tasks.size());
+  engine_check_range(on, task); // earlier tasks only: no cycles
+
+  tasks[on].dependents.push_back(task);
+  tasks[task].dependencies_count++;
+}
+
+void TaskGraph::run_task(void* context, size_t index, size_t)
+{
+  TaskGraph& graph = *static_cast<TaskGraph*>(context);
+  Task&      task  = graph.tasks[index];
+
+  {
+    engine_profile_zone(task.name);
+
+    task.fn();
+  }
+
+  for (TaskId dependent : task.dependents)
+    if (graph.tasks[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      graph.jobs->submit(&TaskGraph::run_task, &graph, dependent, dependent + 1, *graph.counter);
+}
+
+void TaskGraph::run(JobSystem& job_system)
+{
+  JobCounter finished;
+
+  jobs    = &job_system;
+  counter = &finished;
+
+  for (Task& task : tasks)
+    task.remaining.store(task.dependencies_count, std::memory_order_relaxed);
+
+  for (size_t i=0, count=tasks.size(); i<count; i++)
+    if (!tasks[i].dependencies_count)
+      job_system.submit(&TaskGraph::run_task, this, i, i + 1, finished);
+
+  job_system.wait(finished);
+
+  jobs    = nullptr;
+  counter = nullptr;
+}
+
+}}
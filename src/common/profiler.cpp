@@ -0,0 +1,297 @@
+#include <common/profiler.h>
+#include <common/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace engine {
+namespace common {
+namespace profiler {
+
+namespace
+{
+
+///
+/// Constants
+///
+
+const size_t RING_CAPACITY = 8192; // zones kept per thread (power of two); ~4 frames of a busy frame
+const size_t STATS_WINDOW  = 256;  // samples per zone in the rolling statistics
+
+/// Recorded zone
+struct ZoneEvent
+{
+  const char* name;
+  uint64_t    start;
+  uint64_t    end;
+  uint32_t    depth;
+};
+
+/// Ring buffer of one thread. The owner thread writes events and publishes them by advancing head;
+/// readers (end_frame, chrome_trace) take the events below head. A reader that falls more than the
+/// capacity behind loses the overwritten ones.
+struct ThreadBuffer
+{
+  ZoneEvent                events[RING_CAPACITY];
+  std::atomic<uint64_t>    head {0};             // events ever written
+  uint32_t                 depth = 0;            // open scoped zones (owner only)
+  uint32_t                 thread_id = 0;
+  std::atomic<const char*> thread_name {nullptr};
+  uint64_t                 stats_cursor = 0;     // events folded into the statistics (under stats_mutex)
+  ThreadBuffer*            next = nullptr;       // registry list
+};
+
+/// Rolling window of one zone
+struct ZoneWindow
+{
+  const char* name;
+  size_t      calls = 0;
+  size_t      next  = 0;
+  double      samples[STATS_WINDOW];
+};
+
+std::atomic<ThreadBuffer*> buffers {nullptr};  // every thread's buffer (push-only list; buffers outlive their threads)
+std::atomic<uint32_t>      threads_count {0};
+thread_local ThreadBuffer* current_buffer = nullptr;
+
+const uint64_t epoch = timestamp();
+
+std::mutex                                                   stats_mutex;   // end_frame / stats (consumers only)
+std::unordered_map<const char*, ZoneWindow*>                 zones_by_pointer;
+std::unordered_map<std::string, std::unique_ptr<ZoneWindow>> zones_by_name; // one window per name, whichever literal names it
+uint64_t                                                     last_frame_end = 0;
+
+std::mutex                      names_mutex;
+std::unordered_set<std::string> names;
+
+ThreadBuffer& thread_buffer()
+{
+  if (current_buffer)
+    return *current_buffer;
+
+  ThreadBuffer* buffer = new ThreadBuffer;
+
+  buffer->thread_id = threads_count.fetch_add(1);
+  buffer->next      = buffers.load(std::memory_order_relaxed);
+
+  while (!buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+  current_buffer = buffer;
+
+  return *buffer;
+}
+
+void push(ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end)
+{
+  uint64_t   head  = buffer.head.load(std::memory_order_relaxed);
+  ZoneEvent& event = buffer.events[head & (RING_CAPACITY - 1)];
+
+  event.name  = name;
+  event.start = start;
+  event.end   = end;
+  event.depth = buffer.depth;
+
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+ZoneWindow& zone_window(const char* name)
+{
+  auto it = zones_by_pointer.find(name);
+
+  if (it != zones_by_pointer.end())
+    return *it->second;
+
+  std::unique_ptr<ZoneWindow>& window = zones_by_name[name];
+
+  if (!window)
+  {
+    window.reset(new ZoneWindow);
+    window->name = intern(name);
+  }
+
+  zones_by_pointer[name] = window.get();
+
+  return *window;
+}
+
+void append_escaped(std::string& out, const char* string)
+{
+  for (; *string; string++)
+  {
+    if (*string == '"' || *string == '\\')
+      out += '\\';
+
+    out += *string;
+  }
+}
+
+}
+
+uint64_t timestamp()
+{
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void record_zone(const char* name, uint64_t start, uint64_t end)
+{
+  push(thread_buffer(), name, start, end);
+}
+
+const char* intern(const char* name)
+{
+  std::lock_guard<std::mutex> lock(names_mutex);
+
+  return names.insert(name ? name : "").first->c_str();
+}
+
+void set_thread_name(const char* name)
+{
+  thread_buffer().thread_name.store(intern(name), std::memory_order_release);
+}
+
+Zone::Zone(const char* name)
+  : name(name)
+  , start(timestamp())
+{
+  thread_buffer().depth++;
+}
+
+Zone::~Zone()
+{
+  ThreadBuffer& buffer = *current_buffer; // created by the constructor
+
+  buffer.depth--;
+
+  push(buffer, name, start, timestamp());
+}
+
+void end_frame()
+{
+  uint64_t now = timestamp();
+
+  std::lock_guard<std::mutex> lock(stats_mutex);
+
+  if (last_frame_end)
+    record_zone("frame", last_frame_end, now);
+
+  last_frame_end = now;
+
+  for (ThreadBuffer* buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+  {
+    uint64_t head  = buffer->head.load(std::memory_order_acquire);
+    uint64_t first = std::max(buffer->stats_cursor, head > RING_CAPACITY ? head - RING_CAPACITY : 0);
+
+    for (uint64_t i=first; i<head; i++)
+    {
+      const ZoneEvent& event  = buffer->events[i & (RING_CAPACITY - 1)];
+      ZoneWindow&      window = zone_window(event.name);
+
+      window.samples[window.next] = double(event.end - event.start) * 1e-6;
+      window.next                 = (window.next + 1) % STATS_WINDOW;
+      window.calls++;
+    }
+
+    buffer->stats_cursor = head;
+  }
+}
+
+std::vector<ZoneStats> stats()
+{
+  std::lock_guard<std::mutex> lock(stats_mutex);
+
+  std::vector<ZoneStats> result;
+  std::vector<double>    sorted;
+
+  result.reserve(zones_by_name.size());
+
+  for (const auto& entry : zones_by_name)
+  {
+    const ZoneWindow& window = *entry.second;
+    size_t            count  = std::min(window.calls, STATS_WINDOW);
+
+    sorted.assign(window.samples, window.samples + count);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+
+    for (double sample : sorted)
+      sum += sample;
+
+    ZoneStats zone;
+
+    zone.name    = window.name;
+    zone.calls   = window.calls;
+    zone.samples = count;
+    zone.min_ms  = sorted.front();
+    zone.avg_ms  = sum / count;
+    zone.p99_ms  = sorted[std::min(count - 1, count * 99 / 100)];
+    zone.last_ms = window.samples[(window.next + STATS_WINDOW - 1) % STATS_WINDOW];
+
+    result.push_back(zone);
+  }
+
+  std::sort(result.begin(), result.end(), [](const ZoneStats& a, const ZoneStats& b) { return strcmp(a.name, b.name) < 0; });
+
+  return result;
+}
+
+void log_stats()
+{
+  for (const ZoneStats& zone : stats())
+    engine_log_info("%-40s min %7.3f  avg %7.3f  p99 %7.3f  last %7.3f ms (%u calls)",
+      zone.name, zone.min_ms, zone.avg_ms, zone.p99_ms, zone.last_ms, (unsigned) zone.calls);
+}
+
+std::string chrome_trace()
+{
+  std::string out = "{\"traceEvents\":[\n";
+  bool        first_event = true;
+  char        text[160];
+
+  for (ThreadBuffer* buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+  {
+    if (const char* thread_name = buffer->thread_name.load(std::memory_order_acquire))
+    {
+      out += first_event ? "" : ",\n";
+      snprintf(text, sizeof text, "%u", buffer->thread_id);
+
+      out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+      out += text;
+      out += ",\"args\":{\"name\":\"";
+      append_escaped(out, thread_name);
+      out += "\"}}";
+
+      first_event = false;
+    }
+
+    uint64_t head  = buffer->head.load(std::memory_order_acquire);
+    uint64_t first = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+
+    for (uint64_t i=first; i<head; i++)
+    {
+      const ZoneEvent& event = buffer->events[i & (RING_CAPACITY - 1)];
+
+      out += first_event ? "{\"name\":\"" : ",\n{\"name\":\"";
+      append_escaped(out, event.name);
+      snprintf(text, sizeof text, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+        buffer->thread_id, double(event.start - epoch) * 1e-3, double(event.end - event.start) * 1e-3, event.depth);
+
+      out += text;
+
+      first_event = false;
+    }
+  }
+
+  out += "\n]}\n";
+
+  return out;
+}
+
+}}}
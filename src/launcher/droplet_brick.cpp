@@ -0,0 +1,176 @@
+#include "droplet_brick.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const float FAR_DISTANCE = 1.0e9f; // the shader's starting distance
+
+// IQ polynomial smooth-min, as droplet_fluid.glsl
+inline float smin(float a, float b, float k)
+{
+  if (k <= 0.0f)
+    return std::min(a, b);
+
+  float h = std::min(std::max(0.5f + 0.5f * (b - a) / k, 0.0f), 1.0f);
+
+  return b + (a - b) * h - k * h * (1.0f - h);
+}
+
+}
+
+size_t DropletBrick::resolution_for(float screen_fraction, float voxels_per_screen)
+{
+  float voxels = screen_fraction * voxels_per_screen;
+
+  if (!(voxels > float(DROPLET_BRICK_MIN_RESOLUTION))) // also NaN
+    return DROPLET_BRICK_MIN_RESOLUTION;
+
+  if (voxels >= float(DROPLET_BRICK_MAX_RESOLUTION))
+    return DROPLET_BRICK_MAX_RESOLUTION;
+
+  size_t steps = size_t(std::ceil(voxels / float(DROPLET_BRICK_RESOLUTION_STEP)));
+
+  return std::min(steps * DROPLET_BRICK_RESOLUTION_STEP, DROPLET_BRICK_MAX_RESOLUTION);
+}
+
+float DropletBrick::field(const float* particles, size_t count, float x, float y, float z, const DropletBrickParams& params)
+{
+  float d = FAR_DISTANCE;
+
+  for (size_t i=0; i<count; i++, particles += 4)
+  {
+    float dx = x - particles[0], dy = y - particles[1], dz = z - particles[2];
+
+    d = smin(d, std::sqrt(dx * dx + dy * dy + dz * dz) - particles[3], params.influence);
+  }
+
+  return d - params.iso;
+}
+
+void DropletBrick::splat(const float* particles, size_t count, const float center[3], float half_extent, size_t resolution,
+                         const DropletBrickParams& params)
+{
+  const size_t n = std::max(resolution, size_t(1));
+
+  grid_resolution = n;
+  voxel           = 2.0f * half_extent / float(n);
+  band_width      = DROPLET_BRICK_BAND_VOXELS * voxel;
+
+  for (size_t axis=0; axis<3; axis++)
+    origin[axis] = center[axis] - half_extent;
+
+  distances.assign(n * n * n, FAR_DISTANCE);
+
+    //splat each particle over the voxels it can bring inside the band: sphere + blend + band (+ iso)
+
+  const float k         = std::max(params.influence, 0.0f);
+  const float inv_voxel = 1.0f / voxel;
+
+  for (size_t p=0; p<count; p++, particles += 4)
+  {
+    const float cx = particles[0], cy = particles[1], cz = particles[2], radius = particles[3];
+    const float reach = std::max(radius + params.iso + band_width + k, 0.0f);
+
+    if (reach <= 0.0f)
+      continue;
+
+    size_t first[3], last[3];
+    const float c[3] = {cx, cy, cz};
+
+    bool outside = false;
+
+    for (size_t axis=0; axis<3; axis++)
+    {
+      float lo = (c[axis] - reach - origin[axis]) * inv_voxel - 0.5f;
+      float hi = (c[axis] + reach - origin[axis]) * inv_voxel - 0.5f;
+
+      if (hi < 0.0f || lo > float(n - 1))
+      {
+        outside = true;
+        break;
+      }
+
+      first[axis] = size_t(std::max(std::ceil(lo), 0.0f));
+      last[axis]  = std::min(size_t(std::floor(hi)), n - 1);
+    }
+
+    if (outside)
+      continue;
+
+    const float reach2 = reach * reach;
+
+    for (size_t iz=first[2]; iz<=last[2]; iz++)
+    {
+      const float dz = origin[2] + (float(iz) + 0.5f) * voxel - cz;
+
+      for (size_t iy=first[1]; iy<=last[1]; iy++)
+      {
+        const float dy   = origin[1] + (float(iy) + 0.5f) * voxel - cy;
+        const float dyz2 = dy * dy + dz * dz;
+
+        if (dyz2 >= reach2)
+          continue;
+
+        float* row = &distances[(iz * n + iy) * n];
+
+        for (size_t ix=first[0]; ix<=last[0]; ix++)
+        {
+          const float dx    = origin[0] + (float(ix) + 0.5f) * voxel - cx;
+          const float dist2 = dx * dx + dyz2;
+
+          if (dist2 >= reach2)
+            continue;
+
+          row[ix] = smin(row[ix], std::sqrt(dist2) - radius, k);
+        }
+      }
+    }
+  }
+
+    //surface level, clamped to the band
+
+  for (float& d : distances)
+    d = std::min(std::max(d - params.iso, -band_width), band_width);
+}
+
+float DropletBrick::sample(float x, float y, float z) const
+{
+  if (!grid_resolution)
+    return FAR_DISTANCE;
+
+  const size_t n     = grid_resolution;
+  const float  max_u = float(n - 1);
+  const float  p[3]  = {x, y, z};
+
+  size_t base[3];
+  float  t[3];
+
+  for (size_t axis=0; axis<3; axis++)
+  {
+    float u = std::min(std::max((p[axis] - origin[axis]) / voxel - 0.5f, 0.0f), max_u);
+
+    base[axis] = std::min(size_t(u), n > 1 ? n - 2 : 0);
+    t[axis]    = n > 1 ? u - float(base[axis]) : 0.0f;
+  }
+
+  const size_t step[3] = {n > 1 ? size_t(1) : 0, n > 1 ? n : 0, n > 1 ? n * n : 0};
+  const float* c       = &distances[(base[2] * n + base[1]) * n + base[0]];
+
+  float c00 = c[0]                 + (c[step[0]]                     - c[0])                 * t[0];
+  float c10 = c[step[1]]           + (c[step[1] + step[0]]           - c[step[1]])           * t[0];
+  float c01 = c[step[2]]           + (c[step[2] + step[0]]           - c[step[2]])           * t[0];
+  float c11 = c[step[2] + step[1]] + (c[step[2] + step[1] + step[0]] - c[step[2] + step[1]]) * t[0];
+
+  float c0 = c00 + (c10 - c00) * t[1];
+  float c1 = c01 + (c11 - c01) * t[1];
+
+  return c0 + (c1 - c0) * t[2];
+}
+
+}}
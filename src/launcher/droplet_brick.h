@@ -0,0 +1,65 @@
+#pragma once
+
+// Baked distance brick of one droplet: its metaball field (the smooth-min of the particle spheres that
+// droplet_fluid.glsl otherwise evaluates at every raymarch step) sampled on a resolution^3 grid over the
+// droplet's proxy box. The shader then marches the brick with one trilinear fetch per step instead of a
+// loop over all particles.
+//
+// Distances are clamped to a narrow band of a few voxels around the surface; outside it the march just
+// steps by the band. Each particle therefore only visits the voxels within its sphere + blend + band
+// (a splat), folded in particle order as the shader does. A particle farther away than that cannot move
+// the surface, so the brick matches the exact field near the surface up to the trilinear error.
+
+#include <cstddef>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+const size_t DROPLET_BRICK_MIN_RESOLUTION  = 8;
+const size_t DROPLET_BRICK_MAX_RESOLUTION  = 32;
+const size_t DROPLET_BRICK_RESOLUTION_STEP = 8;    // resolutions are multiples of it (fewer texture re-allocations)
+const float  DROPLET_BRICK_BAND_VOXELS     = 3.0f; // half-width of the stored distance band
+
+/// Field parameters (the raymarch uniforms of the same name)
+struct DropletBrickParams
+{
+  float influence = 0.0f; // smooth-min blend k
+  float iso       = 0.0f; // surface level
+};
+
+class DropletBrick
+{
+  public:
+    /// Resolution for a droplet whose proxy box spans screen_fraction of the view height
+    static size_t resolution_for(float screen_fraction, float voxels_per_screen);
+
+    /// Exact field at a point over count particles (x, y, z, radius each), as droplet_fluid.glsl's map()
+    static float field(const float* particles, size_t count, float x, float y, float z, const DropletBrickParams& params);
+
+    /// Sample the field of count particles (x, y, z, radius each) over the box centre +- half_extent.
+    /// Voxel (i, j, k) is sampled at its centre, like a texel of a 3D texture covering the box
+    void splat(const float* particles, size_t count, const float center[3], float half_extent, size_t resolution,
+               const DropletBrickParams& params);
+
+    /// Grid size along each axis (0 before the first splat)
+    size_t resolution() const { return grid_resolution; }
+
+    /// Distances are clamped to +-band (world units)
+    float band() const { return band_width; }
+
+    /// resolution^3 distances, x fastest, then y, then z (a 3D texture's layout)
+    const float* data() const { return distances.data(); }
+
+    /// Trilinear sample at a world position (clamped to the voxel centres), as the shader's fetch
+    float sample(float x, float y, float z) const;
+
+  private:
+    std::vector<float> distances;       // capacity kept: no reallocation once the largest brick was seen
+    size_t             grid_resolution = 0;
+    float              origin[3]       = {0.0f, 0.0f, 0.0f}; // box corner
+    float              voxel           = 0.0f;
+    float              band_width      = 0.0f;
+};
+
+}}
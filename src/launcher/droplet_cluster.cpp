@@ -0,0 +1,268 @@
+#include "droplet_cluster.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const size_t  MIN_BUCKETS_COUNT = 64;
+const size_t  HASH_MIN_CLUSTERS = 64;       // below this a linear scan of the centres beats probing 8 cells
+const int32_t CELL_BIAS         = 1 << 20;  // cells are packed as 3 x 21-bit unsigned fields
+const int32_t NO_CLUSTER        = -1;
+
+uint64_t pack_cell(int32_t x, int32_t y, int32_t z)
+{
+  return (uint64_t(uint32_t(x + CELL_BIAS) & 0x1fffff) << 42)
+       | (uint64_t(uint32_t(y + CELL_BIAS) & 0x1fffff) << 21)
+       |  uint64_t(uint32_t(z + CELL_BIAS) & 0x1fffff);
+}
+
+}
+
+void DropletClusterer::reset(float radius)
+{
+  inv_cell = radius > 1.0e-6f ? 0.5f / radius : 1.0e6f; // cell == 2 * radius (see assign)
+  radius2  = radius * radius;
+
+  clusters.clear();
+
+  hashed = false; // the grid is built once HASH_MIN_CLUSTERS clusters exist (see add_cluster)
+}
+
+uint64_t DropletClusterer::cell_of(const math::vec3f& p) const
+{
+  return pack_cell(int32_t(std::floor(p.x * inv_cell)), int32_t(std::floor(p.y * inv_cell)), int32_t(std::floor(p.z * inv_cell)));
+}
+
+size_t DropletClusterer::bucket_of(uint64_t cell) const
+{
+  cell ^= cell >> 29; cell *= 0xbf58476d1ce4e5b9ull; cell ^= cell >> 32;
+  return size_t(cell) & (buckets.size() - 1);
+}
+
+void DropletClusterer::link(size_t cluster)
+{
+  Cluster& c = clusters[cluster];
+  int32_t& head = buckets[bucket_of(c.cell)];
+
+  c.next = head;
+  head   = int32_t(cluster);
+}
+
+void DropletClusterer::unlink(size_t cluster)
+{
+  int32_t* link = &buckets[bucket_of(clusters[cluster].cell)];
+
+  while (*link != NO_CLUSTER && *link != int32_t(cluster))
+    link = &clusters[*link].next;
+
+  if (*link != NO_CLUSTER)
+    *link = clusters[cluster].next;
+}
+
+void DropletClusterer::rehash(size_t buckets_count)
+{
+  buckets.assign(buckets_count, NO_CLUSTER);
+
+  for (size_t i=0, count=clusters.size(); i<count; i++)
+  {
+    clusters[i].cell = cell_of(clusters[i].center);
+    link(i);
+  }
+}
+
+size_t DropletClusterer::add_cluster(const math::vec3f& center)
+{
+  Cluster c;
+
+  c.center = center;
+  c.sum    = math::vec3f(0.0f);
+  c.count  = 0;
+  c.cell   = 0;
+  c.next   = NO_CLUSTER;
+
+  clusters.push_back(c);
+
+  size_t index = clusters.size() - 1;
+
+  if (!hashed)
+  {
+    if (clusters.size() < HASH_MIN_CLUSTERS)
+      return index;
+
+    hashed = true;
+
+    size_t buckets_count = std::max(buckets.size(), MIN_BUCKETS_COUNT);
+
+    while (buckets_count < clusters.size() * 2)
+      buckets_count *= 2;
+
+    rehash(buckets_count);
+  }
+  else if (clusters.size() * 2 > buckets.size())
+  {
+    rehash(buckets.size() * 2);
+  }
+  else
+  {
+    clusters[index].cell = cell_of(center);
+    link(index);
+  }
+
+  return index;
+}
+
+int32_t DropletClusterer::find_linear(const math::vec3f& point) const
+{
+  for (size_t i=0, count=clusters.size(); i<count; i++)
+  {
+    math::vec3f d = clusters[i].center - point;
+
+    if (d.x * d.x + d.y * d.y + d.z * d.z < radius2)
+      return int32_t(i);
+  }
+
+  return NO_CLUSTER;
+}
+
+int32_t DropletClusterer::find_hashed(const math::vec3f& point) const
+{
+  //cells are 2*radius wide, so the radius ball around the point spans at most the point's own cell
+  //and the nearer neighbour along each axis -> 8 cells to probe
+
+  float   fx = point.x * inv_cell, fy = point.y * inv_cell, fz = point.z * inv_cell;
+  int32_t ix = int32_t(std::floor(fx)), iy = int32_t(std::floor(fy)), iz = int32_t(std::floor(fz));
+  int32_t sx = fx - ix < 0.5f ? -1 : 1, sy = fy - iy < 0.5f ? -1 : 1, sz = fz - iz < 0.5f ? -1 : 1;
+
+  int32_t best = NO_CLUSTER;
+
+  for (int32_t n=0; n<8; n++)
+  {
+    uint64_t cell = pack_cell(ix + (n & 1 ? sx : 0), iy + (n & 2 ? sy : 0), iz + (n & 4 ? sz : 0));
+
+    for (int32_t i=buckets[bucket_of(cell)]; i != NO_CLUSTER; i=clusters[i].next)
+    {
+      const Cluster& c = clusters[i];
+
+      if (c.cell != cell || (best != NO_CLUSTER && i > best))
+        continue;
+
+      math::vec3f d = c.center - point;
+
+      if (d.x * d.x + d.y * d.y + d.z * d.z < radius2)
+        best = i;
+    }
+  }
+
+  return best;
+}
+
+size_t DropletClusterer::assign(const math::vec3f& point)
+{
+    //the first (lowest index) cluster whose centre is within radius wins, as in the linear scan
+
+  int32_t best = hashed ? find_hashed(point) : find_linear(point);
+
+  if (best == NO_CLUSTER)
+  {
+    size_t index = add_cluster(point);
+    Cluster& c = clusters[index];
+
+    c.sum   = point;
+    c.count = 1;
+
+    return index;
+  }
+
+    //incremental centroid
+
+  Cluster& c = clusters[best];
+
+  c.sum   += point;
+  c.count += 1;
+  c.center = c.sum / float(c.count);
+
+  relink(size_t(best));
+
+  return size_t(best);
+}
+
+void DropletClusterer::relink(size_t cluster)
+{
+    //relink only when the centre crossed into another cell
+
+  if (!hashed)
+    return;
+
+  Cluster& c = clusters[cluster];
+
+  uint64_t cell = cell_of(c.center);
+
+  if (cell != c.cell)
+  {
+    unlink(cluster);
+    c.cell = cell;
+    link(cluster);
+  }
+}
+
+int32_t DropletClusterer::find_nearest(const math::vec3f& point) const
+{
+  int32_t best = NO_CLUSTER;
+  float   best_distance2 = radius2;
+
+  auto test = [&](int32_t i)
+  {
+    math::vec3f d  = clusters[i].center - point;
+    float       d2 = d.x * d.x + d.y * d.y + d.z * d.z;
+
+    if (d2 < best_distance2 || (d2 == best_distance2 && best != NO_CLUSTER && i < best))
+    {
+      best           = i;
+      best_distance2 = d2;
+    }
+  };
+
+  if (!hashed)
+  {
+    for (int32_t i=0, count=int32_t(clusters.size()); i<count; i++)
+      test(i);
+
+    return best;
+  }
+
+  float   fx = point.x * inv_cell, fy = point.y * inv_cell, fz = point.z * inv_cell;
+  int32_t ix = int32_t(std::floor(fx)), iy = int32_t(std::floor(fy)), iz = int32_t(std::floor(fz));
+  int32_t sx = fx - ix < 0.5f ? -1 : 1, sy = fy - iy < 0.5f ? -1 : 1, sz = fz - iz < 0.5f ? -1 : 1;
+
+  for (int32_t n=0; n<8; n++)
+  {
+    uint64_t cell = pack_cell(ix + (n & 1 ? sx : 0), iy + (n & 2 ? sy : 0), iz + (n & 4 ? sz : 0));
+
+    for (int32_t i=buckets[bucket_of(cell)]; i != NO_CLUSTER; i=clusters[i].next)
+      if (clusters[i].cell == cell)
+        test(i);
+  }
+
+  return best;
+}
+
+size_t DropletClusterer::nearest(const math::vec3f& point) const
+{
+  int32_t best = find_nearest(point);
+
+  return best == NO_CLUSTER ? NONE : size_t(best);
+}
+
+void DropletClusterer::move_cluster(size_t cluster, const math::vec3f& center)
+{
+  clusters[cluster].center = center;
+
+  relink(cluster);
+}
+
+}}
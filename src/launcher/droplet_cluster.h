@@ -0,0 +1,88 @@
+#pragma once
+
+// Spatial-hash clustering of droplet particles into droplets.
+//
+// Reproduces the greedy clustering World::update used to run with a linear scan: particles are
+// visited in order, each joins the FIRST cluster (lowest index) whose current centre lies within
+// `radius`, otherwise it opens a new cluster centred on itself; a cluster's centre is the mean of the
+// points that joined it so far (seed clusters keep their carried-over centre until the first join).
+//
+// Cluster centres live in a uniform hash grid with cells of `2 * radius`, so a point only tests the
+// centres in the 8 cells its radius ball can touch, and centres are kept incrementally (running sum / count)
+// instead of being re-summed over every point after each insertion. Per pass this is O(points)
+// instead of O(points * clusters + points^2). Below HASH_MIN_CLUSTERS clusters (the scene's 600-particle
+// budget makes a few dozen) the centres are scanned linearly instead, which is cheaper than probing 8 cells;
+// the grid is built when the pass reaches that many clusters. Buffers are reused across passes -> no
+// steady-state heap allocations once capacity has been reached.
+//
+// nearest() / move_cluster() serve hosts that keep their own centroids: DropletTracker indexes its droplet
+// centres here to find the droplet a particle that left its own joins.
+
+#include <math/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+class DropletClusterer
+{
+  public:
+    static const size_t NONE = size_t(-1);
+
+    /// Start a new clustering pass with the given join radius (seed clusters are dropped)
+    void reset(float radius);
+
+    /// Add a seed cluster carried over from the previous pass/frame; returns its index
+    size_t add_cluster(const math::vec3f& center);
+
+    /// Assign a point to the first cluster within radius (or a new one); returns the cluster index
+    size_t assign(const math::vec3f& point);
+
+    /// Nearest cluster whose centre lies within radius of the point (NONE if there is none); the lower
+    /// index wins a tie. For hosts that keep their own clusters and use this as the spatial index
+    size_t nearest(const math::vec3f& point) const;
+
+    /// Move a cluster's centre (the host's own centroid; points_count is not touched)
+    void move_cluster(size_t cluster, const math::vec3f& center);
+
+    /// Clusters count (seeds + clusters opened by assign)
+    size_t clusters_count() const { return clusters.size(); }
+
+    /// Cluster centre (mean of the assigned points, or the seed centre if nothing joined yet)
+    const math::vec3f& center(size_t cluster) const { return clusters[cluster].center; }
+
+    /// Number of points assigned to the cluster during this pass
+    size_t points_count(size_t cluster) const { return clusters[cluster].count; }
+
+  private:
+    struct Cluster
+    {
+      math::vec3f center;
+      math::vec3f sum;
+      size_t      count;
+      uint64_t    cell;   // packed grid cell of the current centre
+      int32_t     next;   // next cluster in the same hash bucket (-1 = end)
+    };
+
+    int32_t  find_linear(const math::vec3f& point) const;
+    int32_t  find_hashed(const math::vec3f& point) const;
+    int32_t  find_nearest(const math::vec3f& point) const;
+    void     relink(size_t cluster);
+    uint64_t cell_of(const math::vec3f& p) const;
+    size_t   bucket_of(uint64_t cell) const;
+    void     link(size_t cluster);
+    void     unlink(size_t cluster);
+    void     rehash(size_t buckets_count);
+
+  private:
+    float                inv_cell = 1.0f;
+    float                radius2  = 1.0f;
+    bool                 hashed   = false; // centres are linked into buckets (enough clusters for the grid to pay off)
+    std::vector<Cluster> clusters;
+    std::vector<int32_t> buckets;  // head cluster per bucket (-1 = empty); size is a power of two
+};
+
+}}
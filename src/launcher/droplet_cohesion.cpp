@@ -0,0 +1,255 @@
+#include "droplet_cohesion.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const size_t   CELL_LIST_MIN_PARTICLES = 128;            // below this all-pairs is cheaper than building the grid
+const float    MIN_PAIR_DISTANCE2      = 1.0e-10f;       // coincident particles exert nothing (no direction)
+const int32_t  CELL_BIAS               = 1 << 20;        // cells are packed as 3 x 21-bit unsigned fields
+const uint64_t NO_CELL                 = ~uint64_t(0);
+
+uint64_t pack_cell(int32_t x, int32_t y, int32_t z)
+{
+  return (uint64_t(uint32_t(x + CELL_BIAS) & 0x1fffff) << 42)
+       | (uint64_t(uint32_t(y + CELL_BIAS) & 0x1fffff) << 21)
+       |  uint64_t(uint32_t(z + CELL_BIAS) & 0x1fffff);
+}
+
+size_t hash_cell(uint64_t cell, size_t mask)
+{
+  cell ^= cell >> 29; cell *= 0xbf58476d1ce4e5b9ull; cell ^= cell >> 32;
+  return size_t(cell) & mask;
+}
+
+// Pair kernel of particle i against the contiguous run [first, last): returns the accumulated
+// acceleration of i and subtracts each pair's share from j. Branch-free (out-of-range pairs get
+// w = 0) and restrict-qualified so the compiler vectorizes it.
+void pair_kernel(const float* __restrict px, const float* __restrict py, const float* __restrict pz,
+                 const float* __restrict vx, const float* __restrict vy, const float* __restrict vz,
+                 float* __restrict ax, float* __restrict ay, float* __restrict az,
+                 size_t first, size_t last, const float pi[3], const float vi[3],
+                 float h2, float inv_h, float gamma, float visc, float ai[3])
+{
+  const float pix = pi[0], piy = pi[1], piz = pi[2];
+  const float vix = vi[0], viy = vi[1], viz = vi[2];
+
+  float aix = 0.0f, aiy = 0.0f, aiz = 0.0f;
+
+  for (size_t j=first; j<last; j++)
+  {
+    float dx = pix - px[j], dy = piy - py[j], dz = piz - pz[j];
+    float r2 = dx * dx + dy * dy + dz * dz;
+    float inside = r2 < h2 ? 1.0f : 0.0f;
+    inside = r2 >= MIN_PAIR_DISTANCE2 ? inside : 0.0f;
+    float r  = std::sqrt(std::max(r2, MIN_PAIR_DISTANCE2));
+    float x  = r * inv_h;                                  // 0..1
+    float w  = 4.0f * x * (1.0f - x) * inside;             // cohesion kernel: 0 at contact & at h, peak mid
+    float c  = -gamma * w / r;                             // cohesion along dir = d / r (pull i toward j)
+    float v  = visc * w;                                   // viscosity: match neighbour velocity
+
+    float jx = dx * c + (vx[j] - vix) * v,
+          jy = dy * c + (vy[j] - viy) * v,
+          jz = dz * c + (vz[j] - viz) * v;
+
+    aix += jx; aiy += jy; aiz += jz;
+    ax[j] -= jx; ay[j] -= jy; az[j] -= jz;                 // Newton's 3rd law (equal masses)
+  }
+
+  ai[0] = aix;
+  ai[1] = aiy;
+  ai[2] = aiz;
+}
+
+// Particle i against the run [first, last) of the same buffer (first > i, so j never aliases i)
+void accumulate_run(CohesionParticles& p, size_t i, size_t first, size_t last, float h2, float inv_h, float gamma, float visc)
+{
+  const float pi[3] = {p.px[i], p.py[i], p.pz[i]};
+  const float vi[3] = {p.vx[i], p.vy[i], p.vz[i]};
+  float       ai[3];
+
+  pair_kernel(p.px.data(), p.py.data(), p.pz.data(), p.vx.data(), p.vy.data(), p.vz.data(),
+              p.ax.data(), p.ay.data(), p.az.data(), first, last, pi, vi, h2, inv_h, gamma, visc, ai);
+
+  p.ax[i] += ai[0];
+  p.ay[i] += ai[1];
+  p.az[i] += ai[2];
+}
+
+}
+
+/*
+    CohesionParticles
+*/
+
+void CohesionParticles::resize(size_t count)
+{
+  px.resize(count); py.resize(count); pz.resize(count);
+  vx.resize(count); vy.resize(count); vz.resize(count);
+  ax.resize(count); ay.resize(count); az.resize(count);
+}
+
+/*
+    CohesionSolver
+*/
+
+void CohesionSolver::compute(CohesionParticles& particles, const CohesionParams& params)
+{
+  const size_t n = particles.size();
+
+  std::fill(particles.ax.begin(), particles.ax.end(), 0.0f);
+  std::fill(particles.ay.begin(), particles.ay.end(), 0.0f);
+  std::fill(particles.az.begin(), particles.az.end(), 0.0f);
+
+  if (n < 2 || params.radius <= 1.0e-4f)
+    return;
+
+  if (n < CELL_LIST_MIN_PARTICLES) compute_all_pairs(particles, params);
+  else                             compute_cell_list(particles, params);
+}
+
+void CohesionSolver::compute_all_pairs(CohesionParticles& p, const CohesionParams& params)
+{
+  const float h = params.radius, h2 = h * h, inv_h = 1.0f / h;
+
+  for (size_t i=0, n=p.size(); i<n; i++)
+    accumulate_run(p, i, i + 1, n, h2, inv_h, params.cohesion, params.viscosity);
+}
+
+void CohesionSolver::compute_cell_list(CohesionParticles& p, const CohesionParams& params)
+{
+  const size_t n = p.size();
+  const float  h = params.radius, h2 = h * h, inv_h = 1.0f / h;
+
+    //bucket particles by cell (cell == h -> every neighbour within h is in the 27 surrounding cells)
+
+  cells.resize(n);
+  order.resize(n);
+
+  for (size_t i=0; i<n; i++)
+  {
+    cells[i] = pack_cell(int32_t(std::floor(p.px[i] * inv_h)), int32_t(std::floor(p.py[i] * inv_h)), int32_t(std::floor(p.pz[i] * inv_h)));
+    order[i] = uint32_t(i);
+  }
+
+  std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return cells[a] < cells[b]; });
+
+    //reorder into cell order, so each cell is one contiguous run of the SoA arrays
+
+  sorted.resize(n);
+
+  for (size_t k=0; k<n; k++)
+  {
+    uint32_t i = order[k];
+
+    sorted.px[k] = p.px[i]; sorted.py[k] = p.py[i]; sorted.pz[k] = p.pz[i];
+    sorted.vx[k] = p.vx[i]; sorted.vy[k] = p.vy[i]; sorted.vz[k] = p.vz[i];
+    sorted.ax[k] = 0.0f;    sorted.ay[k] = 0.0f;    sorted.az[k] = 0.0f;
+  }
+
+    //cell -> run table (open addressing, load <= 1/2)
+
+  size_t table_size = 16;
+
+  while (table_size < n * 2)
+    table_size *= 2;
+
+  CellRange empty = {NO_CELL, 0, 0};
+
+  ranges.assign(table_size, empty);
+
+  const size_t mask = table_size - 1;
+
+  for (size_t first=0; first<n;)
+  {
+    uint64_t cell = cells[order[first]];
+    size_t   last = first + 1;
+
+    while (last < n && cells[order[last]] == cell)
+      last++;
+
+    size_t slot = hash_cell(cell, mask);
+
+    while (ranges[slot].cell != NO_CELL)
+      slot = (slot + 1) & mask;
+
+    ranges[slot].cell  = cell;
+    ranges[slot].first = uint32_t(first);
+    ranges[slot].last  = uint32_t(last);
+
+    first = last;
+  }
+
+    //walk the grid cell by cell: with z in the low bits of the sort key, the cells (x, y, z-1..z+1)
+    //are one contiguous run, so each cell gathers 9 neighbour column runs once and all its particles
+    //reuse them. Each pair once: particle k only takes neighbours that come after it in cell order.
+
+  for (size_t first=0; first<n;)
+  {
+    uint64_t cell = cells[order[first]];
+    size_t   last = first + 1;
+
+    while (last < n && cells[order[last]] == cell)
+      last++;
+
+    int32_t cx = int32_t(std::floor(sorted.px[first] * inv_h)),
+            cy = int32_t(std::floor(sorted.py[first] * inv_h)),
+            cz = int32_t(std::floor(sorted.pz[first] * inv_h));
+
+    uint32_t columns[9][2];
+    size_t   columns_count = 0;
+
+    for (int32_t dx=-1; dx<=1; dx++)
+      for (int32_t dy=-1; dy<=1; dy++)
+      {
+        uint32_t column_first = uint32_t(n), column_last = 0;
+
+        for (int32_t dz=-1; dz<=1; dz++)
+        {
+          uint64_t neighbour = pack_cell(cx + dx, cy + dy, cz + dz);
+          size_t   slot      = hash_cell(neighbour, mask);
+
+          while (ranges[slot].cell != NO_CELL && ranges[slot].cell != neighbour)
+            slot = (slot + 1) & mask;
+
+          if (ranges[slot].cell == NO_CELL)
+            continue;
+
+          column_first = std::min(column_first, ranges[slot].first);
+          column_last  = std::max(column_last, ranges[slot].last);
+        }
+
+        if (column_first < column_last && column_last > first + 1)
+        {
+          columns[columns_count][0] = column_first;
+          columns[columns_count][1] = column_last;
+          columns_count++;
+        }
+      }
+
+    for (size_t k=first; k<last; k++)
+      for (size_t c=0; c<columns_count; c++)
+        if (columns[c][1] > k + 1)
+          accumulate_run(sorted, k, std::max(size_t(columns[c][0]), k + 1), columns[c][1], h2, inv_h, params.cohesion, params.viscosity);
+
+    first = last;
+  }
+
+    //scatter back to the caller's order
+
+  for (size_t k=0; k<n; k++)
+  {
+    uint32_t i = order[k];
+
+    p.ax[i] = sorted.ax[k];
+    p.ay[i] = sorted.ay[k];
+    p.az[i] = sorted.az[k];
+  }
+}
+
+}}
@@ -0,0 +1,670 @@
+#include "droplet_pbf.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const float    PI                 = 3.14159265f;
+const float    MIN_PAIR_DISTANCE2 = 1.0e-10f;       // coincident particles exert nothing (no direction)
+const float    CONTACT_TOLERANCE  = 0.1f;           // of the particle radius: still touching a collider after the solve
+const float    SPACING_RELAXATION = 1.5f;           // over-relaxation of the averaged spacing corrections
+const size_t   NEIGHBOURS_RESERVE = 48;             // per particle, preallocated by reserve()
+const int32_t  CELL_BIAS          = 1 << 20;        // cells are packed as 3 x 21-bit unsigned fields
+const uint64_t NO_CELL            = ~uint64_t(0);
+
+uint64_t pack_cell(int32_t x, int32_t y, int32_t z)
+{
+  return (uint64_t(uint32_t(x + CELL_BIAS) & 0x1fffff) << 42)
+       | (uint64_t(uint32_t(y + CELL_BIAS) & 0x1fffff) << 21)
+       |  uint64_t(uint32_t(z + CELL_BIAS) & 0x1fffff);
+}
+
+size_t hash_cell(uint64_t cell, size_t mask)
+{
+  cell ^= cell >> 29; cell *= 0xbf58476d1ce4e5b9ull; cell ^= cell >> 32;
+  return size_t(cell) & mask;
+}
+
+// Density kernel (poly6) and the scalar part of the gradient kernel (spiky): grad W = spiky_gradient * d
+struct Kernels
+{
+  float h, h2, poly6, spiky;
+
+  explicit Kernels(float radius)
+    : h(radius)
+    , h2(radius * radius)
+    , poly6(315.0f / (64.0f * PI * std::pow(radius, 9.0f)))
+    , spiky(-45.0f / (PI * std::pow(radius, 6.0f)))
+  {}
+
+  float density(float r2) const
+  {
+    float t = std::max(h2 - r2, 0.0f);
+    return poly6 * t * t * t;
+  }
+
+  float gradient(float r2) const
+  {
+    float r = std::sqrt(std::max(r2, MIN_PAIR_DISTANCE2));
+    float t = std::max(h - r, 0.0f);
+    return r2 >= MIN_PAIR_DISTANCE2 ? spiky * t * t / r : 0.0f;
+  }
+};
+
+// Signed distance of p to a collider's surface, and the outward normal there
+float collider_distance(const PbfCollider& c, float x, float y, float z, float normal[3])
+{
+  const float d[3] = {x - c.center[0], y - c.center[1], z - c.center[2]};
+
+  float local[3], q[3];
+
+  for (int k=0; k<3; k++)
+  {
+    local[k] = d[0] * c.axes[k][0] + d[1] * c.axes[k][1] + d[2] * c.axes[k][2];
+    q[k]     = std::fabs(local[k]) - c.half_extent[k];
+  }
+
+  float outside[3] = {std::max(q[0], 0.0f), std::max(q[1], 0.0f), std::max(q[2], 0.0f)};
+  float outside_length = std::sqrt(outside[0] * outside[0] + outside[1] * outside[1] + outside[2] * outside[2]);
+  float n[3] = {0.0f, 0.0f, 0.0f};
+  float distance;
+
+  if (outside_length > 0.0f)
+  {
+    for (int k=0; k<3; k++)
+      n[k] = std::copysign(outside[k] / outside_length, local[k]);
+
+    distance = outside_length;
+  }
+  else
+  {
+    int axis = q[0] > q[1] ? (q[0] > q[2] ? 0 : 2) : (q[1] > q[2] ? 1 : 2);
+
+    n[axis]  = std::copysign(1.0f, local[axis]);
+    distance = q[axis];
+  }
+
+  for (int m=0; m<3; m++)
+    normal[m] = n[0] * c.axes[0][m] + n[1] * c.axes[1][m] + n[2] * c.axes[2][m];
+
+  return distance - c.rounding;
+}
+
+template <class T> void erase_front(std::vector<T>& v, size_t n)
+{
+  v.erase(v.begin(), v.begin() + n);
+}
+
+}
+
+/*
+    PbfSolver
+*/
+
+void PbfSolver::set_params(const PbfParams& params)
+{
+  solver_params = params;
+
+  const float r       = std::max(params.particle_radius, 1.0e-4f);
+  const float h       = std::max(params.smoothing_radius, 2.5f * r); // must reach past the first neighbour shell
+  const float spacing = 2.0f * r;
+
+  solver_params.smoothing_radius = h;
+
+    //rest state: a cubic lattice at one diameter spacing
+
+  Kernels kernels(h);
+
+  const int reach = int(std::ceil(h / spacing));
+
+  float density = 0.0f, gradient_norm = 0.0f;
+
+  for (int i=-reach; i<=reach; i++)
+    for (int j=-reach; j<=reach; j++)
+      for (int k=-reach; k<=reach; k++)
+      {
+        float x = i * spacing, y = j * spacing, z = k * spacing, r2 = x * x + y * y + z * z;
+
+        if (r2 >= kernels.h2)
+          continue;
+
+        density += kernels.density(r2);
+
+        float g = kernels.gradient(r2);
+
+        gradient_norm += g * g * r2;
+      }
+
+  rest_density = density;
+  self_density = kernels.density(0.0f);
+  softening    = params.relaxation * gradient_norm / (rest_density * rest_density);
+}
+
+void PbfSolver::reserve(size_t count)
+{
+  for (std::vector<float>* v : {&state.px, &state.py, &state.pz, &state.vx, &state.vy, &state.vz, &state.ox, &state.oy, &state.oz,
+                                &lambda, &dx, &dy, &dz})
+    v->reserve(count);
+
+  state.tag.reserve(count);
+  cells.reserve(count);
+  order.reserve(count);
+  neighbour_ranges.reserve(count * 2);
+  neighbours.reserve(count * NEIGHBOURS_RESERVE);
+  contacts.reserve(count * 2);
+
+  size_t table_size = 16;
+
+  while (table_size < count * 2)
+    table_size *= 2;
+
+  ranges.reserve(table_size);
+}
+
+void PbfSolver::add(float x, float y, float z, float vx, float vy, float vz)
+{
+  state.px.push_back(x);  state.py.push_back(y);  state.pz.push_back(z);
+  state.vx.push_back(vx); state.vy.push_back(vy); state.vz.push_back(vz);
+  state.ox.push_back(x);  state.oy.push_back(y);  state.oz.push_back(z);
+  state.tag.push_back(0);
+}
+
+size_t PbfSolver::retire_front(size_t n)
+{
+  n = std::min(n, size());
+
+  for (std::vector<float>* v : {&state.px, &state.py, &state.pz, &state.vx, &state.vy, &state.vz, &state.ox, &state.oy, &state.oz})
+    erase_front(*v, n);
+
+  erase_front(state.tag, n);
+
+  return n;
+}
+
+size_t PbfSolver::retire_below(float y)
+{
+  PbfParticles& p = state;
+
+  size_t kept = 0, n = size();
+
+  for (size_t i=0; i<n; i++)
+  {
+    if (p.py[i] < y)
+      continue;
+
+    p.px[kept] = p.px[i]; p.py[kept] = p.py[i]; p.pz[kept] = p.pz[i];
+    p.vx[kept] = p.vx[i]; p.vy[kept] = p.vy[i]; p.vz[kept] = p.vz[i];
+    p.ox[kept] = p.ox[i]; p.oy[kept] = p.oy[i]; p.oz[kept] = p.oz[i];
+    p.tag[kept] = p.tag[i];
+
+    kept++;
+  }
+
+  for (std::vector<float>* v : {&p.px, &p.py, &p.pz, &p.vx, &p.vy, &p.vz, &p.ox, &p.oy, &p.oz})
+    v->resize(kept);
+
+  p.tag.resize(kept);
+
+  return n - kept;
+}
+
+void PbfSolver::position_at(size_t i, float alpha, float out[3]) const
+{
+  out[0] = state.ox[i] + (state.px[i] - state.ox[i]) * alpha;
+  out[1] = state.oy[i] + (state.py[i] - state.oy[i]) * alpha;
+  out[2] = state.oz[i] + (state.pz[i] - state.oz[i]) * alpha;
+}
+
+void PbfSolver::step(float dt, PbfCollider* colliders, size_t colliders_count)
+{
+  for (size_t c=0; c<colliders_count; c++)
+    colliders[c].contacts = 0;
+
+  const size_t n = size();
+
+  if (!n || dt <= 0.0f)
+    return;
+
+  PbfParticles& p = state;
+
+    //predict
+
+  const float gravity_dt = solver_params.gravity * dt;
+
+  for (size_t i=0; i<n; i++)
+  {
+    p.ox[i] = p.px[i]; p.oy[i] = p.py[i]; p.oz[i] = p.pz[i];
+
+    p.vy[i] += gravity_dt;
+
+    p.px[i] += p.vx[i] * dt;
+    p.py[i] += p.vy[i] * dt;
+    p.pz[i] += p.vz[i] * dt;
+  }
+
+  lambda.resize(n);
+  dx.resize(n); dy.resize(n); dz.resize(n);
+
+  build_neighbours();
+  gather_contacts(colliders, colliders_count);
+
+    //project density + collision constraints
+
+  for (size_t it=0; it<solver_params.iterations; it++)
+  {
+    solve_density();
+    solve_spacing();
+    solve_collisions(colliders);
+  }
+
+  update_velocities(dt, colliders);
+  apply_cohesion(dt);
+}
+
+void PbfSolver::build_neighbours()
+{
+  const PbfParticles& p = state;
+
+  const size_t n     = p.size();
+  const float  h     = solver_params.smoothing_radius, h2 = h * h, inv_h = 1.0f / h;
+
+    //bucket particles by cell (cell == h -> every neighbour within h is in the 27 surrounding cells)
+
+  cells.resize(n);
+  order.resize(n);
+
+  for (size_t i=0; i<n; i++)
+  {
+    cells[i] = pack_cell(int32_t(std::floor(p.px[i] * inv_h)), int32_t(std::floor(p.py[i] * inv_h)), int32_t(std::floor(p.pz[i] * inv_h)));
+    order[i] = uint32_t(i);
+  }
+
+  std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return cells[a] < cells[b]; });
+
+    //cell -> run table (open addressing, load <= 1/2)
+
+  size_t table_size = 16;
+
+  while (table_size < n * 2)
+    table_size *= 2;
+
+  CellRange empty = {NO_CELL, 0, 0};
+
+  ranges.assign(table_size, empty);
+
+  const size_t mask = table_size - 1;
+
+  for (size_t first=0; first<n;)
+  {
+    uint64_t cell = cells[order[first]];
+    size_t   last = first + 1;
+
+    while (last < n && cells[order[last]] == cell)
+      last++;
+
+    size_t slot = hash_cell(cell, mask);
+
+    while (ranges[slot].cell != NO_CELL)
+      slot = (slot + 1) & mask;
+
+    ranges[slot].cell  = cell;
+    ranges[slot].first = uint32_t(first);
+    ranges[slot].last  = uint32_t(last);
+
+    first = last;
+  }
+
+    //cell by cell: with z in the low bits of the sort key, the cells (x, y, z-1..z+1) are one
+    //contiguous run, so each cell gathers 9 neighbour column runs once and all its particles reuse them
+
+  neighbour_ranges.resize(n * 2);
+  neighbours.clear();
+
+  for (size_t first=0; first<n;)
+  {
+    uint64_t cell = cells[order[first]];
+    size_t   last = first + 1;
+
+    while (last < n && cells[order[last]] == cell)
+      last++;
+
+    uint32_t i0 = order[first];
+    int32_t  cx = int32_t(std::floor(p.px[i0] * inv_h)),
+             cy = int32_t(std::floor(p.py[i0] * inv_h)),
+             cz = int32_t(std::floor(p.pz[i0] * inv_h));
+
+    uint32_t columns[9][2];
+    size_t   columns_count = 0;
+
+    for (int32_t ox=-1; ox<=1; ox++)
+      for (int32_t oy=-1; oy<=1; oy++)
+      {
+        uint32_t column_first = uint32_t(n), column_last = 0;
+
+        for (int32_t oz=-1; oz<=1; oz++)
+        {
+          uint64_t neighbour = pack_cell(cx + ox, cy + oy, cz + oz);
+          size_t   slot      = hash_cell(neighbour, mask);
+
+          while (ranges[slot].cell != NO_CELL && ranges[slot].cell != neighbour)
+            slot = (slot + 1) & mask;
+
+          if (ranges[slot].cell == NO_CELL)
+            continue;
+
+          column_first = std::min(column_first, ranges[slot].first);
+          column_last  = std::max(column_last, ranges[slot].last);
+        }
+
+        if (column_first < column_last)
+        {
+          columns[columns_count][0] = column_first;
+          columns[columns_count][1] = column_last;
+          columns_count++;
+        }
+      }
+
+    for (size_t k=first; k<last; k++)
+    {
+      uint32_t i = order[k];
+
+      neighbour_ranges[i * 2] = uint32_t(neighbours.size());
+
+      for (size_t c=0; c<columns_count; c++)
+        for (uint32_t m=columns[c][0]; m<columns[c][1]; m++)
+        {
+          uint32_t j = order[m];
+
+          float ddx = p.px[i] - p.px[j], ddy = p.py[i] - p.py[j], ddz = p.pz[i] - p.pz[j];
+
+          if (j != i && ddx * ddx + ddy * ddy + ddz * ddz < h2)
+            neighbours.push_back(j);
+        }
+
+      neighbour_ranges[i * 2 + 1] = uint32_t(neighbours.size());
+    }
+
+    first = last;
+  }
+}
+
+void PbfSolver::gather_contacts(const PbfCollider* colliders, size_t colliders_count)
+{
+  const PbfParticles& p = state;
+
+  const float margin = solver_params.particle_radius + solver_params.smoothing_radius; // room for the iterations to move a particle
+
+  contacts.clear();
+
+  for (size_t c=0; c<colliders_count; c++)
+  {
+    const PbfCollider& collider = colliders[c];
+
+    float extent[3];
+
+    for (int m=0; m<3; m++)
+    {
+      extent[m] = margin;
+
+      for (int k=0; k<3; k++)
+        extent[m] += std::fabs(collider.axes[k][m]) * (collider.half_extent[k] + collider.rounding);
+    }
+
+    for (size_t i=0, n=p.size(); i<n; i++)
+    {
+      if (std::fabs(p.px[i] - collider.center[0]) > extent[0] ||
+          std::fabs(p.py[i] - collider.center[1]) > extent[1] ||
+          std::fabs(p.pz[i] - collider.center[2]) > extent[2])
+        continue;
+
+      Contact contact = {uint32_t(i), uint32_t(c)};
+
+      contacts.push_back(contact);
+    }
+  }
+}
+
+void PbfSolver::solve_density()
+{
+  PbfParticles& p = state;
+
+  const size_t  n = p.size();
+  const Kernels kernels(solver_params.smoothing_radius);
+  const float   inv_rest = 1.0f / rest_density;
+
+    //lambda_i = -C_i / (sum_k |grad_k C_i|^2 + epsilon), compression only
+
+  for (size_t i=0; i<n; i++)
+  {
+    const uint32_t* first = neighbours.data() + neighbour_ranges[i * 2];
+    const uint32_t* last  = neighbours.data() + neighbour_ranges[i * 2 + 1];
+
+    float density = self_density, gx = 0.0f, gy = 0.0f, gz = 0.0f, gradient_norm = 0.0f;
+
+    for (const uint32_t* j=first; j!=last; j++)
+    {
+      float ddx = p.px[i] - p.px[*j], ddy = p.py[i] - p.py[*j], ddz = p.pz[i] - p.pz[*j];
+      float r2  = ddx * ddx + ddy * ddy + ddz * ddz;
+
+      density += kernels.density(r2);
+
+      float g = kernels.gradient(r2) * inv_rest;
+
+      gx += g * ddx; gy += g * ddy; gz += g * ddz;
+
+      gradient_norm += g * g * r2;
+    }
+
+    float constraint = density * inv_rest - 1.0f;
+
+    lambda[i] = constraint > 0.0f ? -constraint / (gx * gx + gy * gy + gz * gz + gradient_norm + softening) : 0.0f;
+  }
+
+    //delta p_i = sum_j (lambda_i + lambda_j) grad W_ij / rho0 (Jacobi: all from the same positions)
+
+  for (size_t i=0; i<n; i++)
+  {
+    const uint32_t* first = neighbours.data() + neighbour_ranges[i * 2];
+    const uint32_t* last  = neighbours.data() + neighbour_ranges[i * 2 + 1];
+
+    float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+
+    for (const uint32_t* j=first; j!=last; j++)
+    {
+      float ddx = p.px[i] - p.px[*j], ddy = p.py[i] - p.py[*j], ddz = p.pz[i] - p.pz[*j];
+      float s   = (lambda[i] + lambda[*j]) * kernels.gradient(ddx * ddx + ddy * ddy + ddz * ddz) * inv_rest;
+
+      sx += s * ddx; sy += s * ddy; sz += s * ddz;
+    }
+
+    dx[i] = sx; dy[i] = sy; dz[i] = sz;
+  }
+
+  for (size_t i=0; i<n; i++)
+  {
+    p.px[i] += dx[i];
+    p.py[i] += dy[i];
+    p.pz[i] += dz[i];
+  }
+}
+
+void PbfSolver::solve_spacing()
+{
+  PbfParticles& p = state;
+
+  const size_t n        = p.size();
+  const float  diameter = 2.0f * solver_params.particle_radius, diameter2 = diameter * diameter;
+
+    //every overlapping pair is pushed apart to one diameter, half each; each particle moves by the
+    //average of its corrections (over-relaxed), which keeps the Jacobi pass stable in dense piles
+
+  for (size_t i=0; i<n; i++)
+  {
+    const uint32_t* first = neighbours.data() + neighbour_ranges[i * 2];
+    const uint32_t* last  = neighbours.data() + neighbour_ranges[i * 2 + 1];
+
+    float sx = 0.0f, sy = 0.0f, sz = 0.0f, count = 0.0f;
+
+    for (const uint32_t* j=first; j!=last; j++)
+    {
+      float ddx = p.px[i] - p.px[*j], ddy = p.py[i] - p.py[*j], ddz = p.pz[i] - p.pz[*j];
+      float r2  = ddx * ddx + ddy * ddy + ddz * ddz;
+
+      if (r2 >= diameter2)
+        continue;
+
+      if (r2 < MIN_PAIR_DISTANCE2) // coincident: separate along x, the lower index to the left
+      {
+        ddx = i < *j ? -1.0f : 1.0f;
+        ddy = ddz = 0.0f;
+        r2  = 1.0f;
+      }
+
+      float r = std::sqrt(r2);
+      float s = 0.5f * (diameter - std::min(r, diameter)) / r;
+
+      sx += s * ddx; sy += s * ddy; sz += s * ddz;
+
+      count += 1.0f;
+    }
+
+    float k = count > 0.0f ? SPACING_RELAXATION / count : 0.0f;
+
+    dx[i] = sx * k; dy[i] = sy * k; dz[i] = sz * k;
+  }
+
+  for (size_t i=0; i<n; i++)
+  {
+    p.px[i] += dx[i];
+    p.py[i] += dy[i];
+    p.pz[i] += dz[i];
+  }
+}
+
+void PbfSolver::solve_collisions(const PbfCollider* colliders)
+{
+  PbfParticles& p = state;
+
+  const float radius = solver_params.particle_radius;
+
+  for (const Contact& contact : contacts)
+  {
+    const size_t i = contact.particle;
+
+    float normal[3];
+    float depth = collider_distance(colliders[contact.collider], p.px[i], p.py[i], p.pz[i], normal) - radius;
+
+    if (depth >= 0.0f)
+      continue;
+
+    p.px[i] -= normal[0] * depth;
+    p.py[i] -= normal[1] * depth;
+    p.pz[i] -= normal[2] * depth;
+  }
+}
+
+void PbfSolver::update_velocities(float dt, PbfCollider* colliders)
+{
+  PbfParticles& p = state;
+
+  const size_t n         = p.size();
+  const float  inv_dt    = 1.0f / dt;
+  const float  radius    = solver_params.particle_radius;
+  const float  tolerance = radius * CONTACT_TOLERANCE;
+
+  for (size_t i=0; i<n; i++)
+  {
+    p.vx[i] = (p.px[i] - p.ox[i]) * inv_dt;
+    p.vy[i] = (p.py[i] - p.oy[i]) * inv_dt;
+    p.vz[i] = (p.pz[i] - p.oz[i]) * inv_dt;
+  }
+
+    //collider response, relative to the body's velocity at the particle: no approach, tangential friction
+
+  for (const Contact& contact : contacts)
+  {
+    const size_t i        = contact.particle;
+    PbfCollider& collider = colliders[contact.collider];
+
+    float n3[3];
+
+    if (collider_distance(collider, p.px[i], p.py[i], p.pz[i], n3) - radius > tolerance)
+      continue;
+
+    collider.contacts++;
+
+    const float* w = collider.angular_velocity;
+    float r[3] = {p.px[i] - collider.center[0], p.py[i] - collider.center[1], p.pz[i] - collider.center[2]};
+    float u[3] = {collider.linear_velocity[0] + w[1] * r[2] - w[2] * r[1],
+                  collider.linear_velocity[1] + w[2] * r[0] - w[0] * r[2],
+                  collider.linear_velocity[2] + w[0] * r[1] - w[1] * r[0]};
+
+    float rel[3] = {p.vx[i] - u[0], p.vy[i] - u[1], p.vz[i] - u[2]};
+    float vn     = rel[0] * n3[0] + rel[1] * n3[1] + rel[2] * n3[2];
+    float keep   = 1.0f - std::min(std::max(collider.friction, 0.0f), 1.0f);
+    float normal = std::max(vn, 0.0f);
+
+    for (int m=0; m<3; m++)
+      rel[m] = (rel[m] - vn * n3[m]) * keep + normal * n3[m];
+
+    p.vx[i] = u[0] + rel[0];
+    p.vy[i] = u[1] + rel[1];
+    p.vz[i] = u[2] + rel[2];
+  }
+}
+
+void PbfSolver::apply_cohesion(float dt)
+{
+  PbfParticles& p = state;
+
+  const size_t n      = p.size();
+  const float  h      = solver_params.smoothing_radius, inv_h = 1.0f / h;
+  const float  gamma  = solver_params.cohesion, visc = solver_params.viscosity;
+  const float  max_v2 = solver_params.max_speed * solver_params.max_speed;
+
+    //the rigid-body path's pair kernel: w = 4x(1-x), x = r/h; cohesion along -d, viscosity on the relative velocity
+
+  for (size_t i=0; i<n; i++)
+  {
+    const uint32_t* first = neighbours.data() + neighbour_ranges[i * 2];
+    const uint32_t* last  = neighbours.data() + neighbour_ranges[i * 2 + 1];
+
+    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+
+    for (const uint32_t* j=first; j!=last; j++)
+    {
+      float ddx = p.px[i] - p.px[*j], ddy = p.py[i] - p.py[*j], ddz = p.pz[i] - p.pz[*j];
+      float r2  = ddx * ddx + ddy * ddy + ddz * ddz;
+      float inside = r2 < h * h && r2 >= MIN_PAIR_DISTANCE2 ? 1.0f : 0.0f;
+      float r   = std::sqrt(std::max(r2, MIN_PAIR_DISTANCE2));
+      float x   = r * inv_h;
+      float w   = 4.0f * x * (1.0f - x) * inside;
+      float c   = -gamma * w / r;
+      float v   = visc * w;
+
+      ax += ddx * c + (p.vx[*j] - p.vx[i]) * v;
+      ay += ddy * c + (p.vy[*j] - p.vy[i]) * v;
+      az += ddz * c + (p.vz[*j] - p.vz[i]) * v;
+    }
+
+    dx[i] = ax * dt; dy[i] = ay * dt; dz[i] = az * dt;
+  }
+
+  for (size_t i=0; i<n; i++)
+  {
+    float vx = p.vx[i] + dx[i], vy = p.vy[i] + dy[i], vz = p.vz[i] + dz[i];
+    float v2 = vx * vx + vy * vy + vz * vz;
+    float k  = v2 > max_v2 ? std::sqrt(max_v2 / v2) : 1.0f;
+
+    p.vx[i] = vx * k;
+    p.vy[i] = vy * k;
+    p.vz[i] = vz * k;
+  }
+}
+
+}}
@@ -0,0 +1,143 @@
+#pragma once
+
+// Position-based fluid solver for droplet particles (Macklin & Mueller 2013), on a structure-of-arrays
+// buffer. The alternative to one Bullet rigid-body sphere per particle: Bullet then only simulates the
+// leaves and bones, and the particles live here.
+//
+// Each step predicts positions under gravity, finds neighbours within the smoothing radius h on a cell
+// grid (cells of h, particles sorted by cell, 9 contiguous column runs per cell - the cohesion kernel's
+// layout), then runs a few Jacobi iterations of the density constraint C = rho / rho0 - 1. The constraint
+// is unilateral (only compression is corrected), so a droplet does not contract under negative pressure;
+// it holds together by the same pairwise cohesion + viscosity kernel as the rigid-body path (Akinci et
+// al. 2013), applied to the velocities once the positions are solved. rho0 is the density of particles
+// packed at one diameter apart, so the fluid rests at the spacing the Bullet spheres rest at. Thin films
+// (a droplet spread on a leaf) never reach rho0, so each iteration also pushes overlapping pairs apart to
+// one diameter - the spheres' contact, as a position constraint.
+//
+// Collisions are against a simplified SDF: oriented (optionally rounded) boxes supplied by the host each
+// step, with the velocity of the body they stand for. Particles are projected out of them inside every
+// iteration; afterwards the velocity relative to the body loses its inward normal part and is damped
+// tangentially by the collider's friction. The coupling is one-way: colliders are not pushed back.
+//
+// Particles are kept in insertion order (retire_front() removes the oldest ones). No Bullet, no GL here.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+/// Particle state as separate float arrays: positions, velocities and the positions one step ago
+/// (what the host interpolates from)
+struct PbfParticles
+{
+  std::vector<float> px, py, pz;
+  std::vector<float> vx, vy, vz;
+  std::vector<float> ox, oy, oz;
+  std::vector<uint32_t> tag; // host data carried with the particle (the droplet it was tracked into), not read by the solver
+
+  /// Particles count
+  size_t size() const { return px.size(); }
+};
+
+/// Solver parameters
+struct PbfParams
+{
+  float  particle_radius  = 0.027f; // collision radius; rest spacing is one diameter
+  float  smoothing_radius = 0.11f;  // kernel support h (neighbour range, also the cohesion range)
+  size_t iterations       = 3;      // density / collision iterations per step
+  float  relaxation       = 0.01f;  // constraint softening, relative to the rest lattice's gradient norm
+  float  gravity          = -15.0f; // along y
+  float  cohesion         = 1.0f;   // gamma, pairwise cohesion acceleration (as CohesionParams)
+  float  viscosity        = 1.0f;   // relative-velocity damping rate (as CohesionParams)
+  float  max_speed        = 20.0f;  // velocity clamp (keeps a bad frame from exploding)
+};
+
+/// Oriented box the particles collide with (world space); rounding turns it into a rounded box / capsule / sphere
+struct PbfCollider
+{
+  float    center[3];
+  float    axes[3][3];              // world directions of the box's local x, y, z axes (orthonormal)
+  float    half_extent[3];
+  float    rounding = 0.0f;
+  float    linear_velocity[3];      // of the body, at center
+  float    angular_velocity[3];
+  float    friction = 0.5f;         // 0 slides freely, 1 sticks
+  uint32_t contacts = 0;            // out: particles touching it after the last step
+};
+
+class PbfSolver
+{
+  public:
+    PbfSolver() { set_params(PbfParams()); }
+
+    /// Parameters (rest density and softening are derived from them)
+    void             set_params(const PbfParams& params);
+    const PbfParams& params() const { return solver_params; }
+
+    /// Preallocate every buffer for count particles (no allocation in step/add below it)
+    void reserve(size_t count);
+
+    /// Add a particle
+    void add(float x, float y, float z, float vx, float vy, float vz);
+
+    /// Remove the n oldest particles / every particle below height y; return how many were removed
+    size_t retire_front(size_t n);
+    size_t retire_below(float y);
+    void   clear() { retire_front(size()); }
+
+    /// Advance by dt against colliders (their contacts are overwritten)
+    void step(float dt, PbfCollider* colliders, size_t colliders_count);
+
+    /// State
+    size_t              size() const { return state.size(); }
+    const PbfParticles& particles() const { return state; }
+
+    /// Host tag of particle i (0 when added)
+    void set_tag(size_t i, uint32_t tag) { state.tag[i] = tag; }
+
+    /// Position between the previous step (alpha 0) and the current one (alpha 1)
+    void position_at(size_t i, float alpha, float out[3]) const;
+
+    /// Average neighbours per particle in the last step
+    float average_neighbours() const { return state.size() ? float(neighbours.size()) / float(state.size()) : 0.0f; }
+
+  private:
+    void build_neighbours();
+    void gather_contacts(const PbfCollider* colliders, size_t colliders_count);
+    void solve_density();
+    void solve_spacing();
+    void solve_collisions(const PbfCollider* colliders);
+    void update_velocities(float dt, PbfCollider* colliders);
+    void apply_cohesion(float dt);
+
+  private:
+    struct CellRange
+    {
+      uint64_t cell;
+      uint32_t first, last; // [first, last) in cell order
+    };
+
+    struct Contact
+    {
+      uint32_t particle;
+      uint32_t collider;
+    };
+
+    PbfParams              solver_params;
+    float                  rest_density  = 1.0f;
+    float                  softening     = 0.0f;  // epsilon of the lambda denominator
+    float                  self_density  = 0.0f;  // W(0)
+    PbfParticles           state;
+    std::vector<uint64_t>  cells;            // packed cell per particle
+    std::vector<uint32_t>  order;            // particle indices sorted by cell
+    std::vector<CellRange> ranges;           // open-addressed cell table, size is a power of two
+    std::vector<uint32_t>  neighbour_ranges; // 2 per particle: [first, last) of its run in neighbours
+    std::vector<uint32_t>  neighbours;       // indices of the particles within h, one run per particle
+    std::vector<float>     lambda;
+    std::vector<float>     dx, dy, dz;       // per-iteration displacement / velocity change scratch
+    std::vector<Contact>   contacts;         // (particle, collider) candidates of this step
+};
+
+}}
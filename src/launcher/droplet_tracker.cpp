@@ -0,0 +1,346 @@
+#include "droplet_tracker.h"
+
+#include <algorithm>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const size_t MAX_FORWARD_HOPS = 64; // merge chains are at most a few droplets long
+
+float distance2(const math::vec3f& a, const math::vec3f& b)
+{
+  math::vec3f d = a - b;
+
+  return d.x * d.x + d.y * d.y + d.z * d.z;
+}
+
+}
+
+const uint32_t DropletTracker::NONE;             // defined for uses that bind a reference (std::vector's fill value)
+const size_t   DropletTracker::SMOOTHING_FRAMES;
+
+void DropletTracker::begin()
+{
+  for (uint32_t slot : live)
+  {
+    Slot& s = slots[slot];
+
+    s.sum                = math::vec3f(0.0f);
+    s.droplet.particles  = 0;
+    s.opened             = false;
+    s.split_from         = NONE;
+  }
+
+  frame_events.clear();
+
+  reassigned    = 0;
+  centers_built = false;
+}
+
+void DropletTracker::build_centers()
+{
+    //the droplets live at the frame's first reassignment; open() adds the later ones
+
+  centers.reset(tracker_params.radius);
+  center_slots.clear();
+
+  for (uint32_t slot : live)
+  {
+    Slot& s = slots[slot];
+
+    s.cluster = centers.add_cluster(s.opened ? s.sum / float(s.droplet.particles) : s.droplet.raw_center);
+
+    center_slots.push_back(slot);
+  }
+
+  centers_built = true;
+}
+
+void DropletTracker::join(Slot& s, const math::vec3f& position)
+{
+  s.sum += position;
+  s.droplet.particles++;
+
+    //an opened droplet's centre is the mean of its particles so far; the others keep last frame's
+
+  if (s.opened && centers_built)
+    centers.move_cluster(s.cluster, s.sum / float(s.droplet.particles));
+}
+
+DropletTracker::Slot* DropletTracker::live_slot(uint32_t id)
+{
+  id = resolve(id);
+
+  return id == NONE ? nullptr : &slots[slot_of(id)];
+}
+
+uint32_t DropletTracker::resolve(uint32_t label) const
+{
+  for (size_t hop=0; label != NONE && hop<MAX_FORWARD_HOPS; hop++)
+  {
+    uint32_t slot = slot_of(label);
+
+    if (slot >= slots.size())
+      return NONE;
+
+    const Slot& s = slots[slot];
+
+    if (s.droplet.id != label)
+      return NONE; // released (the slot may hold a newer droplet)
+
+    switch (s.state)
+    {
+      case SlotState::live:      return label;
+      case SlotState::forwarded: label = s.forward; break;
+      default:                   return NONE;
+    }
+  }
+
+  return NONE;
+}
+
+uint32_t DropletTracker::track(const math::vec3f& position, uint32_t label)
+{
+  const float radius = tracker_params.radius;
+
+  Slot* own = live_slot(label);
+
+    //still near its droplet: keep it (the common case)
+
+  if (own && !own->opened)
+  {
+    float keep = radius * tracker_params.keep_factor;
+
+    if (distance2(position, own->droplet.raw_center) <= keep * keep)
+    {
+      own->sum += position;
+      own->droplet.particles++;
+
+      return own->droplet.id;
+    }
+  }
+
+    //left it (or new): nearest droplet within radius, else a new droplet
+
+  reassigned++;
+
+  if (!centers_built)
+    build_centers();
+
+  size_t cluster = centers.nearest(position);
+
+  if (cluster == DropletClusterer::NONE)
+    return open(position, own ? own->droplet.id : NONE);
+
+  Slot& best = slots[center_slots[cluster]];
+
+  join(best, position);
+
+  return best.droplet.id;
+}
+
+uint32_t DropletTracker::open(const math::vec3f& position, uint32_t split_from)
+{
+  uint32_t slot;
+
+  if (free_slots.empty())
+  {
+    slot = uint32_t(slots.size());
+    slots.emplace_back();
+  }
+  else
+  {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  }
+
+  Slot& s = slots[slot];
+
+  s.generation = s.generation % MAX_GENERATION + 1; // ids are never 0 nor NONE
+
+  s.state                = SlotState::live;
+  s.forward              = NONE;
+  s.droplet.id           = (s.generation << SLOT_BITS) | slot;
+  s.droplet.center       = position;
+  s.droplet.raw_center   = position;
+  s.droplet.particles    = 1;
+  s.droplet.visible      = false;
+  s.sum                  = position;
+  s.split_from           = split_from;
+  s.opened               = true;
+  s.small_frames         = 0;
+  s.history_count        = 0;
+  s.history_next         = 0;
+
+  live.push_back(slot);
+
+  if (centers_built)
+  {
+    s.cluster = centers.add_cluster(position);
+    center_slots.push_back(slot);
+  }
+
+  frame_events.push_back({split_from == NONE ? DropletEventType::created : DropletEventType::split, s.droplet.id, split_from});
+
+  return s.droplet.id;
+}
+
+void DropletTracker::merge(uint32_t from_slot, uint32_t into_slot)
+{
+  Slot& from = slots[from_slot];
+  Slot& into = slots[into_slot];
+
+  into.sum               += from.sum;
+  into.droplet.particles += from.droplet.particles;
+
+  if (into.droplet.particles)
+    into.droplet.raw_center = into.sum / float(into.droplet.particles);
+
+  from.state   = SlotState::forwarded;
+  from.forward = into.droplet.id;
+
+  live.erase(std::find(live.begin(), live.end(), from_slot));
+  forwarded.push_back(from_slot);
+
+  frame_events.push_back({DropletEventType::merged, from.droplet.id, into.droplet.id});
+}
+
+void DropletTracker::merge_within(float radius, bool visible_only)
+{
+  const float  radius2  = radius * radius;
+  const size_t min_size = visible_only ? tracker_params.min_particles : 0;
+
+  for (size_t i=0; i<live.size(); i++)
+  {
+    for (size_t j=i+1; j<live.size();)
+    {
+      Slot &a = slots[live[i]], &b = slots[live[j]];
+
+      if (a.droplet.particles < min_size || b.droplet.particles < min_size
+       || distance2(a.droplet.raw_center, b.droplet.raw_center) >= radius2)
+      {
+        j++;
+        continue;
+      }
+
+        //the smaller joins the larger (the older on a tie); restart the scan of i's partners
+
+      if (b.droplet.particles > a.droplet.particles) merge(live[i], live[j]);
+      else                                           merge(live[j], live[i]);
+
+      j = i + 1;
+
+      if (visible_only)
+      {
+        size_t visible = 0;
+
+        for (uint32_t slot : live)
+          if (slots[slot].droplet.particles >= tracker_params.min_particles)
+            visible++;
+
+        if (visible <= tracker_params.preferred_max)
+          return;
+      }
+    }
+  }
+}
+
+void DropletTracker::hold(uint32_t label, size_t particles)
+{
+  Slot* s = live_slot(label);
+
+  if (!s || !particles)
+    return;
+
+  s->sum               += s->droplet.raw_center * float(particles);
+  s->droplet.particles += particles;
+
+  if (s->opened && centers_built)
+    centers.move_cluster(s->cluster, s->sum / float(s->droplet.particles));
+}
+
+void DropletTracker::release(uint32_t slot)
+{
+  Slot& s = slots[slot];
+
+  s.state   = SlotState::free;
+  s.forward = NONE;
+
+  free_slots.push_back(slot);
+}
+
+void DropletTracker::end()
+{
+    //droplets merged in the previous frame: every label has been re-tracked since
+
+  for (uint32_t slot : forwarded)
+    release(slot);
+
+  forwarded.clear();
+
+    //raw centres, then merges
+
+  for (uint32_t slot : live)
+  {
+    Slot& s = slots[slot];
+
+    if (s.droplet.particles)
+      s.droplet.raw_center = s.sum / float(s.droplet.particles);
+  }
+
+  merge_within(tracker_params.radius, false);
+
+  float merge_radius = tracker_params.radius;
+
+  for (size_t step=0; step<tracker_params.merge_steps; step++)
+  {
+    size_t visible = 0;
+
+    for (uint32_t slot : live)
+      if (slots[slot].droplet.particles >= tracker_params.min_particles)
+        visible++;
+
+    if (visible <= tracker_params.preferred_max)
+      break;
+
+    merge_radius *= tracker_params.merge_step_factor;
+
+    merge_within(merge_radius, true);
+  }
+
+    //smoothed centres, visibility, removal
+
+  for (size_t i=0; i<live.size();)
+  {
+    Slot& s = slots[live[i]];
+
+    s.history[s.history_next] = s.droplet.raw_center;
+    s.history_next            = (s.history_next + 1) % SMOOTHING_FRAMES;
+    s.history_count           = std::min(s.history_count + 1, SMOOTHING_FRAMES);
+
+    math::vec3f center(0.0f);
+
+    for (size_t k=0; k<s.history_count; k++)
+      center += s.history[k];
+
+    s.droplet.center  = center / float(s.history_count);
+    s.droplet.visible = s.droplet.particles >= tracker_params.min_particles;
+    s.small_frames    = s.droplet.visible ? 0 : s.small_frames + 1;
+
+    if (s.small_frames <= tracker_params.remove_frames)
+    {
+      i++;
+      continue;
+    }
+
+    frame_events.push_back({DropletEventType::removed, s.droplet.id, NONE});
+
+    release(live[i]);
+    live.erase(live.begin() + i);
+  }
+}
+
+}}
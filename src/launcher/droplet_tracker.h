@@ -0,0 +1,162 @@
+#pragma once
+
+// Incremental tracking of droplet particles into droplets with stable identities.
+//
+// Each particle carries the id of the droplet it belonged to last frame (a label the host stores with
+// the particle). A tracked particle keeps its droplet while it stays within keep_factor * radius of
+// the droplet's last centre (hysteresis), so most particles cost one distance test per frame and are
+// never re-clustered. Only the particles that left their droplet (and new particles) look for the
+// nearest droplet within radius, through a DropletClusterer index of the droplet centres built at the
+// frame's first such lookup, or open a new one; a new droplet opened by particles that left a live
+// one is reported as a split of it. After the particles, droplets whose centres come within radius are
+// merged (the smaller into the larger), and while more than preferred_max droplets are visible the
+// merge radius widens step by step, as the old re-clustering passes did. Droplets that stay below
+// min_particles for remove_frames frames are removed.
+//
+// A droplet id is a handle: its low bits are the droplet's slot, which stays fixed for the droplet's
+// lifetime and is reused after it, so the renderer can keep per-slot GPU state and update it in place.
+// Ids are never 0, so a zero-initialised label reads as "no droplet" like NONE.
+// The centre is smoothed over the last SMOOTHING_FRAMES raw centres in a fixed ring buffer.
+//
+// A frame: begin(), track() for every particle (in any order), end(), then resolve() every stored
+// label (merges forward the absorbed droplet's id to the survivor). No Bullet, no GL here.
+
+#include "droplet_cluster.h"
+
+#include <math/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+/// Tracking parameters
+struct DropletTrackerParams
+{
+  float  radius            = 0.54f; // join radius (a particle joins the nearest droplet centre within it)
+  float  keep_factor       = 1.5f;  // a particle stays in its droplet while within keep_factor * radius of its centre
+  size_t min_particles     = 10;    // smaller droplets are not visible and count towards removal
+  size_t remove_frames     = 30;    // frames a droplet may stay below min_particles
+  size_t preferred_max     = 3;     // merge the closest visible droplets while there are more...
+  size_t merge_steps       = 3;     // ...widening the merge radius this many times...
+  float  merge_step_factor = 1.2f;  // ...by this factor per step
+};
+
+/// Droplet lifetime events of the last frame
+enum class DropletEventType
+{
+  created, // opened by particles that belonged to no droplet
+  split,   // opened by particles that left `other`
+  merged,  // absorbed into `other` (its particles' labels resolve to `other`)
+  removed, // below min_particles for too long
+};
+
+struct DropletEvent
+{
+  DropletEventType type;
+  uint32_t         droplet;
+  uint32_t         other;
+};
+
+/// A tracked droplet
+struct TrackedDroplet
+{
+  uint32_t    id;
+  math::vec3f center;         // smoothed
+  math::vec3f raw_center;     // mean of this frame's particles (the last one while empty)
+  size_t      particles = 0;  // this frame
+  bool        visible = false;
+};
+
+class DropletTracker
+{
+  public:
+    static const uint32_t NONE = 0xffffffffu;
+    static const size_t   SMOOTHING_FRAMES = 3;
+
+    /// Parameters
+    void                        set_params(const DropletTrackerParams& params) { tracker_params = params; }
+    const DropletTrackerParams& params() const { return tracker_params; }
+
+    /// Start a frame (clears the events)
+    void begin();
+
+    /// Track a particle at position labelled with its last droplet (or NONE); returns its new label
+    uint32_t track(const math::vec3f& position, uint32_t label);
+
+    /// Count particles of a droplet without tracking them (at rest: they keep their label and sit at its
+    /// last centre); call between begin() and end()
+    void hold(uint32_t label, size_t particles);
+
+    /// Finish the frame: centres, merges, removals
+    void end();
+
+    /// Label of a live droplet after merges (NONE if the droplet is gone)
+    uint32_t resolve(uint32_t label) const;
+
+    /// Live droplets, oldest first
+    size_t                droplets_count() const { return live.size(); }
+    const TrackedDroplet& droplet(size_t index) const { return slots[live[index]].droplet; }
+
+    /// Slot of a droplet id (stable while the droplet lives; at most the peak live count)
+    static uint32_t slot_of(uint32_t id) { return id & SLOT_MASK; }
+    size_t          slots_count() const { return slots.size(); }
+
+    /// Events of the last frame
+    const std::vector<DropletEvent>& events() const { return frame_events; }
+
+    /// Particles that looked for a droplet in the last frame (left theirs or were new)
+    size_t reassigned_count() const { return reassigned; }
+
+  private:
+    static const uint32_t SLOT_BITS = 16;
+    static const uint32_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+    static const uint32_t MAX_GENERATION = (1u << (32 - SLOT_BITS)) - 2;
+
+    enum class SlotState : uint8_t
+    {
+      free,
+      live,
+      forwarded, // merged last end(); labels forward to `forward` until the next end()
+    };
+
+    struct Slot
+    {
+      TrackedDroplet droplet;
+      SlotState      state = SlotState::free;
+      uint32_t       generation = 0;
+      uint32_t       forward = NONE;
+      math::vec3f    sum;                // of this frame's particles
+      uint32_t       split_from = NONE;  // droplet the opening particle left (new droplets only)
+      bool           opened = false;     // opened this frame
+      size_t         small_frames = 0;
+      math::vec3f    history[SMOOTHING_FRAMES];
+      size_t         history_count = 0;
+      size_t         history_next = 0;
+      size_t         cluster = 0;        // index in `centers` (valid while centers_built)
+    };
+
+    Slot*    live_slot(uint32_t id);
+    void     build_centers();
+    void     join(Slot& slot, const math::vec3f& position);
+    uint32_t open(const math::vec3f& position, uint32_t split_from);
+    void     merge(uint32_t from_slot, uint32_t into_slot);
+    void     merge_within(float radius, bool visible_only);
+    void     release(uint32_t slot);
+
+  private:
+    DropletTrackerParams      tracker_params;
+    std::vector<Slot>         slots;
+    std::vector<uint32_t>     free_slots;
+    std::vector<uint32_t>     live;       // slots of the live droplets, oldest first
+    std::vector<uint32_t>     forwarded;  // slots to free at the next end()
+    std::vector<DropletEvent> frame_events;
+    size_t                    reassigned = 0;
+    DropletClusterer          centers;                // spatial index of the live droplets' centres this frame
+    std::vector<uint32_t>     center_slots;           // slot per `centers` cluster
+    bool                      centers_built = false;
+};
+
+}}
@@ -0,0 +1,187 @@
+#include "live_tuning.h"
+
+#include <common/exception.h>
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+namespace engine {
+namespace launcher {
+
+using common::Exception;
+
+TuningRegistry::TuningRegistry(const TuningParameter* parameters, size_t count)
+  : parameters(parameters)
+{
+  engine_check_null(parameters);
+  engine_check(count <= TUNING_MAX_PARAMETERS);
+
+  block.count = uint32_t(count);
+
+  for (size_t i=0; i<count; i++)
+    block.values[i] = parameters[i].default_value;
+
+  block.version = 1;
+
+#ifdef __EMSCRIPTEN__
+    //publish the block: window.TUNING.set(name, value) writes a value and bumps the version
+
+  EM_ASM({
+    var tuning = window.TUNING = { index: {}, version: $0, values: $1 };
+
+    tuning.set = function (name, value) {
+      var i = tuning.index[name];
+
+      if (i == null)
+        return;
+
+      HEAPF32[(tuning.values >> 2) + i] = value;
+      HEAPU32[tuning.version >> 2]++;
+    };
+  }, &block.version, &block.values[0]);
+
+    //index the names; a value the page set before the world existed wins over the default
+
+  for (size_t i=0; i<count; i++)
+  {
+    EM_ASM({
+      var name  = UTF8ToString($0);
+      var dot   = name.indexOf('.');
+      var group = window[name.substring(0, dot)];
+      var value = group ? group[name.substring(dot + 1)] : null;
+
+      window.TUNING.index[name] = $1;
+
+      if (value != null)
+        window.TUNING.set(name, value);
+    }, parameters[i].name, int(i));
+  }
+#endif
+}
+
+TuningRegistry::~TuningRegistry()
+{
+#ifdef __EMSCRIPTEN__
+  EM_ASM({ window.TUNING = null; }); // the block goes away with the registry
+#endif
+}
+
+const TuningParameter& TuningRegistry::parameter(size_t index) const
+{
+  engine_check_range(index, size_t(block.count));
+
+  return parameters[index];
+}
+
+int TuningRegistry::find(const char* name) const
+{
+  engine_check_null(name);
+
+  for (size_t i=0; i<block.count; i++)
+    if (!strcmp(parameters[i].name, name))
+      return int(i);
+
+  return -1;
+}
+
+float TuningRegistry::value(size_t index) const
+{
+  const TuningParameter& p = parameter(index);
+  float                  v = block.values[index];
+
+  return v < p.min ? p.min : v > p.max ? p.max : v;
+}
+
+void TuningRegistry::set(size_t index, float value)
+{
+  const TuningParameter& p = parameter(index);
+
+  block.values[index] = value < p.min ? p.min : value > p.max ? p.max : value;
+
+  block.version++;
+}
+
+bool TuningRegistry::assign(const char* assignment)
+{
+  engine_check_null(assignment);
+
+  const char* equals = strchr(assignment, '=');
+
+  if (!equals)
+    return false;
+
+    //trim the name and parse the value
+
+  const char* name_begin = assignment;
+  const char* name_end   = equals;
+
+  while (name_begin < name_end && isspace((unsigned char) *name_begin)) name_begin++;
+  while (name_end > name_begin && isspace((unsigned char) name_end[-1])) name_end--;
+
+  int index = find(std::string(name_begin, name_end).c_str());
+
+  if (index < 0)
+    return false;
+
+  char* value_end = nullptr;
+  float value     = strtof(equals + 1, &value_end);
+
+  if (value_end == equals + 1)
+    return false;
+
+  while (isspace((unsigned char) *value_end))
+    value_end++;
+
+  if (*value_end)
+    return false;
+
+  set(size_t(index), value);
+
+  return true;
+}
+
+void TuningRegistry::load_file(const char* path)
+{
+  engine_check_null(path);
+
+  FILE* file = fopen(path, "r");
+
+  if (!file)
+    throw Exception::format("Can't open tuning file '%s'", path);
+
+  char   line[256];
+  size_t line_number = 0;
+
+  while (fgets(line, sizeof line, file))
+  {
+    line_number++;
+
+    if (char* comment = strchr(line, '#'))
+      *comment = '\0';
+
+    const char* text = line;
+
+    while (isspace((unsigned char) *text))
+      text++;
+
+    if (!*text)
+      continue;
+
+    if (!assign(text))
+    {
+      fclose(file);
+      throw Exception::format("Bad tuning assignment at %s:%u", path, unsigned(line_number));
+    }
+  }
+
+  fclose(file);
+}
+
+}}
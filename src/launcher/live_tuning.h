@@ -0,0 +1,74 @@
+#pragma once
+
+// Registry of the world's live-tunable parameters. Each parameter is declared once (name, range,
+// default), and all values live in one flat block of linear memory. On the web the registry publishes
+// the block to the page as window.TUNING, and the page's sliders write into it directly and bump its
+// version: no JS call per parameter and frame. The reader re-derives whatever depends on the values
+// only when the version moved. Natively the same registry takes "name=value" assignments from the
+// command line or a file, so benchmarks can sweep parameters.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine {
+namespace launcher {
+
+const size_t TUNING_MAX_PARAMETERS = 32;
+
+/// Live-tunable parameter. name is "GROUP.key": the page's window.GROUP.key slider
+struct TuningParameter
+{
+  const char* name;
+  float       min;
+  float       max;
+  float       default_value;
+};
+
+/// Values as the page sees them: version, count, then count floats (window.TUNING.set writes them)
+struct TuningBlock
+{
+  uint32_t version = 0;                       // bumped after every write
+  uint32_t count   = 0;
+  float    values[TUNING_MAX_PARAMETERS] = {};
+};
+
+class TuningRegistry
+{
+  public:
+    /// Declare the parameters (the array must outlive the registry). Values start at their defaults;
+    /// on the web the page's current values override them and the block is published as window.TUNING
+    TuningRegistry(const TuningParameter* parameters, size_t count);
+    ~TuningRegistry();
+
+    TuningRegistry(const TuningRegistry&) = delete;
+    TuningRegistry& operator = (const TuningRegistry&) = delete;
+
+    /// Parameters
+    size_t                 count() const { return block.count; }
+    const TuningParameter& parameter(size_t index) const;
+
+    /// Index of a parameter by name; -1 if there is none
+    int find(const char* name) const;
+
+    /// Value clamped to the parameter's range (the page writes unchecked)
+    float value(size_t index) const;
+
+    /// Set a value (clamped) and bump the version
+    void set(size_t index, float value);
+
+    /// Changes with every write, from either side
+    uint32_t version() const { return block.version; }
+
+    /// Apply "name=value"; false for an unknown name or a malformed assignment
+    bool assign(const char* assignment);
+
+    /// Apply a file of assignments, one per line; '#' starts a comment. Throws if the file cannot be
+    /// read or a line is not a valid assignment
+    void load_file(const char* path);
+
+  private:
+    const TuningParameter* parameters;
+    TuningBlock            block;
+};
+
+}}
@@ -7,6 +7,7 @@
 #include <common/exception.h>
 #include <common/log.h>
 #include <common/component.h>
+#include <common/profiler.h>
 #include <math/utility.h>
 
 #include "shared.h"
@@ -64,6 +65,41 @@ float crand(float min=-1.0f, float max=1.0f)
 
 }
 
+#ifdef ENGINE_PROFILER
+namespace
+{
+
+/// Log the profiler statistics and save the trace (browser: download it)
+void save_profile()
+{
+  profiler::log_stats();
+
+  std::string trace = profiler::chrome_trace();
+
+#ifdef __EMSCRIPTEN__
+  EM_ASM({
+    var blob = new Blob([UTF8ToString($0, $1)], {type: "application/json"});
+    var link = document.createElement("a");
+
+    link.href = URL.createObjectURL(blob);
+    link.download = "frame_trace.json";
+    link.click();
+    URL.revokeObjectURL(link.href);
+  }, trace.c_str(), trace.size());
+#else
+  if (FILE* file = fopen("frame_trace.json", "w"))
+  {
+    fwrite(trace.data(), 1, trace.size(), file);
+    fclose(file);
+  }
+#endif
+
+  engine_log_info("Frame trace saved (%u bytes)", (unsigned) trace.size());
+}
+
+}
+#endif
+
 #ifdef __EMSCRIPTEN__
 EM_JS(int, canvas_get_width, (), {
   return canvas.clientWidth;
@@ -80,6 +116,10 @@ int main(void)
   {
     engine_log_info("Application has been started");
 
+#ifdef ENGINE_PROFILER
+    profiler::set_thread_name("main");
+#endif
+
       //components loading
 
     ComponentScope components("engine::render::scene::passes::*");
@@ -158,6 +198,12 @@ int main(void)
           engine_log_info("Escape pressed. Exiting...");
           window.close();
           break;
+#ifdef ENGINE_PROFILER
+        case Key_F9:
+          if (pressed)
+            save_profile();
+          break;
+#endif
         default:
           break;
       }
@@ -443,6 +489,8 @@ int main(void)
 
       window.swap_buffers();
 
+      engine_profile_end_frame();
+
       //engine_log_debug("campos=(%.2f, %.2f, %.2f)",
       //                 camera->position().x, camera->position().y, camera->position().z);
 
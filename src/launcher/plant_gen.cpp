@@ -30,11 +30,10 @@ const int TARGET_LEAVES = 90;  // final leaf count after even downsampling -> bo
 float clampf(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
 float lerpf(float a, float b, float t)    { return a + (b - a) * t; }
 
-float smoothstepf(float e0, float e1, float x)
+// x in [0,1] with smoothstep(0, 1, x) == y: where a branch extending along a smoothstep reaches y
+float smoothstep_inversef(float y)
 {
-  if (e1 <= e0) return x < e0 ? 0.0f : 1.0f;
-  float t = clampf((x - e0) / (e1 - e0), 0.0f, 1.0f);
-  return t * t * (3.0f - 2.0f * t);
+  return 0.5f - std::sin(std::asin(clampf(1.0f - 2.0f * y, -1.0f, 1.0f)) / 3.0f);
 }
 
 math::vec3f mix3(const math::vec3f& a, const math::vec3f& b, float t) { return a + (b - a) * t; }
@@ -87,7 +86,6 @@ struct Builder
 struct Ctx
 {
   const PlantParams*     p;
-  float                  g;
   Builder*               bld   = nullptr;   // set on the mesh pass
   std::vector<LeafSlot>* slots = nullptr;   // set on the leaf-collect pass
   std::vector<Bone>*     bones = nullptr;   // set on the bone-collect pass
@@ -95,9 +93,9 @@ struct Ctx
   int                    branch_count = 0;
 };
 
-// Build one branch (curved, tapered tube) and recurse into children that sprout from it. On the mesh
-// pass it emits tube geometry up to the current growth; on the collect pass (g forced to 1) it records
-// leaf slots for the mature plant.
+// Build one branch (curved, tapered tube) of the mature plant and recurse into children that sprout
+// from it. On the mesh pass it emits tube geometry tagged with when each ring grows in; on the collect
+// pass it records leaf slots; on the bone pass it records the branch as a bone.
 void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float L, float r0,
                   int depth, float birth, uint32_t id)
 {
@@ -106,13 +104,10 @@ void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float
   float span    = SPAN[depth < 5 ? depth : 4] * lerpf(0.65f, 1.45f, hashf(id + 777u)); // per-branch growth speed (diversity)
   float mature  = birth + span; if (mature > 1.0f) mature = 1.0f;  // fully extended by g=1 at the latest
   bool  collect = cx.slots != nullptr;
-  bool  full    = collect || cx.bones != nullptr;     // leaf/bone passes use the fully-grown plant
-  float local   = full ? 1.0f : smoothstepf(birth, mature, cx.g);
-  if (local <= 0.0f) return;                          // not yet sprouted (mesh pass)
   cx.branch_count++;
 
   float depth_f = (float) depth / (float) cx.p->max_depth;
-  float curL    = L * local;
+  float curL    = L;
   int   sides   = cx.p->branch_sides;
   int   rings   = (depth >= cx.p->max_depth - 1) ? 4 : 6;
 
@@ -123,8 +118,8 @@ void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float
   float bendRoll  = hashf(id + 701u) * TWO_PI;
   math::vec3f bendAxis = bn * std::cos(bendRoll) + bb * std::sin(bendRoll);
   float totalBend = (hashf(id + 711u) - 0.5f) * lerpf(0.5f, 1.6f, depth_f);
-  float bendStep  = (totalBend / rings) * local;
-  float sagStep   = lerpf(0.0f, 0.10f, depth_f) * local;   // droop per segment
+  float bendStep  = totalBend / rings;
+  float sagStep   = lerpf(0.0f, 0.10f, depth_f);   // droop per segment
 
   std::vector<math::vec3f> cpos(rings + 1), cdir(rings + 1);
   math::vec3f pos = P0, d = dir;
@@ -137,7 +132,9 @@ void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float
     pos = pos + d * seglen;
   }
 
-  // tube rings (mesh pass only)
+  // tube rings (mesh pass only). While the branch extends (smoothstep from birth to mature) its rings
+  // swell out of the centreline one after the other, base first: each vertex carries the g span its
+  // ring grows over (tex_coord) and the ring radius (color alpha) -- see the growth in flower.glsl.
   if (cx.bld)
   {
     std::vector<uint32_t> ringbase(rings + 1);
@@ -148,12 +145,16 @@ void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float
       frame(cdir[i], rn, rb);
       float r = r0 * lerpf(1.0f, 0.32f, t);
       math::vec3f col = mix3(cx.p->stem_base, cx.p->stem_tip, clampf(depth_f + t * 0.4f, 0.0f, 1.0f));
+      math::vec2f grow(birth + (mature - birth) * smoothstep_inversef((float) i / (float) (rings + 1)),
+                       birth + (mature - birth) * smoothstep_inversef((float) (i + 1) / (float) (rings + 1)));
       ringbase[i] = cx.bld->verts.size();
       for (int j = 0; j < sides; ++j)
       {
         float a = TWO_PI * (float) j / (float) sides;
         math::vec3f dirr = rn * std::cos(a) + rb * std::sin(a);
-        cx.bld->add(cpos[i] + dirr * r, dirr, col);
+        uint32_t v = cx.bld->add(cpos[i] + dirr * r, dirr, col);
+        cx.bld->verts[v].color.w   = r;
+        cx.bld->verts[v].tex_coord = grow;
       }
     }
     for (int i = 0; i < rings; ++i)
@@ -190,6 +191,7 @@ void build_branch(Ctx& cx, const math::vec3f& P0, const math::vec3f& dir, float
         v.color     = math::vec4f(col.x, col.y, col.z, 1.0f);
         v.tex_coord = math::vec2f(0.0f, 0.0f);
         bone.verts.push_back(v);
+        bone.weights.push_back(i == 0 && cx.cur_bone >= 0 ? 0.5f : 1.0f); // base ring: half on the parent
       }
     }
     for (int i = 0; i < rings; ++i)
@@ -321,14 +323,12 @@ PlantParams make_plant_params(uint32_t seed)
   return p;
 }
 
-void generate_plant_mesh(Mesh& out, const PlantParams& p, float g, const char* material)
+void generate_plant_mesh(Mesh& out, const PlantParams& p, const char* material)
 {
   out.clear();
-  g = clampf(g, 0.0f, 1.0f);
-  if (g <= 0.0f) return;
 
   Builder bld;
-  Ctx cx; cx.p = &p; cx.g = g; cx.bld = &bld;
+  Ctx cx; cx.p = &p; cx.bld = &bld;
   build_branch(cx, math::vec3f(0, 0, 0), trunk_dir(p), p.target_height, p.trunk_radius, 0, 0.0f, p.seed | 1u);
 
   if (bld.verts.empty()) return;
@@ -341,7 +341,7 @@ void generate_plant_mesh(Mesh& out, const PlantParams& p, float g, const char* m
 void collect_bones(const PlantParams& p, std::vector<Bone>& out)
 {
   out.clear();
-  Ctx cx; cx.p = &p; cx.g = 1.0f; cx.bones = &out; cx.cur_bone = -1;
+  Ctx cx; cx.p = &p; cx.bones = &out; cx.cur_bone = -1;
   build_branch(cx, math::vec3f(0, 0, 0), trunk_dir(p), p.target_height, p.trunk_radius, 0, 0.0f, p.seed | 1u);
 }
 
@@ -453,7 +453,7 @@ void collect_leaf_slots(const PlantParams& p, std::vector<LeafSlot>& out)
 
     //gather ALL leaf candidates across the whole tree (depth-first order)
   std::vector<LeafSlot> all;
-  Ctx cx; cx.p = &p; cx.g = 1.0f; cx.slots = &all;
+  Ctx cx; cx.p = &p; cx.slots = &all;
   build_branch(cx, math::vec3f(0, 0, 0), trunk_dir(p), p.target_height, p.trunk_radius, 0, 0.0f, p.seed | 1u);
 
   if ((int) all.size() <= TARGET_LEAVES)
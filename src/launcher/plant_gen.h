@@ -6,7 +6,7 @@
 // structure developmentally: the trunk extends first, then branches sprout from it -- progressively
 // and at randomised moments -- then their twigs, branching again. Every random decision (branch
 // count, angles, lengths, where/when each branch and leaf appears) is derived from a stable per-node
-// hash, NOT a running RNG, so re-generating at a higher g yields the SAME plant, just further grown.
+// hash, NOT a running RNG, so the mature plant is tessellated once and growth only reveals it.
 //
 // Branches are rendered as curved, tapered tubes (this module). LEAVES are NOT geometry here -- the
 // generator only reports leaf attachment "slots" (collect_leaf_slots); the host (world.cpp) spawns a
@@ -54,8 +54,12 @@ struct LeafSlot
 // Derive a varied-but-deterministic plant from a seed.
 PlantParams make_plant_params(uint32_t seed);
 
-// (Re)build the branch geometry for growth g in [0,1] into `out` (cleared first).
-void generate_plant_mesh(engine::media::geometry::Mesh& out, const PlantParams& p, float g,
+// Build the branch geometry of the mature plant into `out` (cleared first), once: every vertex carries
+// the growth span its tube ring swells in over (tex_coord: g start, g end) and the ring radius (color
+// alpha), and the "flower" shader grows the mesh by its plantGrowth uniform (g in [0,1]; < 0 draws it
+// as is). Not-yet-grown rings collapse onto the branch centreline, so no CPU re-tessellation is needed
+// while the plant grows.
+void generate_plant_mesh(engine::media::geometry::Mesh& out, const PlantParams& p,
                          const char* material = "flower");
 
 // Collect every leaf attachment slot for the mature plant (each carries its own birth_g).
@@ -63,8 +67,10 @@ void collect_leaf_slots(const PlantParams& p, std::vector<LeafSlot>& out);
 
 // One branch as a SKELETON bone: its tube geometry (in bone-local space, relative to rest_base, no
 // rotation at rest) + the rest endpoints + parent bone index. The host (world.cpp) makes a rigid body
-// per bone, joints it to its parent, and re-poses the verts by the body transform each frame so the
-// branch mesh follows the physics skeleton (drag/wind). parent = -1 for the trunk (the fixed root).
+// per bone, joints it to its parent, and skins the branch mesh on the GPU with the body transforms so
+// it follows the physics skeleton (drag/wind). parent = -1 for the trunk (the fixed root).
+// weights: per vertex, the share that follows this bone; the rest follows the parent, so the base
+// ring bends with the joint instead of cracking open.
 struct Bone
 {
   math::vec3f rest_base;   // branch base / joint point, plant-local
@@ -73,6 +79,7 @@ struct Bone
   int         parent = -1;
   std::vector<engine::media::geometry::Vertex>           verts;   // positions relative to rest_base
   std::vector<engine::media::geometry::Mesh::index_type> indices; // 0-based within this bone
+  std::vector<float>                                     weights; // per vertex, 1 for the trunk
 };
 
 // Collect the mature plant as a bone skeleton (one bone per branch). Order is parent-before-child.
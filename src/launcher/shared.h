@@ -8,6 +8,61 @@
 #include <render/scene_render.h>
 #include <media/geometry.h>
 
+/// Wall time spent in each phase of the last World::update, milliseconds. Plants (springs and meshes),
+/// clustering, raymarch upload, cohesion and the water steps run concurrently on the update's worker
+/// threads: their times overlap, `parallel` is the wall time of that part.
+struct WorldPhaseTimings
+{
+  double step            = 0.0; // physics substeps (contacts, fluid solver)
+  double spawn           = 0.0; // droplet generation
+  double plants          = 0.0; // plant and leaf growth, leaf springs, plant meshes
+  double clustering      = 0.0; // fallen particles, particle -> droplet clustering, droplet centres
+  double raymarch_upload = 0.0; // per-droplet raymarch uniforms
+  double cohesion        = 0.0; // droplet surface tension
+  double water           = 0.0; // ripple steps + texture upload
+  double parallel        = 0.0; // the concurrent phases above, start to end
+  double other           = 0.0; // everything else (tuning, lights, sounds, mesh sync, fireflies)
+};
+
+/// Entities the last World::update found at rest and skipped (cohesion, re-tracking, raymarch upload,
+/// light / mesh sync, leaf spring)
+struct WorldSettleCounters
+{
+  size_t droplets               = 0;
+  size_t droplets_settled       = 0;
+  size_t droplet_particles_held = 0; // particles of settled droplets not re-tracked
+  size_t leaves                 = 0;
+  size_t leaves_settled         = 0;
+};
+
+/// Droplet/leaf contacts the physics steps of the last World::update recorded (handled once per pair)
+struct WorldContactStats
+{
+  size_t events    = 0;    // contact records (every substep, every new contact point)
+  size_t pairs     = 0;    // distinct droplet/leaf pairs among them
+  size_t dropped   = 0;    // records past the per-frame buffer
+  float  max_speed = 0.0f; // highest approach speed along a contact normal
+};
+
+/// Shown droplets per level of detail in the last World::update (from their proxy box's size on screen)
+struct WorldDropletLodCounters
+{
+  size_t full     = 0; // the whole particle field, full step budget
+  size_t reduced  = 0; // fewer particles and steps
+  size_t impostor = 0; // one analytic sphere
+};
+
+/// Leaf collision shape cache counters, since the world was created
+struct WorldLeafShapeStats
+{
+  size_t hits      = 0; // leaves given a cached shape
+  size_t misses    = 0; // shapes built
+  size_t uncached  = 0; // built shapes not kept: the cache was full of shapes in use
+  size_t evictions = 0; // unused shapes dropped to make room
+  size_t shapes    = 0; // cached now
+  size_t bytes     = 0; // their estimated size
+};
+
 /// Game world
 class World
 {
@@ -26,6 +81,40 @@ class World
     void inputDrag(float target_offset_x, float target_offset_y, float target_offset_z);
     void inputRelease();
 
+    /// Phase timings of the last update
+    const WorldPhaseTimings& phase_timings() const;
+
+    /// Settled (skipped) entities of the last update
+    const WorldSettleCounters& settle_counters() const;
+
+    /// Contacts of the last update
+    const WorldContactStats& contact_stats() const;
+
+    /// Droplets drawn per level of detail in the last update
+    const WorldDropletLodCounters& droplet_lod_counters() const;
+
+    /// Leaf collision shape cache counters
+    const WorldLeafShapeStats& leaf_shape_stats() const;
+
+    /// Live droplet particles (Bullet spheres or fluid particles)
+    size_t droplet_particles_count() const;
+
+    /// Wind acceleration on the branch skeleton (on the web the window.WIND.accel slider overrides it)
+    void set_wind_accel(float accel);
+
+    /// Step Bullet on the update's worker threads (builds with WORLD_BULLET_MT; on the web the
+    /// window.PHYSICS.threads switch overrides it)
+    void set_physics_threads(bool threads);
+
+    /// Set a live parameter by its page name ("WIND.accel=12"); false for an unknown name or a malformed
+    /// assignment. load_tuning applies a file of them, one per line ('#' comments)
+    bool assign_tuning(const char* assignment);
+    void load_tuning(const char* path);
+
+    /// Reseed the world's random generator (droplet spawns, lights, fireflies, plant seeds); a world
+    /// created after the same seed and driven by the same dt / input sequence replays exactly
+    static void seed_random(unsigned int seed);
+
   private:
     struct Impl;
     std::shared_ptr<Impl> impl;
@@ -0,0 +1,93 @@
+#pragma once
+
+// Minimal 4-wide float vector for the launcher's grid/particle kernels.
+//
+// Maps onto WASM SIMD128 on the web (build with -msimd128, see the Makefile's SIMD switch), SSE on
+// x86 and NEON on ARM; anything else gets a plain 4-float struct so the same kernel still compiles and
+// runs (the compiler may or may not vectorize it); define LAUNCHER_SIMD_DISABLE to force that path.
+// Only the handful of ops the kernels need are here.
+
+#if defined(LAUNCHER_SIMD_DISABLE)
+  #define LAUNCHER_SIMD_SCALAR 1
+#elif defined(__wasm_simd128__)
+  #include <wasm_simd128.h>
+  #define LAUNCHER_SIMD_WASM 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #include <xmmintrin.h>
+  #define LAUNCHER_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define LAUNCHER_SIMD_NEON 1
+#else
+  #define LAUNCHER_SIMD_SCALAR 1
+#endif
+
+namespace engine {
+namespace launcher {
+namespace simd {
+
+#if LAUNCHER_SIMD_WASM
+
+struct float4 { v128_t v; };
+
+inline float4 load(const float* p)                   { return {wasm_v128_load(p)}; }
+inline void   store(float* p, float4 a)              { wasm_v128_store(p, a.v); }
+inline float4 set1(float x)                          { return {wasm_f32x4_splat(x)}; }
+inline float4 operator + (float4 a, float4 b)        { return {wasm_f32x4_add(a.v, b.v)}; }
+inline float4 operator - (float4 a, float4 b)        { return {wasm_f32x4_sub(a.v, b.v)}; }
+inline float4 operator * (float4 a, float4 b)        { return {wasm_f32x4_mul(a.v, b.v)}; }
+inline float4 max(float4 a, float4 b)                { return {wasm_f32x4_pmax(a.v, b.v)}; }
+
+#elif LAUNCHER_SIMD_SSE
+
+struct float4 { __m128 v; };
+
+inline float4 load(const float* p)                   { return {_mm_loadu_ps(p)}; }
+inline void   store(float* p, float4 a)              { _mm_storeu_ps(p, a.v); }
+inline float4 set1(float x)                          { return {_mm_set1_ps(x)}; }
+inline float4 operator + (float4 a, float4 b)        { return {_mm_add_ps(a.v, b.v)}; }
+inline float4 operator - (float4 a, float4 b)        { return {_mm_sub_ps(a.v, b.v)}; }
+inline float4 operator * (float4 a, float4 b)        { return {_mm_mul_ps(a.v, b.v)}; }
+inline float4 max(float4 a, float4 b)                { return {_mm_max_ps(a.v, b.v)}; }
+
+#elif LAUNCHER_SIMD_NEON
+
+struct float4 { float32x4_t v; };
+
+inline float4 load(const float* p)                   { return {vld1q_f32(p)}; }
+inline void   store(float* p, float4 a)              { vst1q_f32(p, a.v); }
+inline float4 set1(float x)                          { return {vdupq_n_f32(x)}; }
+inline float4 operator + (float4 a, float4 b)        { return {vaddq_f32(a.v, b.v)}; }
+inline float4 operator - (float4 a, float4 b)        { return {vsubq_f32(a.v, b.v)}; }
+inline float4 operator * (float4 a, float4 b)        { return {vmulq_f32(a.v, b.v)}; }
+inline float4 max(float4 a, float4 b)                { return {vmaxq_f32(a.v, b.v)}; }
+
+#else
+
+struct float4 { float v[4]; };
+
+inline float4 load(const float* p)                   { return {{p[0], p[1], p[2], p[3]}}; }
+inline void   store(float* p, float4 a)              { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+inline float4 set1(float x)                          { return {{x, x, x, x}}; }
+inline float4 operator + (float4 a, float4 b)        { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline float4 operator - (float4 a, float4 b)        { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline float4 operator * (float4 a, float4 b)        { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline float4 max(float4 a, float4 b)                { return {{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}}; }
+
+#endif
+
+/// Name of the active backend (for benchmark output)
+inline const char* backend_name()
+{
+#if LAUNCHER_SIMD_WASM
+  return "wasm-simd128";
+#elif LAUNCHER_SIMD_SSE
+  return "sse";
+#elif LAUNCHER_SIMD_NEON
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+}}}
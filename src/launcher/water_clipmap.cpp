@@ -0,0 +1,167 @@
+#include "water_clipmap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const uint32_t NO_VERTEX    = 0xffffffffu;
+const size_t   MAX_VERTICES = 0xffff;  // 16-bit indices, 0xffff is the primitive restart index
+const size_t   MAX_LEVELS   = 12;
+
+size_t clipmap_vertices_count(size_t cells, size_t levels)
+{
+  size_t level  = (2 * cells + 1) * (2 * cells + 1);
+  size_t inside = (cells + 1) * (cells + 1); // points of a ring's hole, boundary included (owned by the finer level)
+
+  return level + (levels - 1) * (level - inside);
+}
+
+}
+
+WaterClipmap::WaterClipmap(const WaterClipmapParams& params)
+  : finest_cell(params.cell_size)
+  , cells(std::max(params.ring_cells & ~size_t(1), size_t(2)))
+  , levels(std::min(std::max(params.levels, size_t(1)), MAX_LEVELS))
+{
+  center[0] = center[1] = 0.0f;
+
+  while (cells > 2 && clipmap_vertices_count(cells, levels) >= MAX_VERTICES)
+    cells -= 2;
+
+  lattice_radius = int(cells) << (levels - 1);
+
+  size_t lattice_size = size_t(2 * lattice_radius + 1);
+
+  lattice.assign(lattice_size * lattice_size, NO_VERTEX);
+  vertex_list.reserve(clipmap_vertices_count(cells, levels));
+
+    //level 0: the full square; level k: its square without the hole covered by level k - 1
+
+  const int m = int(cells), h = m / 2;
+
+  for (size_t level=0; level<levels; level++)
+  {
+    const int   step = 1 << level;
+    const float cell = cell_size(level);
+
+    for (int a=-m; a<m; a++)
+      for (int b=-m; b<m; b++)
+      {
+        if (level > 0 && a >= -h && a < h && b >= -h && b < h)
+          continue;
+
+        add_cell(a * step, b * step, step, cell);
+      }
+  }
+
+  lattice.clear();
+  lattice.shrink_to_fit();
+}
+
+uint16_t WaterClipmap::vertex(int ix, int iz, float cell)
+{
+  uint32_t& index = lattice[size_t(ix + lattice_radius) * size_t(2 * lattice_radius + 1) + size_t(iz + lattice_radius)];
+
+  if (index == NO_VERTEX)
+  {
+    WaterClipmapVertex v;
+
+    v.x    = float(ix) * finest_cell;
+    v.z    = float(iz) * finest_cell;
+    v.cell = cell;
+
+    index = uint32_t(vertex_list.size());
+
+    vertex_list.push_back(v);
+  }
+
+  return uint16_t(index);
+}
+
+void WaterClipmap::add_triangle(uint16_t a, uint16_t b, uint16_t c)
+{
+  const WaterClipmapVertex &va = vertex_list[a], &vb = vertex_list[b], &vc = vertex_list[c];
+
+  float up = (vb.z - va.z) * (vc.x - va.x) - (vb.x - va.x) * (vc.z - va.z);
+
+  index_list.push_back(a);
+  index_list.push_back(up > 0.0f ? b : c);
+  index_list.push_back(up > 0.0f ? c : b);
+}
+
+void WaterClipmap::add_cell(int ix, int iz, int step, float cell)
+{
+    //walk the cell outline; an edge along the finer level's boundary contributes its midpoint vertex
+
+  static const int corners[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+  uint16_t outline[8];
+  size_t   count = 0, fan = 8;
+
+  for (size_t k=0; k<4; k++)
+  {
+    const int* c0 = corners[k];
+    const int* c1 = corners[(k + 1) % 4];
+
+    outline[count++] = vertex(ix + c0[0] * step, iz + c0[1] * step, cell);
+
+    if (step == 1)
+      continue;
+
+    int mx = ix + (c0[0] + c1[0]) * step / 2, mz = iz + (c0[1] + c1[1]) * step / 2;
+
+    if (lattice[size_t(mx + lattice_radius) * size_t(2 * lattice_radius + 1) + size_t(mz + lattice_radius)] == NO_VERTEX)
+      continue;
+
+    if (fan == 8)
+      fan = count;
+
+    outline[count++] = vertex(mx, mz, cell);
+  }
+
+  if (fan == 8)
+  {
+    add_triangle(outline[0], outline[1], outline[3]);
+    add_triangle(outline[1], outline[2], outline[3]);
+    return;
+  }
+
+    //transition cell: fan around the shared midpoint
+
+  for (size_t t=1; t+1<count; t++)
+    add_triangle(outline[fan], outline[(fan + t) % count], outline[(fan + t + 1) % count]);
+}
+
+bool WaterClipmap::set_viewer(float x, float z)
+{
+  const float snap = cell_size(levels - 1);
+
+  float cx = std::floor(x / snap + 0.5f) * snap;
+  float cz = std::floor(z / snap + 0.5f) * snap;
+
+  if (cx == center[0] && cz == center[1])
+    return false;
+
+  center[0] = cx;
+  center[1] = cz;
+
+  return true;
+}
+
+size_t WaterClipmap::level_at(float x, float z) const
+{
+  float d = std::max(std::fabs(x - center[0]), std::fabs(z - center[1]));
+
+  for (size_t level=0; level<levels; level++)
+    if (d <= level_half_extent(level))
+      return level;
+
+  return levels;
+}
+
+}}
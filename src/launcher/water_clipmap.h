@@ -0,0 +1,85 @@
+#pragma once
+
+// Geometry clipmap for the water plane: nested square levels around the viewer, fine near the camera
+// and coarse at the horizon.
+//
+// Level 0 is a full square of 2 ring_cells x 2 ring_cells cells of cell_size; level k is the same square
+// of cells twice the size of level k - 1, minus the centre already covered by the finer levels (a ring
+// ring_cells / 2 cells wide). Because every hole edge lies on the coarser lattice, the finer level's
+// boundary has exactly one extra vertex per coarse edge; the coarse cells along the hole are fanned
+// around that shared vertex instead of being split in two, so there are no T-junctions and no cracks
+// whatever the vertex shader does with the heights. Vertices are welded: a point shared by two levels
+// is a single vertex owned by the finer one.
+//
+// The mesh is built once around the origin and never changes; the host translates it to center(),
+// which snaps the viewer position to the coarsest cell so every level's vertices stay on their world
+// lattice (no swimming while the camera moves). Each vertex carries the cell size of its level, which
+// the shader uses to choose its ripple sampling footprint. No GL here.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+/// Level layout
+struct WaterClipmapParams
+{
+  float  cell_size  = 1.5f; // cell of the finest level (world units)
+  size_t ring_cells = 32;   // half width of every level, in its own cells (even; lowered to fit 16-bit indices)
+  size_t levels     = 4;    // level k has cells of cell_size * 2^k
+};
+
+/// Clipmap vertex, relative to the clipmap centre
+struct WaterClipmapVertex
+{
+  float x, z;  // offset from the centre (world units)
+  float cell;  // cell size of the finest level containing the vertex
+};
+
+class WaterClipmap
+{
+  public:
+    explicit WaterClipmap(const WaterClipmapParams& params);
+
+    /// Layout
+    size_t levels_count()                   const { return levels; }
+    size_t ring_cells()                     const { return cells; }
+    float  cell_size(size_t level)          const { return finest_cell * float(size_t(1) << level); }
+    float  level_half_extent(size_t level)  const { return float(cells) * cell_size(level); }
+    float  half_extent()                    const { return level_half_extent(levels - 1); }
+
+    /// Move the clipmap under a viewer at world (x, z); the centre snaps to the coarsest cell.
+    /// Returns true if the centre moved (the host re-translates the mesh)
+    bool set_viewer(float x, float z);
+
+    /// Current centre (world units)
+    float center_x() const { return center[0]; }
+    float center_z() const { return center[1]; }
+
+    /// Finest level covering world point (x, z) around the current centre; levels_count() if outside
+    size_t level_at(float x, float z) const;
+
+    /// Mesh around the origin: welded vertices and a triangle list with the water grid's winding
+    /// ((b - a) x (c - a) points up)
+    const std::vector<WaterClipmapVertex>& vertices() const { return vertex_list; }
+    const std::vector<uint16_t>&           indices()  const { return index_list; }
+
+  private:
+    uint16_t vertex(int ix, int iz, float cell);
+    void     add_triangle(uint16_t a, uint16_t b, uint16_t c);
+    void     add_cell(int ix, int iz, int step, float cell);
+
+  private:
+    float                           finest_cell;
+    size_t                          cells;
+    size_t                          levels;
+    float                           center[2];
+    int                             lattice_radius;  // outermost extent in finest cells
+    std::vector<uint32_t>           lattice;         // (2 lattice_radius + 1)^2 finest-lattice points -> vertex index
+    std::vector<WaterClipmapVertex> vertex_list;
+    std::vector<uint16_t>           index_list;
+};
+
+}}
@@ -0,0 +1,420 @@
+#include "water_grid.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace launcher {
+
+namespace
+{
+
+const float TWO_PI          = 6.2831853f;
+const float SWELL_DIAGONAL  = 0.7f;        // wave 2 travels along (0.7, 0.7)
+
+}
+
+/*
+    WaterSwell
+*/
+
+float WaterSwell::height(float x, float z, float t) const
+{
+  const float k1 = TWO_PI / len1;
+  const float k2 = TWO_PI / len2;
+
+  return amp1 * sinf(x * k1 + t * speed1)
+       + amp2 * sinf((x * SWELL_DIAGONAL + z * SWELL_DIAGONAL) * k2 + t * speed2);
+}
+
+/*
+    WaterGrid
+*/
+
+WaterGrid::WaterGrid(size_t size, float half_extent, const WaterParams& in_params)
+  : grid_size(size)
+  , extent(half_extent)
+  , params(in_params)
+  , field_a(size * size, 0.0f)
+  , field_b(size * size, 0.0f)
+  , current(&field_a[0])
+  , previous(&field_b[0])
+  , swell(size * size, 0.0f)
+  , row_wave1(size)
+  , row_sin2(size)
+  , row_cos2(size)
+  , col_cos2(size)
+  , col_sin2(size)
+  , height(size * size, 0.0f)
+  , normal_x(size * size, 0.0f)
+  , normal_z(size * size, 0.0f)
+{
+  if (params.tile_size < 1)
+    params.tile_size = 1;
+
+  tiles_row = (size + params.tile_size - 1) / params.tile_size;
+
+  sparse = size >= params.sparse_min_size;
+
+  tile_active.assign(tiles_row * tiles_row, sparse ? 0 : 1); // dense: every tile is integrated every step
+  tile_wake.assign(tiles_row * tiles_row, 0);
+  tile_changed.assign(tiles_row * tiles_row, 0);
+  tile_quiet.assign(tiles_row * tiles_row, 0);
+
+  const float k2 = TWO_PI / params.swell.len2;
+
+  for (size_t j=0; j<size; j++)
+  {
+    float b = coord(j) * SWELL_DIAGONAL * k2;
+
+    col_cos2[j] = params.swell.amp2 * cosf(b);
+    col_sin2[j] = params.swell.amp2 * sinf(b);
+  }
+}
+
+void WaterGrid::update_swell(float t)
+{
+    //3 sines per row; per cell: wave1(i) + sin(a_i) * amp2 cos(b_j) + cos(a_i) * amp2 sin(b_j)
+
+  const WaterSwell& s = params.swell;
+  const float k1 = TWO_PI / s.len1;
+  const float k2 = TWO_PI / s.len2;
+  const size_t N = grid_size;
+
+  for (size_t i=0; i<N; i++)
+  {
+    float x = coord(i);
+    float a = x * SWELL_DIAGONAL * k2 + t * s.speed2;
+
+    row_wave1[i] = s.amp1 * sinf(x * k1 + t * s.speed1);
+    row_sin2[i]  = sinf(a);
+    row_cos2[i]  = cosf(a);
+  }
+
+  const float* cc = &col_cos2[0];
+  const float* cs = &col_sin2[0];
+
+  for (size_t i=0; i<N; i++)
+  {
+    float* row = &swell[i * N];
+    const simd::float4 w1 = simd::set1(row_wave1[i]), sa = simd::set1(row_sin2[i]), ca = simd::set1(row_cos2[i]);
+
+    size_t j = 0;
+
+    for (; j + 4 <= N; j += 4)
+      simd::store(row + j, w1 + sa * simd::load(cc + j) + ca * simd::load(cs + j));
+
+    for (; j<N; j++)
+      row[j] = row_wave1[i] + row_sin2[i] * cc[j] + row_cos2[i] * cs[j];
+  }
+}
+
+void WaterGrid::step(float swell_time)
+{
+  update_swell(swell_time);
+
+  const size_t N = grid_size;
+  const float  VIS = params.viscosity;
+
+  const simd::float4 height_scale = simd::set1(params.height_scale),
+                     min_height   = simd::set1(params.min_height),
+                     ripple_slope = simd::set1(params.normal_steepness),
+                     swell_slope  = simd::set1(params.swell_steepness),
+                     quarter      = simd::set1(0.25f),
+                     keep         = simd::set1(2.0f - VIS),
+                     fade         = simd::set1(1.0f - VIS),
+                     speed        = simd::set1(params.wave_speed);
+
+  for (size_t i=1; i<N-1; i++)
+  {
+    const float* u   = current + i * N;       // U row i
+    const float* um  = u - N;                 // row i-1
+    const float* up  = u + N;                 // row i+1
+    const float* s   = &swell[i * N];
+    const float* sm  = s - N;
+    const float* sp  = s + N;
+    float*       out = previous + i * N;      // U(t-1) row i -> U(t+1)
+    float*       h   = &height[i * N];
+    float*       nx  = &normal_x[i * N];
+    float*       nz  = &normal_z[i * N];
+
+      //interior columns 1..N-2, 4 at a time, then the scalar tail (same arithmetic)
+
+    size_t j = 1;
+
+    for (; j + 4 <= N - 1; j += 4)
+    {
+      simd::float4 uc = simd::load(u + j), ujm = simd::load(u + j - 1), ujp = simd::load(u + j + 1),
+                   uim = simd::load(um + j), uip = simd::load(up + j);
+
+      simd::store(h + j, simd::max(uc * height_scale + simd::load(s + j), min_height));
+      simd::store(nx + j, (uim - uip) * ripple_slope + (simd::load(sm + j) - simd::load(sp + j)) * swell_slope);
+      simd::store(nz + j, (ujm - ujp) * ripple_slope + (simd::load(s + j - 1) - simd::load(s + j + 1)) * swell_slope);
+
+      simd::float4 laplacian = (uim + uip + ujp + ujm) * quarter - uc;
+
+      simd::store(out + j, keep * uc - simd::load(out + j) * fade + laplacian * speed);
+    }
+
+    for (; j<N-1; j++)
+    {
+      float hv = u[j] * params.height_scale + s[j];
+
+      h[j]  = hv < params.min_height ? params.min_height : hv;
+      nx[j] = (um[j] - up[j]) * params.normal_steepness + (sm[j] - sp[j]) * params.swell_steepness;
+      nz[j] = (u[j-1] - u[j+1]) * params.normal_steepness + (s[j-1] - s[j+1]) * params.swell_steepness;
+
+      float laplacian = (um[j] + up[j] + u[j+1] + u[j-1]) * 0.25f - u[j];
+
+      out[j] = (2.0f - VIS) * u[j] - out[j] * (1.0f - VIS) + laplacian * params.wave_speed;
+    }
+  }
+
+    //swap time levels
+
+  float* tmp = previous;
+  previous = current;
+  current  = tmp;
+}
+
+WaterGrid::TileEnergy WaterGrid::integrate_tile(size_t i0, size_t i1, size_t j0, size_t j1)
+{
+    //wave equation over the cells [i0, i1) x [j0, j1); measures max |U(t+1)| over the tile and along
+    //each edge (which the neighbours' next stencil reads)
+
+  const size_t N   = grid_size;
+  const float  VIS = params.viscosity;
+
+  const simd::float4 quarter = simd::set1(0.25f),
+                     keep    = simd::set1(2.0f - VIS),
+                     fade    = simd::set1(1.0f - VIS),
+                     speed   = simd::set1(params.wave_speed),
+                     zero    = simd::set1(0.0f);
+
+  TileEnergy result;
+
+  simd::float4 energy4 = zero;
+  float        energy  = 0.0f;
+
+  for (size_t i=i0; i<i1; i++)
+  {
+    const float* u   = current + i * N;
+    const float* um  = u - N;
+    const float* up  = u + N;
+    float*       out = previous + i * N;
+
+    simd::float4 row4 = zero;
+    float        row  = 0.0f;
+    size_t       j    = j0;
+
+    for (; j + 4 <= j1; j += 4)
+    {
+      simd::float4 uc = simd::load(u + j),
+                   laplacian = (simd::load(um + j) + simd::load(up + j) + simd::load(u + j + 1) + simd::load(u + j - 1)) * quarter - uc,
+                   next = keep * uc - simd::load(out + j) * fade + laplacian * speed;
+
+      simd::store(out + j, next);
+
+      row4 = simd::max(row4, simd::max(next, zero - next));
+    }
+
+    for (; j<j1; j++)
+    {
+      float laplacian = (um[j] + up[j] + u[j+1] + u[j-1]) * 0.25f - u[j];
+
+      out[j] = (2.0f - VIS) * u[j] - out[j] * (1.0f - VIS) + laplacian * params.wave_speed;
+
+      row = std::max(row, std::fabs(out[j]));
+    }
+
+    energy4 = simd::max(energy4, row4);
+    energy  = std::max(energy, row);
+
+    result.left  = std::max(result.left, std::fabs(out[j0]));
+    result.right = std::max(result.right, std::fabs(out[j1 - 1]));
+
+    if (i == i0 || i + 1 == i1)
+    {
+      float lanes[4];
+
+      simd::store(lanes, row4);
+
+      row = std::max(std::max(row, lanes[0]), std::max(lanes[1], std::max(lanes[2], lanes[3])));
+
+      if (i == i0)     result.top    = row;
+      if (i + 1 == i1) result.bottom = row;
+    }
+  }
+
+  float lanes[4];
+
+  simd::store(lanes, energy4);
+
+  result.all = std::max(std::max(energy, lanes[0]), std::max(lanes[1], std::max(lanes[2], lanes[3])));
+
+  return result;
+}
+
+void WaterGrid::integrate_dense()
+{
+    //wave equation over every interior cell, no energy tracking
+
+  const size_t N   = grid_size;
+  const float  VIS = params.viscosity;
+
+  const simd::float4 quarter = simd::set1(0.25f),
+                     keep    = simd::set1(2.0f - VIS),
+                     fade    = simd::set1(1.0f - VIS),
+                     speed   = simd::set1(params.wave_speed);
+
+  for (size_t i=1; i<N-1; i++)
+  {
+    const float* u   = current + i * N;
+    const float* um  = u - N;
+    const float* up  = u + N;
+    float*       out = previous + i * N;
+    size_t       j   = 1;
+
+    for (; j + 4 <= N - 1; j += 4)
+    {
+      simd::float4 uc = simd::load(u + j),
+                   laplacian = (simd::load(um + j) + simd::load(up + j) + simd::load(u + j + 1) + simd::load(u + j - 1)) * quarter - uc;
+
+      simd::store(out + j, keep * uc - simd::load(out + j) * fade + laplacian * speed);
+    }
+
+    for (; j<N-1; j++)
+    {
+      float laplacian = (um[j] + up[j] + u[j+1] + u[j-1]) * 0.25f - u[j];
+
+      out[j] = (2.0f - VIS) * u[j] - out[j] * (1.0f - VIS) + laplacian * params.wave_speed;
+    }
+  }
+}
+
+void WaterGrid::integrate()
+{
+  const size_t N = grid_size, T = params.tile_size, TR = tiles_row;
+  const float  EPS = params.idle_epsilon;
+
+    //small grid: one pass over the interior, every tile changed (no sleeping, exact)
+
+  if (!sparse)
+  {
+    integrate_dense();
+
+    std::fill(tile_changed.begin(), tile_changed.end(), 1);
+
+    float* tmp = previous;
+    previous = current;
+    current  = tmp;
+
+    return;
+  }
+
+  for (size_t ty=0; ty<TR; ty++)
+    for (size_t tx=0; tx<TR; tx++)
+    {
+      size_t tile = ty * TR + tx;
+
+      if (!tile_active[tile])
+        continue;
+
+        //interior cells of the tile
+
+      size_t i0 = std::max(ty * T, size_t(1)), i1 = std::min((ty + 1) * T, N - 1),
+             j0 = std::max(tx * T, size_t(1)), j1 = std::min((tx + 1) * T, N - 1);
+
+      TileEnergy energy = integrate_tile(i0, i1, j0, j1);
+
+      tile_changed[tile] = 1;
+
+        //two quiet steps in a row -> both kept time levels are below epsilon: sleep (flattened after the
+        //pass, since neighbours integrated later still read U(t) here)
+
+      tile_quiet[tile] = energy.all <= EPS ? tile_quiet[tile] + 1 : 0;
+
+      if (tile_quiet[tile] >= 2)
+      {
+        tiles_to_sleep.push_back(uint32_t(tile));
+        continue;
+      }
+
+        //the next step's stencil of a neighbour reads this tile's edge: wake it if the edge moved
+
+      if (tx > 0      && energy.left > EPS)   tile_wake[tile - 1]  = 1;
+      if (tx + 1 < TR && energy.right > EPS)  tile_wake[tile + 1]  = 1;
+      if (ty > 0      && energy.top > EPS)    tile_wake[tile - TR] = 1;
+      if (ty + 1 < TR && energy.bottom > EPS) tile_wake[tile + TR] = 1;
+    }
+
+    //decayed tiles: flatten both time levels and sleep
+
+  for (uint32_t tile : tiles_to_sleep)
+  {
+    size_t ty = tile / TR, tx = tile % TR;
+    size_t i0 = std::max(ty * T, size_t(1)), i1 = std::min((ty + 1) * T, N - 1),
+           j0 = std::max(tx * T, size_t(1)), j1 = std::min((tx + 1) * T, N - 1);
+
+    for (size_t i=i0; i<i1; i++)
+    {
+      std::fill(current + i * N + j0, current + i * N + j1, 0.0f);
+      std::fill(previous + i * N + j0, previous + i * N + j1, 0.0f);
+    }
+
+    tile_active[tile] = 0;
+    tile_quiet[tile]  = 0;
+  }
+
+  tiles_to_sleep.clear();
+
+    //swap time levels, activate woken tiles
+
+  float* tmp = previous;
+  previous = current;
+  current  = tmp;
+
+  for (size_t tile=0, count=TR * TR; tile<count; tile++)
+  {
+    tile_active[tile] |= tile_wake[tile];
+    tile_wake[tile]    = 0;
+  }
+}
+
+void WaterGrid::disturb(size_t i, size_t j)
+{
+    //the cell's own tile, plus the tiles whose stencil reads it (when it lies on a tile edge)
+
+  const size_t T = params.tile_size, TR = tiles_row;
+
+  for (size_t di=0; di<3; di++)
+    for (size_t dj=0; dj<3; dj++)
+    {
+      if (i + di < 1 || j + dj < 1 || i + di > grid_size || j + dj > grid_size)
+        continue;
+
+      size_t ty = (i + di - 1) / T, tx = (j + dj - 1) / T;
+
+      tile_active[ty * TR + tx]  = 1;
+      tile_changed[ty * TR + tx] = 1;
+      tile_quiet[ty * TR + tx]   = 0;
+    }
+}
+
+size_t WaterGrid::active_tiles_count() const
+{
+  size_t count = 0;
+
+  for (uint8_t active : tile_active)
+    count += active;
+
+  return count;
+}
+
+void WaterGrid::clear_changed_tiles()
+{
+  std::fill(tile_changed.begin(), tile_changed.end(), 0);
+}
+
+}}
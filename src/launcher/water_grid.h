@@ -0,0 +1,139 @@
+#pragma once
+
+// Ripple + swell simulation of the water plane (see http://www.gamedev.ru/code/articles/?id=4205).
+//
+// A size x size height field U integrated with the damped 2D wave equation (droplet splashes seed
+// outward-propagating rings), layered over a permanent analytic swell of two crossing travelling
+// waves. Each step also derives the displayed height and the (unnormalized) normal per cell.
+//
+// The swell is separable on the grid: wave 1 depends on the row only, and wave 2,
+// sin(k(0.7x + 0.7z) + wt), splits into sin(a)cos(b) + cos(a)sin(b) with a row term a(x, t) and a
+// time-independent column term b(z). So each step evaluates 3 sines per row (column factors are
+// precomputed once) and the per-cell swell is two multiply-adds, instead of 10 sinf calls per cell.
+// The per-cell integration runs 4 cells at a time through the launcher's simd::float4 (WASM SIMD128,
+// SSE, NEON or scalar). Outputs are plain float arrays (row-major, index i * size + j) so the host
+// can scatter them into vertices, or integrate() advances only the ripples for hosts that upload U as a
+// texture and rebuild the surface in the vertex shader.
+//
+// integrate() is sparse on grids of sparse_min_size cells and more: the field is split into tile_size x
+// tile_size tiles and only active tiles are integrated. A tile wakes when disturb() marks a splash in it or
+// when a neighbour's shared edge carries more than idle_epsilon, and goes idle (both time levels zeroed) once
+// everything in it has stayed below idle_epsilon for two steps. This is an approximation: the sub-epsilon
+// ripples a sleeping tile drops, and those an edge below idle_epsilon does not carry into an idle neighbour,
+// are lost, so the field drifts from a full integration by some multiples of idle_epsilon (water_tiles_bench
+// measures max |dU| ~1e-4 at the default 1e-5 and bounds it). The cost follows the rippling area, not the
+// grid size. Smaller grids (the scene's 160 and 96) are integrated in one exact pass, since their splashes
+// keep most tiles awake and the per-tile bookkeeping costs more than the idle tiles save.
+// changed_tiles() tells the uploader which tiles to diff. step() stays a dense full-grid pass.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+/// Two slow crossing travelling waves: amp1 sin(k1 x + speed1 t) + amp2 sin(k2 (0.7x + 0.7z) + speed2 t)
+struct WaterSwell
+{
+  float amp1   = 0.05f;
+  float len1   = 15.0f;
+  float speed1 = 1.1f;
+  float amp2   = 0.028f;
+  float len2   = 9.0f;
+  float speed2 = 1.7f;
+
+  /// Swell height at world (x, z) and time t (direct evaluation)
+  float height(float x, float z, float t) const;
+};
+
+/// Wave-equation and shading constants
+struct WaterParams
+{
+  float  height_scale     = 0.5f;    // ripple field -> world height
+  float  normal_steepness = 14.0f;   // ripple slope -> normal tilt
+  float  swell_steepness  = 2.2f;    // swell slope -> normal tilt
+  float  min_height       = -1.0f;   // clamp of the displayed height (keeps troughs above the floor)
+  float  viscosity        = 0.11f;   // ripple attenuation per step
+  float  wave_speed       = 0.25f;   // propagation factor (<1 -> calm water)
+  size_t tile_size        = 16;      // sparse integration tile (cells)
+  float  idle_epsilon     = 1.0e-5f; // ripple amplitude below which a tile sleeps / does not wake a neighbour
+  size_t sparse_min_size  = 256;     // smaller grids integrate every cell each step (see integrate)
+  WaterSwell swell;
+};
+
+class WaterGrid
+{
+  public:
+    /// Grid of size x size cells covering [-half_extent, half_extent]^2
+    WaterGrid(size_t size, float half_extent, const WaterParams& params);
+
+    /// Grid geometry
+    size_t size()        const { return grid_size; }
+    float  half_extent() const { return extent; }
+    float  cell_size()   const { return 2.0f * extent / float(grid_size); }
+
+    /// World coordinate of row i (x) or column j (z): half_extent * (1 - 2 * index / size)
+    float coord(size_t index) const { return extent * (1.0f - 2.0f * float(index) / float(grid_size)); }
+
+    /// Current ripple field (splashes are injected here), row-major
+    float*       ripples()       { return current; }
+    const float* ripples() const { return current; }
+
+    /// Advance the swell to time t and integrate one wave-equation step
+    void step(float swell_time);
+
+    /// Integrate one wave-equation step of the ripples (only in the active tiles on a sparse grid; heights/normals
+    /// are not updated; for hosts that add the swell and derive the surface on the GPU)
+    void integrate();
+
+    /// Wake (and flag changed) the tiles around cell (i, j); call after writing ripples() there
+    void disturb(size_t i, size_t j);
+
+    /// Tiling (sparse: only the active tiles are integrated; otherwise every tile, every step)
+    bool   is_sparse()          const { return sparse; }
+    size_t tile_size()          const { return params.tile_size; }
+    size_t tiles_per_row()      const { return tiles_row; }
+    size_t active_tiles_count() const;
+
+    /// Tiles integrated or put to sleep since the last clear_changed_tiles(), tiles_per_row^2 flags
+    const uint8_t* changed_tiles() const { return &tile_changed[0]; }
+    void           clear_changed_tiles();
+
+    /// Derived per-cell displayed height and normal x/z (normal y is 1); border cells stay at rest
+    const float* heights()   const { return &height[0]; }
+    const float* normals_x() const { return &normal_x[0]; }
+    const float* normals_z() const { return &normal_z[0]; }
+
+  private:
+    struct TileEnergy
+    {
+      float all = 0.0f;                                           // max |U(t+1)| over the tile
+      float left = 0.0f, right = 0.0f, top = 0.0f, bottom = 0.0f; // max |U(t+1)| along each edge
+    };
+
+    void       update_swell(float swell_time);
+    TileEnergy integrate_tile(size_t i0, size_t i1, size_t j0, size_t j1);
+    void       integrate_dense();
+
+  private:
+    size_t                grid_size;
+    float                 extent;
+    WaterParams           params;
+    std::vector<float>    field_a, field_b;        // two wave-equation time levels
+    float*                current;                 // U(t)   (n in the original article)
+    float*                previous;                // U(t-1) (p), overwritten with U(t+1) then swapped
+    std::vector<float>    swell;                   // per-cell swell height for the current step
+    std::vector<float>    row_wave1, row_sin2, row_cos2; // per-row swell factors (time-dependent)
+    std::vector<float>    col_cos2, col_sin2;      // per-column swell factors (constant)
+    std::vector<float>    height, normal_x, normal_z;
+    size_t                tiles_row;               // tiles per row (and per column)
+    bool                  sparse;                  // size >= sparse_min_size
+    std::vector<uint8_t>  tile_active;             // integrated this step
+    std::vector<uint8_t>  tile_wake;               // activated for the next step by a neighbour's edge
+    std::vector<uint8_t>  tile_changed;            // touched since clear_changed_tiles()
+    std::vector<uint8_t>  tile_quiet;              // consecutive steps below idle_epsilon
+    std::vector<uint32_t> tiles_to_sleep;          // scratch: tiles decayed this step
+};
+
+}}
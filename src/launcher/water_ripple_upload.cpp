@@ -0,0 +1,176 @@
+#include "water_ripple_upload.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace engine {
+namespace launcher {
+
+WaterRippleUpload::WaterRippleUpload(size_t size, float in_epsilon)
+  : field_size(size)
+  , epsilon(in_epsilon)
+  , full_upload(true)
+  , uploaded(size * size, 0.0f)
+  , uploads(0)
+  , rects_sent(0)
+  , texels_sent(0)
+{
+  staging.reserve(size * size);
+}
+
+void WaterRippleUpload::invalidate()
+{
+  full_upload = true;
+}
+
+void WaterRippleUpload::add_rect(const float* field, size_t x0, size_t x1, size_t y0, size_t y1)
+{
+    //copy the rectangle into the uploaded state and append it to the staging buffer
+
+  const size_t N = field_size, width = x1 - x0;
+
+  TexelRect rect;
+
+  rect.x      = x0;
+  rect.y      = y0;
+  rect.width  = width;
+  rect.height = y1 - y0;
+
+  offsets.push_back(staging.size());
+  rects.push_back(rect);
+
+  staging.resize(staging.size() + rect.width * rect.height);
+
+  float* dst = &staging[offsets.back()];
+
+  for (size_t i=y0; i<y1; i++, dst += width)
+  {
+    const float* src = field + i * N + x0;
+
+    std::memcpy(&uploaded[i * N + x0], src, width * sizeof(float));
+    std::memcpy(dst, src, width * sizeof(float));
+  }
+}
+
+bool WaterRippleUpload::finish()
+{
+  if (rects.empty())
+    return false;
+
+  full_upload = false;
+
+  uploads++;
+  rects_sent += rects.size();
+
+  for (const TexelRect& rect : rects)
+    texels_sent += rect.width * rect.height;
+
+  return true;
+}
+
+bool WaterRippleUpload::pack_full(const float* field)
+{
+  add_rect(field, 0, field_size, 0, field_size);
+
+  return finish();
+}
+
+bool WaterRippleUpload::tile_differs(const float* field, size_t x0, size_t x1, size_t y0, size_t y1) const
+{
+  for (size_t i=y0; i<y1; i++)
+  {
+    const float* src = field + i * field_size;
+    const float* dst = &uploaded[i * field_size];
+
+    for (size_t j=x0; j<x1; j++)
+      if (std::fabs(src[j] - dst[j]) > epsilon)
+        return true;
+  }
+
+  return false;
+}
+
+bool WaterRippleUpload::pack(const float* field)
+{
+  const size_t N = field_size;
+
+  rects.clear();
+  offsets.clear();
+  staging.clear();
+
+  if (full_upload)
+    return pack_full(field);
+
+    //bounding rectangle of the texels that moved past epsilon
+
+  size_t x0 = N, x1 = 0, y0 = N, y1 = 0;
+
+  for (size_t i=0; i<N; i++)
+  {
+    const float* src = field + i * N;
+    const float* dst = &uploaded[i * N];
+
+    size_t first = N, last = 0;
+
+    for (size_t j=0; j<N; j++)
+    {
+      if (std::fabs(src[j] - dst[j]) > epsilon)
+      {
+        if (first == N) first = j;
+        last = j + 1;
+      }
+    }
+
+    if (first == N)
+      continue;
+
+    if (first < x0) x0 = first;
+    if (last > x1)  x1 = last;
+    if (y0 == N)    y0 = i;
+
+    y1 = i + 1;
+  }
+
+  if (y0 != N)
+    add_rect(field, x0, x1, y0, y1);
+
+  return finish();
+}
+
+bool WaterRippleUpload::pack(const float* field, size_t tile_size, const uint8_t* changed_tiles)
+{
+  const size_t N = field_size, T = tile_size, TR = (N + T - 1) / T;
+
+  rects.clear();
+  offsets.clear();
+  staging.clear();
+
+  if (full_upload)
+    return pack_full(field);
+
+    //per tile row: merge runs of changed tiles into one rectangle
+
+  for (size_t ty=0; ty<TR; ty++)
+  {
+    size_t y0 = ty * T, y1 = std::min(y0 + T, N), run = TR;
+
+    for (size_t tx=0; tx<=TR; tx++)
+    {
+      bool dirty = tx < TR && changed_tiles[ty * TR + tx] && tile_differs(field, tx * T, std::min((tx + 1) * T, N), y0, y1);
+
+      if (dirty && run == TR)
+        run = tx;
+
+      if (!dirty && run != TR)
+      {
+        add_rect(field, run * T, std::min(tx * T, N), y0, y1);
+        run = TR;
+      }
+    }
+  }
+
+  return finish();
+}
+
+}}
@@ -0,0 +1,76 @@
+#pragma once
+
+// CPU side of uploading the water ripple field as a single-channel float texture.
+//
+// Keeps a copy of what the GPU texture currently holds. Each pack() diffs the live field against it and
+// packs the texels that moved by more than epsilon into rectangles, each stored contiguously (row-major,
+// width * height floats) ready for one glTexSubImage2D. The plain pack() sends the bounding rectangle of
+// all changes; the tiled pack() only diffs the tiles the sparse simulation flagged and merges runs of
+// changed tiles along a tile row into one rectangle, so far-apart splashes do not upload the water
+// between them. Calm water uploads nothing, and sub-epsilon drift accumulates against the uploaded value
+// until it is worth sending. No GL here: the host owns the texture and calls Texture::set_data per rect.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace launcher {
+
+/// Texel rectangle (x = column, y = row)
+struct TexelRect
+{
+  size_t x = 0, y = 0, width = 0, height = 0;
+
+  bool empty() const { return width == 0 || height == 0; }
+};
+
+class WaterRippleUpload
+{
+  public:
+    /// Tracker for a size x size field; changes up to epsilon are not worth an upload
+    WaterRippleUpload(size_t size, float epsilon);
+
+    /// Field size
+    size_t size() const { return field_size; }
+
+    /// Diff the whole field (row-major, size * size) against the uploaded state and pack the bounding
+    /// rectangle of the changes; returns false if nothing needs uploading
+    bool pack(const float* field);
+
+    /// Diff only the tile_size x tile_size tiles flagged in changed_tiles (ceil(size / tile_size)^2 flags)
+    bool pack(const float* field, size_t tile_size, const uint8_t* changed_tiles);
+
+    /// Rectangles packed by the last successful pack() and their texels
+    size_t           rects_count()         const { return rects.size(); }
+    const TexelRect& rect(size_t index)    const { return rects[index]; }
+    const float*     texels(size_t index)  const { return &staging[offsets[index]]; }
+
+    /// Force the next pack() to send the whole field (e.g. after the texture was recreated)
+    void invalidate();
+
+    /// Statistics: pack() calls that produced an upload, rectangles and texels sent in total
+    size_t uploads_count()   const { return uploads; }
+    size_t rects_uploaded()  const { return rects_sent; }
+    size_t texels_uploaded() const { return texels_sent; }
+
+  private:
+    bool pack_full(const float* field);
+    bool tile_differs(const float* field, size_t x0, size_t x1, size_t y0, size_t y1) const;
+    void add_rect(const float* field, size_t x0, size_t x1, size_t y0, size_t y1);
+    bool finish();
+
+  private:
+    size_t                 field_size;
+    float                  epsilon;
+    bool                   full_upload;   // next pack() sends everything
+    std::vector<float>     uploaded;      // field as the texture holds it
+    std::vector<float>     staging;       // packed rectangles, back to back
+    std::vector<TexelRect> rects;
+    std::vector<size_t>    offsets;       // start of each rectangle in staging
+    size_t                 uploads;
+    size_t                 rects_sent;
+    size_t                 texels_sent;
+};
+
+}}
@@ -1,16 +1,35 @@
 #include "shared.h"
 #include "plant_gen.h"
-
+#include "droplet_brick.h"
+#include "droplet_cohesion.h"
+#include "droplet_pbf.h"
+#include "droplet_tracker.h"
+#include "live_tuning.h"
+#include "water_clipmap.h"
+#include "water_grid.h"
+#include "water_ripple_upload.h"
+
+#include <common/job_system.h>
 #include <common/log.h>
 #include <common/named_dictionary.h>
+#include <common/profiler.h>
 #include <math/utility.h>
 #include <media/sound_player.h>
 
 #include "btBulletDynamicsCommon.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 
+#ifdef WORLD_BULLET_MT
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "LinearMath/btThreads.h"
+#endif
+
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <ctime>
 #include <random>
 
@@ -30,6 +49,7 @@ const char* PLANT_MESH = "media/meshes/fern.obj";
 const size_t CLUSTERIZE_STEPS_COUNT = 3;
 const float CLUSTERIZE_STEP_FACTOR = 1.2;
 const size_t PREFERRED_MAX_DROPLETS_COUNT = 3;
+const float DROPLET_KEEP_FACTOR = 1.5f; // a particle keeps its droplet within this many droplet radii of its centre (hysteresis)
 const float DROPLET_PARTICLE_RADIUS = 0.027f;
 const float DROPLET_PARTICLE_MASS = 0.002f;
 const float DROPLET_RADIUS = DROPLET_PARTICLE_RADIUS * 20.0f;
@@ -51,11 +71,19 @@ const float DROPLET_MAX_FRICTION_FACTOR = 2.;
 const size_t DROPLET_INITIAL_LEAF = 0;
 const float DROPLET_PARTICLE_LINEAR_SLEEPING_THRESHOLD = 1.f;
 const float DROPLET_PARTICLE_ANGULAR_SLEEPING_THRESHOLD = 1.f;
-const size_t DROPLET_CENTER_APPROXIMATION_STEPS_COUNT = 3;
 const size_t DROPLET_GENERATION_INTERVAL = 5 * CLOCKS_PER_SEC;
 const size_t MIN_DROPLET_PARTICLES_COUNT = 10;
 const float MIN_DROPLET_PARTICLE_HEIGHT = -6.f;
 const size_t DROPLET_REMOVE_COUNTER_THRESHOLD = 30;
+// Settling: droplets and leaves at rest skip their per-frame work (cohesion, re-tracking, raymarch
+// upload, light / mesh sync, leaf servo) until a contact, a gust or a grab moves them again
+const size_t SETTLE_FRAMES = 30;                // frames at rest before a droplet / leaf settles
+const float  SETTLE_WAKE_FACTOR = 2.0f;         // a settled one wakes at this multiple of the thresholds below (no flicker at the edge)
+const float  DROPLET_SETTLE_SPEED = 0.03f;      // particle speed at rest (or asleep in Bullet)
+const float  LEAF_SETTLE_SPEED = 0.02f;         // leaf linear...
+const float  LEAF_SETTLE_ANGULAR_SPEED = 0.05f; // ...and angular speed at rest
+const float  LEAF_SETTLE_DISTANCE = 0.002f;     // leaf spring error (body origin to its target) at rest
+const float  LEAF_SETTLE_ANGLE = 0.01f;         // radians
 const float DROPLET_PLANT_GENERATION_HEIGHT = MIN_DROPLET_PARTICLE_HEIGHT + 0.5f;
 
 // Droplet surface: a metaball SDF raymarched in a fragment shader (true concavity/necking/merges,
@@ -69,8 +97,27 @@ const float  DROPLET_RAYMARCH_BOX_MARGIN = 1.08f;                              /
 // Droplet reflection source: true -> the static skybox cubemap (cheap, consistent, and skips the
 // per-droplet dynamic env-map render); false -> a per-droplet cubemap rendered from the cluster centre.
 const bool   DROPLET_REFLECT_SKYBOX = true;
+// Baked droplet field: splat the metaballs into a 3D distance brick per droplet (launcher::DropletBrick)
+// and march it with one texture fetch per step instead of the loop over all particles.
+const bool   DROPLET_SDF_BRICKS = false;                // live via window.DROPLET.bricks
+const float  DROPLET_BRICK_VOXELS_PER_SCREEN = 128.0f;  // brick resolution for a proxy box spanning the view height (clamped to 8..32)
+// Droplet level of detail from the share of the view height its proxy box covers: the full raymarch
+// close up, fewer particles and march steps in between, an analytic sphere (same shading) far away.
+const float  DROPLET_LOD_REDUCED_FRACTION = 0.010f;    // below: reduced; live via window.DROPLET.lodReduced
+const float  DROPLET_LOD_IMPOSTOR_FRACTION = 0.004f;   // below: impostor sphere; live via window.DROPLET.lodImpostor
+const size_t DROPLET_LOD_REDUCED_PARTICLES = 16;
+const int    DROPLET_LOD_FULL_STEPS = 64;              // MUST match MAX_STEPS in droplet_fluid.glsl
+const int    DROPLET_LOD_REDUCED_STEPS = 24;
+// Droplets raymarched at 1/N of the view resolution into an offscreen target and upsampled depth-aware
+// into the view (1: straight into the view); live via window.DROPLET.resolutionDivisor
+const int    DROPLET_RESOLUTION_DIVISOR = 1;
 static size_t PARALLELS_COUNT = 5, MERIDIANS_COUNT = 5; // per-shell spawn grid; total particles = live particles/droplet
-const size_t MAX_PARTICLES_COUNT = 600;                                  // total particle budget (recycled oldest-first when exceeded)
+const size_t MAX_PARTICLES_COUNT = 600;                                  // total particle budget (recycled oldest-first when exceeded); also the pool capacity
+const float  DROPLET_PARK_HEIGHT = -1000.0f;                             // parked (free) pooled particles wait here, far below MIN_DROPLET_PARTICLE_HEIGHT
+const float  DROPLET_PARK_SPACING = 1.0f;                                // between park slots, so parked AABBs never overlap
+const bool   DROPLET_PBF = false;                                        // droplet particles in the position-based fluid solver instead of Bullet spheres; live via window.DROPLET.pbf
+const size_t PBF_MAX_PARTICLES_COUNT = 2000;                             // particle budget of the fluid solver (no rigid bodies -> far above MAX_PARTICLES_COUNT)
+const size_t PBF_ITERATIONS = 3;                                         // density / collision iterations per physics step
 const math::vec3f LEAVES_SCALE(0.1f);
 const math::vec3f PLANT_SCALE(0.005f);
 const float LEAF_MASS = 1.0f;
@@ -80,6 +127,14 @@ const math::vec3f STEAM_POSITION(0, 0, 0);
 const clock_t DEBUG_DUMP_INTERVAL = 5 * CLOCKS_PER_SEC;
 const clock_t PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING = CLOCKS_PER_SEC / 2;
 const size_t PLAY_CONTACT_SOUND_COLLISIONS_COUNT = 5;
+const size_t CONTACT_EVENTS_CAPACITY = 4096;          // droplet/leaf contacts recorded per frame (all substeps); the rest are dropped
+const size_t UPDATE_WORKERS_MAX = 3; // worker threads of the update graph: at most 4 of its phases run at once (Makefile PTHREAD_POOL_SIZE)
+
+// Fixed-rate physics: Bullet (and the water) advance in steps of 1 / PHYSICS_RATE; the renderer draws the
+// bodies interpolated between the last two steps, so 30-45 Hz physics still moves smoothly at 60-120 Hz.
+const float PHYSICS_RATE = 60.0f;          // physics steps per second; live via window.PHYSICS.rate
+const int   PHYSICS_MAX_SUBSTEPS = 4;      // spiral-of-death cap: a longer frame is simulated only this far (slow motion, not a stall); live via window.PHYSICS.maxSubsteps
+const bool  PHYSICS_THREADS = true;        // WORLD_BULLET_MT builds: step Bullet on the job system's workers; live via window.PHYSICS.threads
 
 const float GROUND_SIZE = 50.0f;
 const float GROUND_OFFSET = -7.f;
@@ -121,6 +176,14 @@ const size_t PLANT_MAX_COUNT    = 36;     // cap concurrent plants (vertex/perf
 const float  LEAF_GROW_START       = 0.05f; // leaf scale at spawn (then ramps to 1)
 const float  LEAF_GROW_MIN_SECONDS = 1.5f;  // a leaf unfurls over this..max seconds (random per leaf)
 const float  LEAF_GROW_MAX_SECONDS = 4.5f;
+const uint32_t LEAF_VARIANTS       = 8;     // blade shapes: a leaf's seed is quantized to one of them (LeafBatch)
+const size_t   LEAF_BATCH_CAPACITY = 128;   // leaves per batch mesh, i.e. per draw call
+const float    LEAF_MIN_SHADE      = 0.85f; // per-leaf tint: brightness...
+const float    LEAF_MAX_SHADE      = 1.1f;
+const float    LEAF_MAX_YELLOW     = 0.2f;  // ...and a shift toward yellow
+const float    LEAF_MAX_WILT       = 0.08f; // per-leaf tip droop, in blade lengths (render only)
+const float    LEAF_SHAPE_LENGTH_STEP      = 0.04f;   // leaf collision shapes are shared per variant and length bucket, 4% apart (LeafShapeCache)
+const size_t   LEAF_SHAPE_CACHE_MAX_BYTES  = 1 << 20; // estimated size of the shapes the cache keeps
 const float  DROPLET_SPAWN_ABOVE_LEAF = 0.4f; // spawn the droplet a little above the chosen top leaf
 // branch-skeleton spring joints (tune live): stiffness scales with branch thickness
 const float  JOINT_STIFFNESS_BASE = 1000.0f; // * (mass^2 + eps) per joint; live via window.WIND.stiffness
@@ -131,13 +194,13 @@ const float  WIND_ACCEL           = 10.0f;   // wind acceleration on the branch
 const float WATER_SURFACE_SIZE = GROUND_SIZE * 5.0f; // a sea reaching the horizon (matches the platform extent)
 const float WATER_LEVEL = GROUND_OFFSET + 1.0f;      // water sits ABOVE the platform, so the platform is submerged under it
 const float WATER_SURFACE_OFFSET = WATER_LEVEL;
-const size_t WATER_SURFACE_GRID_SIZE = 160;          // a bit denser so ripples stay smooth on the larger plane
+const size_t WATER_SURFACE_GRID_SIZE = 160;          // ripple field over the whole sea (and the CPU path's vertex grid)
 const float WATER_DEPTH = WATER_LEVEL - GROUND_OFFSET;  // depth of the pool over the platform (used to clamp wave troughs)
 const float WATER_HEIGHT_SCALE = 0.5f;               // small vertical displacement -> gentle ripples, no platform clipping
 const float WATER_NORMAL_STEEPNESS = 14.0f;          // how strongly droplet ripples perturb the normal (lowered -> lighter, softer chop)
 const float WATER_SPLASH_STRENGTH = 0.001f;          // per-particle droplet impact (a droplet = many particles, so they accumulate)
 const float WATER_SPLASH_MAX_DIP = 0.015f;            // cap the per-droplet dip -> a small, clearly-visible impact ring (well below the ~0.08 swell)
-const int   WATER_SPLASH_RADIUS = 1;                 // radius (in grid cells, ~3 world units each) of the impact ring -> a tiny, pin-point footprint (1 cell is the grid floor)
+const int   WATER_SPLASH_RADIUS = 1;                 // radius (in ripple field cells: ~3 world units far, ~1.3 near the tree) of the impact ring -> a tiny, pin-point footprint
 const float WATER_AMBIENT_SPLASH_CHANCE = 0.05f;     // frequent but...
 const float WATER_AMBIENT_SPLASH_STRENGTH = 0.004f;  // ...tiny random ripples, like wind on water
 const float WATER_WAVE_SPEED = 0.25f;                // <1 slows wave propagation -> calm, relaxing water
@@ -151,6 +214,19 @@ const float WATER_SWELL_LEN2   = 9.0f;
 const float WATER_SWELL_SPEED2 = 1.7f;
 const float WATER_SWELL_STEEPNESS = 2.2f;            // how strongly the swell tilts the normal (drives the gentle moving reflection)
 const float WATER_SWELL_TIME_STEP = 0.016f;          // swell clock advance per update (~one frame)
+const float WATER_STEP_RATE = 60.0f;                 // water updates per second: its constants are per step, so it keeps this rate whatever PHYSICS_RATE is
+const int   WATER_MAX_STEPS = 4;                     // spiral-of-death cap of the water accumulator: a longer frame runs at most this many water updates
+const bool  WATER_GPU_DISPLACEMENT = true;           // true: static clipmap mesh, ripples uploaded as float textures, height/normal/swell rebuilt in water.glsl; false: CPU vertex scatter into a uniform grid
+const float WATER_RIPPLE_UPLOAD_EPSILON = 1.0e-5f;   // ripple change below this (x WATER_HEIGHT_SCALE world units) is not worth re-uploading
+const size_t WATER_TILE_SIZE = 16;                   // ripple simulation tile (cells); only changed tiles are uploaded, and on sparse grids only tiles with ripples are integrated
+const float WATER_TILE_IDLE_EPSILON = 1.0e-5f;       // a tile whose ripples all decayed below this goes to sleep
+const size_t WATER_SPARSE_MIN_GRID_SIZE = 256;       // ripple fields from this size integrate sparsely; the 160 and 96 fields keep most tiles awake, so one dense pass is cheaper
+const size_t WATER_NEAR_GRID_SIZE = 96;               // finer ripple field around the tree, where droplets land (GPU displacement only)...
+const float WATER_NEAR_SIZE = GROUND_SIZE * 1.28f;    // ...covering the platform with a margin (half extent 64 -> ~1.3 unit cells)
+const float WATER_NEAR_BLEND = 8.0f;                 // band inside the near field's edge where water.glsl fades it into the far field
+const float WATER_CLIPMAP_CELL = 1.5f;               // finest water mesh cell around the camera (the tree is ~35 units away, still in level 0)
+const size_t WATER_CLIPMAP_RING_CELLS = 32;          // half width of every clipmap level in its own cells
+const size_t WATER_CLIPMAP_LEVELS = 4;               // cells 1.5 .. 12 -> +-384 around the camera, past the old +-250 plane
 const char* WATER_SURFACE_MATERIAL_NAME = "water";
 
 const char* SKY_MATERIAL = "sky";
@@ -175,18 +251,88 @@ const float FIREFLY_LIGHT_RANGE = 2.8f;
 namespace
 {
 
-float frand()
+// the world's own generator (not the global rand()), so World::seed_random makes a run reproducible
+std::minstd_rand random_engine;
+
+float frand(std::minstd_rand& engine = random_engine)
+{
+  return float(engine() - engine.min()) / float(engine.max() - engine.min());
+}
+
+float crand(float min=-1.0f, float max=1.0f, std::minstd_rand& engine = random_engine)
 {
-  return rand() / float(RAND_MAX);
+  return frand(engine) * (max - min) + min;
 }
 
-float crand(float min=-1.0f, float max=1.0f)
+/// Wall time between laps, for WorldPhaseTimings; each lap is also a profiler zone
+class PhaseStopwatch
+{
+  public:
+    PhaseStopwatch() : start(common::profiler::timestamp()) {}
+
+    /// Milliseconds since the previous lap (or construction)
+    double lap(const char* zone)
+    {
+      uint64_t now = common::profiler::timestamp();
+      double   ms  = double(now - start) * 1e-6;
+
+      engine_profile_record(zone, start, now);
+
+      start = now;
+
+      return ms;
+    }
+
+  private:
+    uint64_t start;
+};
+
+/// Milliseconds since a profiler timestamp (the update graph's tasks time their phases; the graph records their zones)
+double milliseconds_since(uint64_t start)
 {
-  return frand() * (max - min) + min;
+  return double(common::profiler::timestamp() - start) * 1e-6;
 }
 
+/// Droplet/leaf contact recorded by the physics steps of a frame (contact_added_callback, the fluid
+/// solver's colliders); World::Impl::drain_contact_events handles them once after the step
+struct ContactEvent
+{
+  const btCollisionObject* droplet; // droplet particle body (null: a fluid particle)
+  const btCollisionObject* leaf;    // leaf body it touched
+  btVector3                point;   // world position of the contact
+  btScalar                 speed;   // approach speed along the contact normal (0: fluid)
+};
+
+/// Preallocated contact records of one frame. The narrowphase (on several threads with WORLD_BULLET_MT)
+/// only claims a slot; records past the capacity are counted and dropped.
+class ContactEventQueue
+{
+  public:
+    ContactEventQueue(size_t capacity) : events(capacity) {}
+
+    void push(const ContactEvent& event)
+    {
+      size_t slot = pushed.fetch_add(1, std::memory_order_relaxed);
+
+      if (slot < events.size())
+        events[slot] = event;
+    }
+
+    size_t        size() const    { return std::min(pushed.load(std::memory_order_relaxed), events.size()); }
+    size_t        dropped() const { return pushed.load(std::memory_order_relaxed) - size(); }
+    ContactEvent* begin()         { return events.data(); }
+    ContactEvent* end()           { return events.data() + size(); }
+
+    void clear() { pushed.store(0, std::memory_order_relaxed); }
+
+  private:
+    std::vector<ContactEvent> events;
+    std::atomic<size_t>       pushed {0};
+};
+
 struct RigidBodyWorldCommonData
 {
+  ContactEventQueue contact_events {CONTACT_EVENTS_CAPACITY};
   size_t leaves_collisions_count = 0;
   clock_t last_leaf_contact_sound_played_time = 0;
 };
@@ -208,7 +354,111 @@ struct RigidBodyInfo
 
 struct DropletParticle
 {
-  bool fallen = false;
+  bool     fallen = false;
+  size_t   pool_slot = 0;                             // index in DropletParticlePool::bodies (fixed park position)
+  uint32_t droplet = launcher::DropletTracker::NONE;  // droplet it was tracked into last frame
+};
+
+#ifdef WORLD_BULLET_MT
+typedef btDiscreteDynamicsWorldMt             DynamicsWorldBase;
+typedef btCollisionDispatcherMt               DynamicsDispatcher;
+typedef btSequentialImpulseConstraintSolverMt DynamicsSolver;
+#else
+typedef btDiscreteDynamicsWorld             DynamicsWorldBase;
+typedef btCollisionDispatcher               DynamicsDispatcher;
+typedef btSequentialImpulseConstraintSolver DynamicsSolver;
+#endif
+
+// Bullet world exposing the fixed-step remainder: the time accumulated towards the next step, which
+// sets how far between the last two physics states the frame is rendered
+class FixedRateDynamicsWorld: public DynamicsWorldBase
+{
+  public:
+    using DynamicsWorldBase::DynamicsWorldBase;
+
+    btScalar step_remainder() const { return m_localTime; }
+};
+
+#ifdef WORLD_BULLET_MT
+
+// Bullet's task scheduler on the world's job system: btDiscreteDynamicsWorldMt hands its narrowphase
+// pairs, simulation islands and body integration to btParallelFor, which lands here as grain-sized
+// ranges spread over the workers (and the stepping thread). Bullet runs them in parallel only when it is
+// built with BT_THREADSAFE=1; otherwise btParallelFor loops inline and this is never called.
+class JobTaskScheduler: public btITaskScheduler
+{
+  public:
+    JobTaskScheduler(common::JobSystem& jobs) : btITaskScheduler("JobSystem"), jobs(jobs) {}
+
+    int  getMaxNumThreads() const override { return int(jobs.workers_count()) + 1; }
+    int  getNumThreads() const override    { return int(jobs.workers_count()) + 1; }
+    void setNumThreads(int) override       {} // the pool is fixed
+
+    void parallelFor(int begin, int end, int grain, const btIParallelForBody& body) override
+    {
+      if (begin >= end)
+        return;
+
+      grain = std::max(grain, 1);
+
+      jobs.parallel_for(0, size_t((end - begin + grain - 1) / grain), 1, [&](size_t chunk) {
+        int first = begin + int(chunk) * grain;
+
+        body.forLoop(first, std::min(first + grain, end));
+      });
+    }
+
+    btScalar parallelSum(int begin, int end, int grain, const btIParallelSumBody& body) override
+    {
+      if (begin >= end)
+        return btScalar(0);
+
+      grain = std::max(grain, 1);
+
+      sums.assign(size_t((end - begin + grain - 1) / grain), btScalar(0));
+
+      jobs.parallel_for(0, sums.size(), 1, [&](size_t chunk) {
+        int first = begin + int(chunk) * grain;
+
+        sums[chunk] = body.sumLoop(first, std::min(first + grain, end));
+      });
+
+      btScalar sum = 0;
+
+      for (btScalar chunk_sum : sums)
+        sum += chunk_sum;
+
+      return sum;
+    }
+
+  private:
+    common::JobSystem&    jobs;
+    std::vector<btScalar> sums; // per chunk (Bullet does not nest parallelSum)
+};
+
+#endif
+
+// The last two fixed-step physics states of a body; rendering draws it in between (at the fraction of
+// the next step already accumulated), one physics step behind the simulation
+struct PhysicsStates
+{
+  btTransform previous;
+  btTransform current;
+
+  void reset(const btTransform& transform) { previous = current = transform; }
+  void push(const btTransform& transform) { previous = current; current = transform; }
+
+  btVector3 origin_at(btScalar alpha) const { return previous.getOrigin().lerp(current.getOrigin(), alpha); }
+
+  btTransform at(btScalar alpha) const
+  {
+    btTransform transform;
+
+    transform.setOrigin(origin_at(alpha));
+    transform.setRotation(previous.getRotation().slerp(current.getRotation(), alpha));
+
+    return transform;
+  }
 };
 
 struct PhysBodySync
@@ -219,6 +469,8 @@ struct PhysBodySync
   std::shared_ptr<btRigidBody> body;
   scene::Mesh::Pointer mesh;
   std::shared_ptr<DropletParticle> droplet_particle;
+  PhysicsStates states; // recorded after every physics step (World::Impl::physics_step_callback)
+  bool settled = false;  // at rest: the mesh is already in place, the sync is skipped
 
   PhysBodySync(
     const std::shared_ptr<btCollisionShape>& shape,
@@ -240,6 +492,7 @@ struct PhysBodySync
     start_transform.setRotation(btQuaternion(rotation[0], rotation[1], rotation[2], rotation[3]));
 
     motion_state = std::make_shared<btDefaultMotionState>(start_transform);
+    states.reset(start_transform);
 
     btRigidBody::btRigidBodyConstructionInfo rb_info(mass, motion_state.get(), shape.get(), btVector3(local_intertia[0], local_intertia[1], local_intertia[2]));
     body = std::make_shared<btRigidBody>(rb_info);
@@ -257,6 +510,322 @@ struct PhysBodySync
   {
     dynamics_world->removeRigidBody(body.get());
   }
+
+  // Copy the transform interpolated between the last two physics steps into the scene mesh
+  void sync_mesh(btScalar alpha)
+  {
+    if (!mesh) // invisible droplet particle (debug draw off) -> nothing to sync
+      return;
+
+    btTransform transform = states.at(alpha);
+
+    mesh->set_position(math::vec3f(transform.getOrigin().getX(), transform.getOrigin().getY(), transform.getOrigin().getZ()));
+    mesh->set_orientation(math::quatf(transform.getRotation().getX(), transform.getRotation().getY(), transform.getRotation().getZ(), transform.getRotation().getW()));
+  }
+};
+
+// Spawn/retire counters of the droplet particle pool (dumped with the droplet debug line)
+struct DropletParticlePoolStats
+{
+  size_t bodies_created = 0; // rigid bodies ever allocated: MAX_PARTICLES_COUNT, all at startup
+  size_t spawned        = 0;
+  size_t retired        = 0;
+  size_t exhausted      = 0; // spawns refused because every body was live
+};
+
+// Fixed-capacity pool of droplet particle bodies. Every body is created and added to the Bullet world
+// once; a free one is parked: simulation disabled, broadphase filter cleared (no pairs, not even with
+// other parked bodies) and moved to its own slot far below the scene. Spawning resets a parked body in
+// place and retiring parks it again, so neither allocates nor creates/destroys broadphase proxies.
+struct DropletParticlePool
+{
+  std::vector<std::shared_ptr<PhysBodySync>> bodies; // all pooled particles (slot = index)
+  std::vector<size_t>                        free;   // parked slots, reused most recently parked first
+  DropletParticlePoolStats                   stats;
+
+  void create(size_t capacity, const std::shared_ptr<btCollisionShape>& shape, const math::vec3f& local_inertia,
+              const scene::Node::Pointer& debug_parent, const media::geometry::Mesh& debug_mesh,
+              const std::shared_ptr<btDiscreteDynamicsWorld>& dynamics_world)
+  {
+    bodies.reserve(capacity);
+    free.reserve(capacity);
+
+    for (size_t slot=0; slot<capacity; slot++)
+    {
+      scene::Mesh::Pointer mesh; // particles are never rendered unless debug-drawing -> don't allocate/sync a scene mesh
+
+      if (DROPLET_DEBUG_DRAW)
+      {
+        mesh = scene::Mesh::create();
+        mesh->set_mesh(debug_mesh);
+        mesh->bind_to_parent(*debug_parent);
+      }
+
+      bodies.push_back(std::make_shared<PhysBodySync>(shape, DROPLET_PARTICLE_MASS, local_inertia, math::vec3f(0.0f), math::quatf(), mesh, COLLISION_GROUP_DROPLET, COLLISION_MASK_DROPLET, dynamics_world));
+
+      PhysBodySync& particle = *bodies.back();
+
+      particle.droplet_particle = std::make_shared<DropletParticle>();
+      particle.droplet_particle->pool_slot = slot;
+
+      park(particle);
+
+      free.push_back(capacity - 1 - slot); // hand out low slots first
+    }
+
+    stats.bodies_created += capacity;
+  }
+
+  // Reset a parked body at position with a fresh velocity/shape; null if every body is live
+  std::shared_ptr<PhysBodySync> spawn(const math::vec3f& position, const std::shared_ptr<btCollisionShape>& shape,
+                                             const btVector3& local_inertia, float friction)
+  {
+    if (free.empty())
+    {
+      stats.exhausted++;
+      return std::shared_ptr<PhysBodySync>();
+    }
+
+    std::shared_ptr<PhysBodySync> particle = bodies[free.back()];
+
+    free.pop_back();
+
+    btRigidBody& body = *particle->body;
+
+    if (particle->shape != shape) // the live physical radius changed since this body last flew
+    {
+      particle->shape = shape;
+      body.setCollisionShape(shape.get());
+    }
+
+    body.setMassProps(DROPLET_PARTICLE_MASS, local_inertia);
+    body.updateInertiaTensor();
+    body.setFriction(friction);
+
+    place(*particle, btVector3(position[0], position[1], position[2]));
+
+    btBroadphaseProxy* proxy = body.getBroadphaseHandle();
+
+    proxy->m_collisionFilterGroup = COLLISION_GROUP_DROPLET;
+    proxy->m_collisionFilterMask  = COLLISION_MASK_DROPLET;
+
+    body.forceActivationState(ACTIVE_TAG);
+    body.setDeactivationTime(0);
+
+    particle->droplet_particle->fallen  = false;
+    particle->droplet_particle->droplet = launcher::DropletTracker::NONE;
+
+    particle->dynamics_world->updateSingleAabb(&body);
+
+    stats.spawned++;
+
+    return particle;
+  }
+
+  void retire(PhysBodySync& particle)
+  {
+    park(particle);
+
+    free.push_back(particle.droplet_particle->pool_slot);
+
+    stats.retired++;
+  }
+
+  private:
+    static btVector3 park_position(size_t slot)
+    {
+      static const size_t ROW = 32;
+
+      return btVector3(float(slot % ROW) * DROPLET_PARK_SPACING, DROPLET_PARK_HEIGHT, float(slot / ROW) * DROPLET_PARK_SPACING);
+    }
+
+    // Teleport a body at rest to origin (identity rotation), including its interpolation states
+    static void place(PhysBodySync& particle, const btVector3& origin)
+    {
+      btRigidBody& body = *particle.body;
+      btTransform  transform;
+
+      transform.setIdentity();
+      transform.setOrigin(origin);
+
+      body.setWorldTransform(transform);
+      body.setInterpolationWorldTransform(transform);
+      body.getMotionState()->setWorldTransform(transform);
+      body.setLinearVelocity(btVector3(0, 0, 0));
+      body.setAngularVelocity(btVector3(0, 0, 0));
+      body.setInterpolationLinearVelocity(btVector3(0, 0, 0));
+      body.setInterpolationAngularVelocity(btVector3(0, 0, 0));
+      body.clearForces();
+
+      particle.states.reset(transform);
+    }
+
+    static void park(PhysBodySync& particle)
+    {
+      btRigidBody&             body = *particle.body;
+      btDiscreteDynamicsWorld& world = *particle.dynamics_world;
+      btBroadphaseProxy*       proxy = body.getBroadphaseHandle();
+
+      body.forceActivationState(DISABLE_SIMULATION);
+
+      proxy->m_collisionFilterGroup = 0;
+      proxy->m_collisionFilterMask  = 0;
+
+      world.getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(proxy, world.getDispatcher()); // drop its contacts
+
+      place(particle, park_position(particle.droplet_particle->pool_slot));
+
+      world.updateSingleAabb(&body); // inactive bodies' AABBs are not refreshed by the step
+    }
+};
+
+// One shared leaf collision shape: the V-trough compound of generate_leaf_collision and its convex hulls
+struct LeafShape
+{
+  std::unique_ptr<btCompoundShape>                compound;
+  std::vector<std::unique_ptr<btConvexHullShape>> hulls;    // the compound's children
+  size_t                                          bytes = 0;
+  uint64_t                                        last_use = 0; // cache clock of the last acquire
+};
+
+// Leaf collision shapes shared by the leaves of one blade variant and length bucket: building the convex
+// hulls is the slow part of spawning a leaf, and a plant's leaves of one variant differ in length only.
+// A shape is built at its bucket's length, within LEAF_SHAPE_LENGTH_STEP / 2 of the leaf's. Bullet keeps
+// the scaling on the shape, not on the body, so a shared shape cannot be rescaled per leaf; the buckets
+// stand in for it. Past LEAF_SHAPE_CACHE_MAX_BYTES the least recently used shapes no body holds are
+// dropped; if every one is held the new shape is handed out uncached.
+struct LeafShapeCache
+{
+  std::unordered_map<uint64_t, std::shared_ptr<LeafShape>> shapes; // by variant and length bucket
+  WorldLeafShapeStats                                       stats;
+  uint64_t                                                  clock = 0;
+
+  // The collision of a leaf of the variant and length (null: the generator gave no piece). The
+  // returned pointer holds the whole LeafShape
+  std::shared_ptr<btCollisionShape> acquire(uint32_t variant, float length)
+  {
+    int      bucket = (int) std::lround(std::log(length) / std::log(1.0f + LEAF_SHAPE_LENGTH_STEP));
+    uint64_t key    = (uint64_t(variant) << 32) | uint32_t(bucket);
+
+    clock++;
+
+    auto it = shapes.find(key);
+
+    if (it != shapes.end())
+    {
+      stats.hits++;
+
+      it->second->last_use = clock;
+
+      return std::shared_ptr<btCollisionShape>(it->second, it->second->compound.get());
+    }
+
+    stats.misses++;
+
+    std::shared_ptr<LeafShape> shape = build(variant, std::pow(1.0f + LEAF_SHAPE_LENGTH_STEP, (float) bucket));
+
+    if (!shape)
+      return std::shared_ptr<btCollisionShape>();
+
+    shape->last_use = clock;
+
+    if (make_room(shape->bytes))
+    {
+      shapes[key] = shape;
+
+      stats.bytes += shape->bytes;
+      stats.shapes = shapes.size();
+    }
+    else
+    {
+      stats.uncached++;
+    }
+
+    return std::shared_ptr<btCollisionShape>(shape, shape->compound.get());
+  }
+
+  private:
+    // Compound collision: a row of convex flaps forming a concave V-channel (see generate_leaf_collision)
+    static std::shared_ptr<LeafShape> build(uint32_t variant, float length)
+    {
+      std::vector<std::vector<math::vec3f>> pieces;
+      launcher::generate_leaf_collision(variant, length, pieces);
+
+      std::shared_ptr<LeafShape> shape = std::make_shared<LeafShape>();
+
+      shape->compound.reset(new btCompoundShape());
+      shape->bytes = sizeof(LeafShape) + sizeof(btCompoundShape);
+
+      btTransform child_tm;
+      child_tm.setIdentity();
+
+      for (const std::vector<math::vec3f>& piece : pieces)
+      {
+        if (piece.size() < 4)
+          continue;
+
+        btConvexHullShape* hull = new btConvexHullShape();
+
+        for (const math::vec3f& point : piece)
+          hull->addPoint(btVector3(point[0], point[1], point[2]), false);
+
+        hull->recalcLocalAabb();
+
+        shape->hulls.emplace_back(hull);
+        shape->compound->addChildShape(child_tm, hull);
+
+        shape->bytes += sizeof(btConvexHullShape) + sizeof(btCompoundShapeChild) + piece.size() * sizeof(btVector3);
+      }
+
+      if (shape->hulls.empty())
+        return std::shared_ptr<LeafShape>();
+
+      return shape;
+    }
+
+    // Drop the least recently used shapes no body holds until bytes more fit (false: they do not)
+    bool make_room(size_t bytes)
+    {
+      while (stats.bytes + bytes > LEAF_SHAPE_CACHE_MAX_BYTES)
+      {
+        auto oldest = shapes.end();
+
+        for (auto it = shapes.begin(); it != shapes.end(); ++it)
+          if (it->second.use_count() == 1 && (oldest == shapes.end() || it->second->last_use < oldest->second->last_use))
+            oldest = it;
+
+        if (oldest == shapes.end())
+          return false;
+
+        stats.bytes -= oldest->second->bytes;
+        stats.evictions++;
+
+        shapes.erase(oldest);
+
+        stats.shapes = shapes.size();
+      }
+
+      return true;
+    }
+};
+
+// Generated leaves of one blade variant drawn as ONE mesh: LEAF_BATCH_CAPACITY copies of the variant's
+// unit-length blade, copy i tagged with instance i in vColor.a. The material's instancePalette holds per
+// instance the rows of its 3x4 transform (the body pose scaled by the blade length and grow-in), then its
+// tint and wilt; leaf.glsl and shadow.glsl place each copy from it. Unused instances have zero matrices
+// and collapse to a point. The engine draws one primitive per draw call and has no GL instancing, so the
+// copies are baked once and only the palette changes.
+struct LeafBatch
+{
+  uint32_t                 variant = 0;
+  math::vec3f              centroid;        // blade centroid at unit length (droplet spawn aim)
+  scene::Mesh::Pointer     mesh;
+  Material                 material;
+  std::string              material_name;
+  std::vector<float>       instances;       // 16 floats per instance: 3 matrix rows, tint rgb + wilt
+  std::unique_ptr<Texture> palette;         // instances on the GPU, 4 texels per instance
+  size_t                   count = 0;       // instances used
+  bool                     dirty = false;   // instances changed since the last upload
 };
 
 struct Leaf
@@ -273,10 +842,13 @@ struct Leaf
   float full_scale = 1.0f;     // mature render/hull scale (the blade's world-length scale)
   float grow_age = 0.0f;       // seconds since the leaf sprouted
   float grow_duration = 0.0f;  // 0 = not a growing generated leaf (e.g. ground), >0 = ramp length
-  std::vector<std::shared_ptr<btCollisionShape>> hull_children; // keep compound children alive
+  float render_scale = 1.0f;   // current blade scale: full_scale once grown
+  LeafBatch* batch = nullptr;  // generated leaf: drawn as this batch's instance (no mesh of its own)
+  size_t instance = 0;
   bool on_skeleton = false;             // pinned to a branch bone (follows the swaying branch)
   btRigidBody* skeleton_bone = nullptr; // the branch bone this leaf rides
   btTransform  rest_local;              // leaf's rest pose in that bone's local frame (spring target tracks it)
+  size_t calm_frames = 0;               // consecutive frames at rest (settles at SETTLE_FRAMES, see phys_body->settled)
 
   Leaf(const clock_t& last_frame_time, RigidBodyWorldCommonData& world_data)
     : rigid_body_info(new RigidBodyInfo(COLLISION_GROUP_LEAF, last_frame_time, world_data))
@@ -291,11 +863,11 @@ struct BoneBody
   std::shared_ptr<btDefaultMotionState> motion;
   std::shared_ptr<btRigidBody>          body;
   std::shared_ptr<btTypedConstraint>    joint; // 6-DOF spring to the parent bone (null for the root)
+  PhysicsStates                         states; // posed in between for the branch mesh
   int   parent = -1;
   float radius_world = 0.1f; // branch radius in world units
   float mass = 0.0f;         // body mass; joint stiffness scales with mass^2 (structural joints >> twig joints)
-  std::vector<media::geometry::Vertex>           verts;   // bone-local, scaled to world units
-  std::vector<media::geometry::Mesh::index_type> indices;
+  btVector3 rest_origin;     // world position of the bone origin at rest (the skinned mesh's bind pose)
 };
 
 struct Plant
@@ -308,12 +880,15 @@ struct Plant
   math::vec3f base_position;   // world position of the plant base
   float age = 0.0f;            // seconds since it sprouted
   float growth = 0.0f;         // g in [0,1] = age / PLANT_GROW_SECONDS
-  float built_growth = -1.0f;  // g the current mesh was built at (rebuild throttle)
+  Material material;           // own "flower" material: its plantGrowth grows the mature mesh in (flower.glsl)
+  std::string material_name;
   std::vector<launcher::LeafSlot> slots; // leaf attachment slots (local space), each with a birth_g
   std::vector<char> slot_spawned;        // whether a physics leaf has been spawned for each slot
   // physics skeleton (built once the plant is fully grown; the branch mesh then follows it)
   bool skeletonized = false;
   std::vector<BoneBody> bones;
+  std::vector<float> bone_matrices;      // per bone: the rows of its posed 3x4 skinning matrix (pose_skeleton)
+  std::unique_ptr<Texture> bone_palette; // bone_matrices on the GPU: the material's bonePalette (3 texels per bone)
 };
 
 struct PlantLight
@@ -321,9 +896,58 @@ struct PlantLight
   scene::PointLight::Pointer point_light;
 };
 
-// Live-tunable droplet knobs. Defaults are the compile-time constants; on the web they are overridden
-// each frame from window.DROPLET.* (the in-page sliders, see dist/index.html) so the look can be tuned
-// without a rebuild. Bake the final values back into the constants above when satisfied.
+// The live-tunable parameters (launcher::TuningRegistry), by index. Defaults are the compile-time
+// constants; the names and ranges are the in-page sliders' (window.GROUP.key, see dist/index.html), so
+// the look can be tuned without a rebuild. Bake the final values back into the constants above when
+// satisfied.
+enum LiveParameter
+{
+  LIVE_METABALL_RADIUS,
+  LIVE_INFLUENCE,
+  LIVE_ISO,
+  LIVE_FORCE,
+  LIVE_DAMPING,
+  LIVE_COHESION_RADIUS,
+  LIVE_PARTICLES_PER_DROPLET,
+  LIVE_PHYSICAL_RADIUS,
+  LIVE_PBF,
+  LIVE_BRICKS,
+  LIVE_LOD_REDUCED,
+  LIVE_LOD_IMPOSTOR,
+  LIVE_RESOLUTION_DIVISOR,
+  LIVE_WIND_ACCEL,
+  LIVE_JOINT_STIFFNESS,
+  LIVE_JOINT_DAMPING,
+  LIVE_PHYSICS_RATE,
+  LIVE_MAX_SUBSTEPS,
+  LIVE_PHYSICS_THREADS,
+
+  LIVE_PARAMETERS_COUNT
+};
+
+const launcher::TuningParameter LIVE_PARAMETERS[LIVE_PARAMETERS_COUNT] = {
+  {"DROPLET.metaballRadius",        0.02f,   0.20f, DROPLET_RAYMARCH_PARTICLE_RADIUS},
+  {"DROPLET.influence",             0.02f,   0.30f, DROPLET_INFLUENCE_RADIUS},
+  {"DROPLET.iso",                  -0.06f,   0.10f, DROPLET_ISO_THRESHOLD},
+  {"DROPLET.force",                  0.0f,    6.0f, DROPLET_SURFACE_TENSION},
+  {"DROPLET.damping",                0.0f,    6.0f, DROPLET_VISCOSITY},
+  {"DROPLET.cohesionRadius",        0.04f,   0.30f, DROPLET_COHESION_RADIUS},
+  {"DROPLET.particlesPerDroplet",   13.0f,  400.0f, 20.0f},
+  {"DROPLET.physicalRadius",       0.015f,   0.15f, DROPLET_PARTICLE_RADIUS},
+  {"DROPLET.pbf",                    0.0f,    1.0f, DROPLET_PBF ? 1.0f : 0.0f},
+  {"DROPLET.bricks",                 0.0f,    1.0f, DROPLET_SDF_BRICKS ? 1.0f : 0.0f},
+  {"DROPLET.lodReduced",             0.0f,    0.2f, DROPLET_LOD_REDUCED_FRACTION},
+  {"DROPLET.lodImpostor",            0.0f,    0.1f, DROPLET_LOD_IMPOSTOR_FRACTION},
+  {"DROPLET.resolutionDivisor",      1.0f,    4.0f, float(DROPLET_RESOLUTION_DIVISOR)},
+  {"WIND.accel",                     0.0f,   50.0f, WIND_ACCEL},
+  {"WIND.stiffness",               100.0f, 8000.0f, JOINT_STIFFNESS_BASE},
+  {"WIND.damping",                   0.0f,    1.0f, JOINT_DAMPING},
+  {"PHYSICS.rate",                  20.0f,  120.0f, PHYSICS_RATE},
+  {"PHYSICS.maxSubsteps",            1.0f,   10.0f, float(PHYSICS_MAX_SUBSTEPS)},
+  {"PHYSICS.threads",                0.0f,    1.0f, PHYSICS_THREADS ? 1.0f : 0.0f},
+};
+
+// Typed copies of the live parameters, re-derived when the registry's version moves
 struct LiveTuning
 {
   float metaball_radius = DROPLET_RAYMARCH_PARTICLE_RADIUS;
@@ -338,17 +962,67 @@ struct LiveTuning
   float wind_accel      = WIND_ACCEL;
   float joint_stiffness = JOINT_STIFFNESS_BASE;
   float joint_damping   = JOINT_DAMPING;
+  int   pbf = DROPLET_PBF ? 1 : 0; // droplet solver: 0 Bullet spheres, 1 position-based fluid
+  int   bricks = DROPLET_SDF_BRICKS ? 1 : 0; // droplet surface: 0 particle loop, 1 baked distance brick
+  float lod_reduced  = DROPLET_LOD_REDUCED_FRACTION;  // view-height shares below which droplets drop
+  float lod_impostor = DROPLET_LOD_IMPOSTOR_FRACTION; // to the reduced raymarch / the impostor sphere
+  int   resolution_divisor = DROPLET_RESOLUTION_DIVISOR; // droplet raymarch at 1/N of the view resolution
+  // fixed-rate physics knobs (window.PHYSICS.*)
+  float physics_rate    = PHYSICS_RATE;
+  int   max_substeps    = PHYSICS_MAX_SUBSTEPS;
+  int   physics_threads = PHYSICS_THREADS ? 1 : 0;
 };
 
-struct Droplet
+// Droplet level of detail (DropletUniforms::lod, lodLevel in droplet_fluid.glsl)
+enum DropletLod
+{
+  DROPLET_LOD_FULL,     // every sampled particle, the full step budget
+  DROPLET_LOD_REDUCED,  // DROPLET_LOD_REDUCED_PARTICLES particles, DROPLET_LOD_REDUCED_STEPS steps
+  DROPLET_LOD_IMPOSTOR  // one sphere (particles[0]) intersected analytically
+};
+
+// Raymarch parameters of a droplet: the DropletBlock uniform block of droplet_fluid.glsl (std140)
+struct DropletUniforms
 {
   math::vec3f center;
-  std::list<math::vec3f> prev_centers;
+  float       box_half_extent = 0.0f;
+  float       influence       = 0.0f;
+  float       iso             = 0.0f;
+  int32_t     particles_count = 0;
+  int32_t     brick_resolution = 0;                      // 0: march the particles, else the distanceBrick texture
+  int32_t     lod             = DROPLET_LOD_FULL;
+  int32_t     max_steps       = DROPLET_LOD_FULL_STEPS;
+  int32_t     padding[2]      = {0, 0};
+  math::vec4f particles[MAX_DROPLET_RAYMARCH_PARTICLES]; // .xyz centre, .w radius; the first particles_count are used
+};
+
+static_assert(sizeof(DropletUniforms) == 48 + 16 * MAX_DROPLET_RAYMARCH_PARTICLES, "DropletUniforms must match the std140 DropletBlock");
+
+// Render side of a tracked droplet. One per tracker slot, reused by the slot's next droplet: the proxy
+// box, the light and the raymarch uniform buffer (the box's user data, updated in place) are created once.
+struct Droplet
+{
+  uint32_t id = launcher::DropletTracker::NONE; // tracker id
+  math::vec3f center;                 // smoothed by the tracker
   std::vector<math::vec3f> points;
-  std::vector<std::shared_ptr<PhysBodySync>> bodies;
+  std::vector<std::shared_ptr<PhysBodySync>> bodies; // Bullet solver: points[i]'s body
+  std::vector<uint32_t> fluid_particles;            // fluid solver: points[i]'s particle (valid this frame)
   scene::Mesh::Pointer hull_mesh; // the droplet's proxy-box render node (name kept for minimal churn)
   scene::PointLight::Pointer point_light;
-  size_t remove_counter = 0;
+  DropletUniforms raymarch;                 // the raymarch block as last written
+  size_t raymarch_dirty_begin = 0;          // bytes of raymarch changed since the last upload
+  size_t raymarch_dirty_end = sizeof(DropletUniforms);
+  UniformBuffer* raymarch_buffer = nullptr; // hull_mesh's user data, created by the first upload (GL: main thread)
+  launcher::DropletBrick brick;             // baked field (DROPLET_SDF_BRICKS), splatted on a worker
+  bool brick_dirty = false;                 // brick splatted since the last upload
+  Texture* brick_texture = nullptr;         // hull_mesh's user data, re-created when the resolution changes
+  bool visible = false;                     // hull_mesh wanted in the scene (set by the tracking task)
+  bool shown = false;                       // hull_mesh bound to the scene (apply_droplet_tracking)
+  bool settled = false;                     // at rest: no cohesion, re-tracking, raymarch upload or light update
+  size_t calm_frames = 0;                   // consecutive frames at rest
+  size_t settled_particles = 0;             // particles count when it settled (a change wakes it)
+  size_t held_particles = 0;                // particles held at rest this frame (not re-tracked)
+  bool woken = false;                       // one of its particles moved this frame
 };
 
 struct Firefly
@@ -415,20 +1089,19 @@ bool contact_added_callback (btManifoldPoint& contact_point,
     return false;
   }
 
-  RigidBodyInfo *not_droplet_body_info = body0_info->collision_group == COLLISION_GROUP_DROPLET ? body1_info : body0_info; 
-  
-  if (not_droplet_body_info->last_frame_time - not_droplet_body_info->prev_droplet_contact_time > PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING)
-  {
-    if (body0_info->world_data) body0_info->world_data->leaves_collisions_count++;
-    if (body1_info->world_data) body1_info->world_data->leaves_collisions_count++;
+  //this runs inside the narrowphase (on its threads with WORLD_BULLET_MT): only record the contact, the
+  //world handles the frame's contacts after the step
 
-    //engine_log_debug("leaf collisions %d", body0_info->world_data->leaves_collisions_count);
+  bool droplet_first = body0_info->collision_group == COLLISION_GROUP_DROPLET;
 
-//    engine_log_info("New contact added with group %d at position %f %f %f", not_droplet_body_info->collision_group, contact_point.getPositionWorldOnA().getX(), contact_point.getPositionWorldOnA().getY(), contact_point.getPositionWorldOnA().getZ());
-    //media::sound::SoundPlayer::play_sound(media::sound::SoundId::droplet_leaf);
-  }
+  const btCollisionObject *droplet = droplet_first ? object0->m_collisionObject : object1->m_collisionObject,
+                          *leaf    = droplet_first ? object1->m_collisionObject : object0->m_collisionObject;
 
-  not_droplet_body_info->prev_droplet_contact_time = not_droplet_body_info->last_frame_time;
+  btVector3 relative_velocity = btRigidBody::upcast(object0->m_collisionObject)->getLinearVelocity() -
+                                btRigidBody::upcast(object1->m_collisionObject)->getLinearVelocity();
+
+  if (body0_info->world_data)
+    body0_info->world_data->contact_events.push({droplet, leaf, contact_point.getPositionWorldOnA(), btFabs(relative_velocity.dot(contact_point.m_normalWorldOnB))});
 
   return false;
 }
@@ -438,163 +1111,311 @@ struct PairHasher
   size_t operator()(const std::pair<int, int>& v) const { return size_t(v.first * v.second); }
 };
 
-struct Field
+launcher::WaterParams water_params()
 {
-  float U[WATER_SURFACE_GRID_SIZE][WATER_SURFACE_GRID_SIZE];
-
-  Field()
-  {
-    memset(U, 0, sizeof(U));
-  }  
-};
+  launcher::WaterParams params;
+
+  params.height_scale     = WATER_HEIGHT_SCALE;
+  params.normal_steepness = WATER_NORMAL_STEEPNESS;
+  params.swell_steepness  = WATER_SWELL_STEEPNESS;
+  params.min_height       = -(WATER_DEPTH - 0.15f); // keep wave troughs just above the submerged platform
+  params.viscosity        = 0.110f;                 // higher viscosity -> droplet ripples attenuate (fade) faster
+  params.wave_speed       = WATER_WAVE_SPEED;
+  params.tile_size        = WATER_TILE_SIZE;
+  params.idle_epsilon     = WATER_TILE_IDLE_EPSILON;
+  params.sparse_min_size  = WATER_SPARSE_MIN_GRID_SIZE;
+  params.swell.amp1       = WATER_SWELL_AMP1;
+  params.swell.len1       = WATER_SWELL_LEN1;
+  params.swell.speed1     = WATER_SWELL_SPEED1;
+  params.swell.amp2       = WATER_SWELL_AMP2;
+  params.swell.len2       = WATER_SWELL_LEN2;
+  params.swell.speed2     = WATER_SWELL_SPEED2;
+
+  return params;
+}
 
-//see http://www.gamedev.ru/code/articles/?id=4205 for details
-struct WaterSurface
+// One simulated ripple field, world-anchored at the origin, and its texture copy (GPU displacement)
+struct WaterRippleField
 {
-  Field A;
-  Field B;
-  Field* p;
-  Field* n;
-  media::geometry::Mesh mesh;
-  scene::Mesh::Pointer mesh_node;
-  float swell_time = 0.0f; // clock for the permanent procedural swell
+  launcher::WaterGrid grid;
+  launcher::WaterRippleUpload upload;   // changed-tile packing of the field for the texture
+  std::unique_ptr<Texture> texture;     // ripple field U, one R16F texel per grid cell
 
-  // Permanent swell height at world (wx,wz): two slow crossing traveling waves -> a gentle, never-still surface
-  static float swell_height(float wx, float wz, float t)
+  WaterRippleField(size_t size, float half_extent)
+    : grid(size, half_extent, water_params())
+    , upload(size, WATER_RIPPLE_UPLOAD_EPSILON)
   {
-    const float k1 = 6.2831853f / WATER_SWELL_LEN1;
-    const float k2 = 6.2831853f / WATER_SWELL_LEN2;
-    return WATER_SWELL_AMP1 * sinf(wx * k1 + t * WATER_SWELL_SPEED1)
-         + WATER_SWELL_AMP2 * sinf((wx * 0.7f + wz * 0.7f) * k2 + t * WATER_SWELL_SPEED2);
   }
 
-  WaterSurface()
+  void create_texture(Device& device)
   {
-    p = &A;
-    n = &B;
-
-    const size_t INDICES_GRID_SIZE = WATER_SURFACE_GRID_SIZE - 1;
+    size_t size = grid.size();
 
-    mesh.vertices_resize(WATER_SURFACE_GRID_SIZE * WATER_SURFACE_GRID_SIZE);
-    mesh.indices_resize(INDICES_GRID_SIZE * INDICES_GRID_SIZE * 6);
-
-    Vertex* v = mesh.vertices_data();
-
-    for (size_t i=0; i<WATER_SURFACE_GRID_SIZE; i++)
-    {
-      for (size_t j=0; j<WATER_SURFACE_GRID_SIZE; j++, v++)
-      {
-          v->position  = math::vec3f(WATER_SURFACE_SIZE * (1.0f - 2.0f * i / float(WATER_SURFACE_GRID_SIZE)), 0, WATER_SURFACE_SIZE * (1.0f - 2.0f * j / float(WATER_SURFACE_GRID_SIZE)));
-          v->normal    = math::vec3f(0, 1, 0);
-        v->color     = math::vec4f(1.0f);
-        v->tex_coord = math::vec2f(j / float(WATER_SURFACE_GRID_SIZE), i / float(WATER_SURFACE_GRID_SIZE));
-      }
-    }
-
-    media::geometry::Mesh::index_type* ind = mesh.indices_data();
+    texture = std::make_unique<Texture>(device.create_texture2d(size, size, PixelFormat_R16F, 1));
 
-    for (size_t i=0; i<INDICES_GRID_SIZE; i++)
-    {
-      int row_vertex_offset = i * WATER_SURFACE_GRID_SIZE;
-
-      for (size_t j=0; j<INDICES_GRID_SIZE; j++, ind += 6)
-      {
-        ind[0] = row_vertex_offset + j;
-        ind[1] = row_vertex_offset + j + 1;
-        ind[2] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE;
-        ind[3] = row_vertex_offset + j + 1;
-        ind[4] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE + 1;
-        ind[5] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE;
-      }
-    }
-
-    mesh.add_primitive(WATER_SURFACE_MATERIAL_NAME, media::geometry::PrimitiveType_TriangleList, 0, mesh.indices_count() / 3, 0);
-
-    mesh_node = scene::Mesh::create();
+    texture->set_min_filter(TextureFilter_Linear); // clipmap vertices fall between texels
+    texture->set_mag_filter(TextureFilter_Linear);
 
-    mesh_node->set_mesh(mesh);
-    mesh_node->set_planar_reflection_required(true); // flat mirror: planar reflection + refraction render targets
-    mesh_node->set_position(math::vec3f(0, WATER_SURFACE_OFFSET, 0));
-    mesh_node->set_scale(math::vec3f(1.0f)); // world scale is baked into the vertices, so the node stays uniform -> normals transform correctly
+    upload.invalidate();
   }
 
-  // Inject a ripple where a droplet hits the water. world_x/world_z are mapped back to the grid cell.
+  // Dip the cells around world (x, z); world_x/world_z are mapped back to the grid cell
   void splash(float world_x, float world_z, float strength)
   {
-    int ci = int((1.0f - world_x / WATER_SURFACE_SIZE) * 0.5f * float(WATER_SURFACE_GRID_SIZE) + 0.5f);
-    int cj = int((1.0f - world_z / WATER_SURFACE_SIZE) * 0.5f * float(WATER_SURFACE_GRID_SIZE) + 0.5f);
+    const int   N = int(grid.size());
+    const float E = grid.half_extent();
+
+    int ci = int((1.0f - world_x / E) * 0.5f * float(N) + 0.5f);
+    int cj = int((1.0f - world_z / E) * 0.5f * float(N) + 0.5f);
 
     const int R = WATER_SPLASH_RADIUS;
     for (int di=-R; di<=R; di++)
       for (int dj=-R; dj<=R; dj++)
       {
         int i = ci + di, j = cj + dj;
-        if (i < 1 || i >= int(WATER_SURFACE_GRID_SIZE) - 1 || j < 1 || j >= int(WATER_SURFACE_GRID_SIZE) - 1)
+        if (i < 1 || i >= N - 1 || j < 1 || j >= N - 1)
           continue;
         float falloff = 1.0f - float(di*di + dj*dj) / float(R*R + 1); // smooth, peak = strength at the center
         if (falloff < 0.0f) continue;
-        float& u = n->U[i][j];
+        float& u = grid.ripples()[i * N + j];
         u -= falloff * strength;                              // a dip seeds an outward-propagating ring
         if (u < -WATER_SPLASH_MAX_DIP) u = -WATER_SPLASH_MAX_DIP; // ...but overlapping impacts of one droplet's particles can't dig a deep crater
+        grid.disturb(i, j);                                   // wake the sparse simulation's tiles here
       }
   }
 
-  void update()
+  // Send the changed tiles of the field to the texture
+  void flush()
   {
-      //integrate the wave equation; ripples come from droplet impacts (splash()) plus an occasional faint random one
-
-    if (frand() < WATER_AMBIENT_SPLASH_CHANCE)
-      splash(crand() * WATER_SURFACE_SIZE * 0.85f, crand() * WATER_SURFACE_SIZE * 0.85f, WATER_AMBIENT_SPLASH_STRENGTH);
+    if (texture && upload.pack(grid.ripples(), grid.tile_size(), grid.changed_tiles()))
+    {
+      for (size_t i=0, count=upload.rects_count(); i<count; i++)
+      {
+        const launcher::TexelRect& rect = upload.rect(i);
+
+        texture->set_data(0, rect.x, rect.y, rect.width, rect.height, upload.texels(i));
+      }
+    }
+
+    grid.clear_changed_tiles();
+  }
+};
+
+//see http://www.gamedev.ru/code/articles/?id=4205 for details; the simulation itself lives in water_grid.cpp
+struct WaterSurface
+{
+  WaterRippleField far_field;                   // the whole sea (also the CPU vertex path's grid)
+  WaterRippleField near_field;                  // finer ripples where droplets land (GPU displacement only)
+  launcher::WaterClipmap clipmap;               // camera-centred LOD mesh layout (GPU displacement only)
+  PropertyMap shader_properties;                // the water material's properties (shared, updated in place)
+  media::geometry::Mesh mesh;
+  scene::Mesh::Pointer mesh_node;
+  float swell_time = 0.0f; // clock for the permanent procedural swell
+  std::minstd_rand random; // ambient splashes: its own generator (seeded from the world's), as update() runs on a worker
+
+  static launcher::WaterClipmapParams clipmap_params()
+  {
+    launcher::WaterClipmapParams params;
+
+    params.cell_size  = WATER_CLIPMAP_CELL;
+    params.ring_cells = WATER_CLIPMAP_RING_CELLS;
+    params.levels     = WATER_CLIPMAP_LEVELS;
+
+    return params;
+  }
+
+  WaterSurface()
+    : far_field(WATER_SURFACE_GRID_SIZE, WATER_SURFACE_SIZE)
+    , near_field(WATER_NEAR_GRID_SIZE, WATER_NEAR_SIZE)
+    , clipmap(clipmap_params())
+    , random(random_engine())
+  {
+    if (WATER_GPU_DISPLACEMENT) build_clipmap_mesh();
+    else                        build_grid_mesh();
+
+    mesh_node = scene::Mesh::create();
+
+    mesh_node->set_mesh(mesh);
+    mesh_node->set_planar_reflection_required(true); // flat mirror: planar reflection + refraction render targets
+    mesh_node->set_position(math::vec3f(0, WATER_SURFACE_OFFSET, 0));
+    mesh_node->set_scale(math::vec3f(1.0f)); // world scale is baked into the vertices, so the node stays uniform -> normals transform correctly
+  }
+
+  // Static clipmap mesh around the origin; the node follows the camera (see upload()) and water.glsl
+  // samples the ripple fields at the world position. tex_coord.x carries the level's cell size.
+  void build_clipmap_mesh()
+  {
+    const std::vector<launcher::WaterClipmapVertex>& vertices = clipmap.vertices();
+    const std::vector<uint16_t>&                     indices  = clipmap.indices();
+
+    mesh.vertices_resize(vertices.size());
+    mesh.indices_resize(indices.size());
+
+    Vertex* v = mesh.vertices_data();
+
+    for (const launcher::WaterClipmapVertex& src : vertices)
+    {
+      v->position  = math::vec3f(src.x, 0, src.z);
+      v->normal    = math::vec3f(0, 1, 0);
+      v->color     = math::vec4f(1.0f);
+      v->tex_coord = math::vec2f(src.cell, 0.0f);
+      v++;
+    }
+
+    std::copy(indices.begin(), indices.end(), mesh.indices_data());
+
+    mesh.add_primitive(WATER_SURFACE_MATERIAL_NAME, media::geometry::PrimitiveType_TriangleList, 0, indices.size() / 3, 0);
+  }
+
+  // One vertex per far-field cell, displaced on the CPU by update()
+  void build_grid_mesh()
+  {
+    const size_t INDICES_GRID_SIZE = WATER_SURFACE_GRID_SIZE - 1;
+
+    mesh.vertices_resize(WATER_SURFACE_GRID_SIZE * WATER_SURFACE_GRID_SIZE);
+    mesh.indices_resize(INDICES_GRID_SIZE * INDICES_GRID_SIZE * 6);
+
+    Vertex* v = mesh.vertices_data();
+
+    for (size_t i=0; i<WATER_SURFACE_GRID_SIZE; i++)
+    {
+      for (size_t j=0; j<WATER_SURFACE_GRID_SIZE; j++, v++)
+      {
+          v->position  = math::vec3f(WATER_SURFACE_SIZE * (1.0f - 2.0f * i / float(WATER_SURFACE_GRID_SIZE)), 0, WATER_SURFACE_SIZE * (1.0f - 2.0f * j / float(WATER_SURFACE_GRID_SIZE)));
+          v->normal    = math::vec3f(0, 1, 0);
+        v->color     = math::vec4f(1.0f);
+        v->tex_coord = math::vec2f(far_field.grid.cell_size(), 0.0f); // unused with waterDisplacement = 0
+      }
+    }
+
+    media::geometry::Mesh::index_type* ind = mesh.indices_data();
+
+      //16-bit indices: grids past ~255^2 vertices are split into horizontal bands, one primitive each,
+      //addressing their rows from base_vertex (a single band for the default grid)
+
+    const size_t BAND_QUAD_ROWS = std::min(INDICES_GRID_SIZE, size_t(65535) / WATER_SURFACE_GRID_SIZE - 1);
+
+    for (size_t band_first=0; band_first<INDICES_GRID_SIZE; band_first += BAND_QUAD_ROWS)
+    {
+      size_t band_rows = std::min(BAND_QUAD_ROWS, INDICES_GRID_SIZE - band_first);
+
+      for (size_t i=0; i<band_rows; i++)
+      {
+        int row_vertex_offset = i * WATER_SURFACE_GRID_SIZE;
+
+        for (size_t j=0; j<INDICES_GRID_SIZE; j++, ind += 6)
+        {
+          ind[0] = row_vertex_offset + j;
+          ind[1] = row_vertex_offset + j + 1;
+          ind[2] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE;
+          ind[3] = row_vertex_offset + j + 1;
+          ind[4] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE + 1;
+          ind[5] = row_vertex_offset + j + WATER_SURFACE_GRID_SIZE;
+        }
+      }
+
+      mesh.add_primitive(WATER_SURFACE_MATERIAL_NAME, media::geometry::PrimitiveType_TriangleList, band_first * INDICES_GRID_SIZE * 2,
+        band_rows * INDICES_GRID_SIZE * 2, band_first * WATER_SURFACE_GRID_SIZE);
+    }
+  }
+
+  // Create the ripple textures and publish the shader constants on the water material
+  void bind_material(Device& device, Material& material)
+  {
+    far_field.create_texture(device);
+    near_field.create_texture(device);
+
+    TextureList textures = material.textures();
+    textures.insert("rippleTexture", *far_field.texture);
+    textures.insert("rippleNearTexture", *near_field.texture);
+
+    const float TWO_PI = 6.2831853f;
+
+    shader_properties = material.properties();
+
+    shader_properties.set("waterDisplacement", WATER_GPU_DISPLACEMENT ? 1.0f : 0.0f);
+    shader_properties.set("waterRipple", math::vec4f(WATER_HEIGHT_SCALE, WATER_NORMAL_STEEPNESS, WATER_SWELL_STEEPNESS, -(WATER_DEPTH - 0.15f)));
+    shader_properties.set("waterSwell1", math::vec3f(WATER_SWELL_AMP1, TWO_PI / WATER_SWELL_LEN1, WATER_SWELL_SPEED1));
+    shader_properties.set("waterSwell2", math::vec3f(WATER_SWELL_AMP2, TWO_PI / WATER_SWELL_LEN2, WATER_SWELL_SPEED2));
+    shader_properties.set("waterGrid", math::vec3f(swell_time, WATER_SURFACE_SIZE, 1.0f / float(WATER_SURFACE_GRID_SIZE)));
+    shader_properties.set("waterNearGrid", math::vec3f(WATER_NEAR_SIZE, 1.0f / float(WATER_NEAR_GRID_SIZE), WATER_NEAR_BLEND));
+  }
+
+  // Inject a ripple where a droplet hits the water: into the near field if it is well inside it
+  // (its outer band fades into the far field in the shader), into the far field otherwise
+  void splash(float world_x, float world_z, float strength)
+  {
+    const float NEAR_INNER = WATER_NEAR_SIZE - WATER_NEAR_BLEND;
+
+    if (WATER_GPU_DISPLACEMENT && std::fabs(world_x) < NEAR_INNER && std::fabs(world_z) < NEAR_INNER)
+      near_field.splash(world_x, world_z, strength);
+    else
+      far_field.splash(world_x, world_z, strength);
+  }
+
+  void update()
+  {
+      //integrate the wave equation; ripples come from droplet impacts (splash()) plus an occasional faint random one
+
+    if (frand(random) < WATER_AMBIENT_SPLASH_CHANCE)
+      splash(crand(-1.0f, 1.0f, random) * WATER_SURFACE_SIZE * 0.85f, crand(-1.0f, 1.0f, random) * WATER_SURFACE_SIZE * 0.85f, WATER_AMBIENT_SPLASH_STRENGTH);
 
     swell_time += WATER_SWELL_TIME_STEP; // advance the permanent swell
 
-    const float MIN_HEIGHT = -(WATER_DEPTH - 0.15f); // keep wave troughs just above the submerged platform
-    const float CELL = 2.0f * WATER_SURFACE_SIZE / float(WATER_SURFACE_GRID_SIZE); // world distance between adjacent grid cells
+    if (WATER_GPU_DISPLACEMENT)
+    {
+      far_field.grid.integrate(); // ripples of the active tiles only; the swell and the surface are rebuilt in the vertex shader (see upload())
+      near_field.grid.integrate();
+      return;
+    }
+
+    launcher::WaterGrid& grid = far_field.grid;
+
+    grid.step(swell_time);
 
+      //scatter the derived heights/normals into the interleaved vertices (border vertices stay flat).
+      //no CPU normalize: the water shader normalizes worldNormal, and the node scale is uniform, so
+      //direction is preserved
+
+    const float* heights   = grid.heights();
+    const float* normals_x = grid.normals_x();
+    const float* normals_z = grid.normals_z();
     Vertex* verts = mesh.vertices_data();
 
     for (size_t i=1; i<WATER_SURFACE_GRID_SIZE-1; i++)
     {
+      size_t row = i * WATER_SURFACE_GRID_SIZE;
+
       for (size_t j=1; j<WATER_SURFACE_GRID_SIZE-1; j++)
       {
-        //grid cell (i,j) lives at vertex i*N+j (matching the constructor's row-major layout)
-        Vertex* v = &verts[i * WATER_SURFACE_GRID_SIZE + j];
-
-        //permanent swell: sample height + neighbours (x decreases as i grows, z decreases as j grows -> matches the splash differences below)
-        float wx = v->position.x, wz = v->position.z;
-        float S   = swell_height(wx, wz, swell_time);
-        float Sim = swell_height(wx + CELL, wz, swell_time); // i-1
-        float Sip = swell_height(wx - CELL, wz, swell_time); // i+1
-        float Sjm = swell_height(wx, wz + CELL, swell_time); // j-1
-        float Sjp = swell_height(wx, wz - CELL, swell_time); // j+1
-
-        float h = n->U[i][j] * WATER_HEIGHT_SCALE + S;
-        v->position.y = h < MIN_HEIGHT ? MIN_HEIGHT : h;
-        v->normal.x   = (n->U[i-1][j]-n->U[i+1][j]) * WATER_NORMAL_STEEPNESS + (Sim - Sip) * WATER_SWELL_STEEPNESS;
-        v->normal.y   = 1.0f;
-        v->normal.z   = (n->U[i][j-1]-n->U[i][j+1]) * WATER_NORMAL_STEEPNESS + (Sjm - Sjp) * WATER_SWELL_STEEPNESS;
-        // no CPU normalize: the water shader normalizes worldNormal, and the node scale is uniform, so
-        // direction is preserved -> save ~25k sqrt/frame
-
-        constexpr float VIS = 0.110f; // higher viscosity -> droplet ripples attenuate (fade) faster
-
-        float laplas=(n->U[i-1][j]+
-                    n->U[i+1][j]+
-                n->U[i][j+1]+
-                n->U[i][j-1])*0.25f-n->U[i][j];
-
-        p->U[i][j] = ((2.0f-VIS) * n->U[i][j] - p->U[i][j] * (1.0f-VIS) + laplas * WATER_WAVE_SPEED);
+        Vertex& v = verts[row + j];
+
+        v.position.y = heights[row + j];
+        v.normal.x   = normals_x[row + j];
+        v.normal.z   = normals_z[row + j];
       }
     }
 
-      //swap fields
-
-    std::swap(p, n);
-
       //invalidate mesh
 
     mesh.touch();
   }
+
+  // Once per frame after the substeps: move the clipmap under the camera, send the changed tiles of
+  // both ripple fields and the swell clock (GPU displacement mode; the mesh itself is never re-uploaded)
+  void upload(const math::vec3f& camera_position)
+  {
+    if (!WATER_GPU_DISPLACEMENT || !far_field.texture)
+      return;
+
+    if (clipmap.set_viewer(camera_position.x, camera_position.z))
+      mesh_node->set_position(math::vec3f(clipmap.center_x(), WATER_SURFACE_OFFSET, clipmap.center_z()));
+
+    far_field.flush();
+    near_field.flush();
+
+    shader_properties.set("waterGrid", math::vec3f(swell_time, WATER_SURFACE_SIZE, 1.0f / float(WATER_SURFACE_GRID_SIZE)));
+  }
 };
 
 }
@@ -605,22 +1426,38 @@ struct World::Impl: RigidBodyWorldCommonData
   media::geometry::Model plant_model;
   scene::Node::Pointer scene_root;
   scene::Camera::Pointer camera;
+  Device render_device;
+  PropertyMap render_properties; // the renderer's shared properties (render settings the passes read)
   std::shared_ptr<btDefaultCollisionConfiguration> collision_configuration;
   std::shared_ptr<btCollisionDispatcher> dispatcher;
   std::shared_ptr<btBroadphaseInterface> broadphase;
+#ifdef WORLD_BULLET_MT
+  std::shared_ptr<btConstraintSolverPoolMt> solver_pool; // one solver per thread stepping islands
+#endif
   std::shared_ptr<btSequentialImpulseConstraintSolver> solver;
-  std::shared_ptr<btDiscreteDynamicsWorld> dynamics_world;
+  std::shared_ptr<FixedRateDynamicsWorld> dynamics_world;
   std::shared_ptr<btCollisionShape> ground_shape;
   std::shared_ptr<btCollisionShape> droplet_particle_shape;
+  float droplet_particle_shape_radius = DROPLET_PARTICLE_RADIUS;
   std::shared_ptr<btCollisionShape> static_bind_shape;
   std::vector<std::shared_ptr<PhysBodySync>> phys_bodies;
   media::geometry::Mesh droplet_debug_particle_mesh;
   math::vec3f droplet_particle_local_intertia;
   common::NamedDictionary<std::shared_ptr<btCollisionShape>> convex_shapes;
+  LeafShapeCache leaf_shapes; // generated leaves' collision shapes
   std::vector<Leaf> leaves;
+  std::vector<size_t> top_leaves; // generate_droplet's pick of the highest leaves (kept so spawning reuses its storage)
+  DropletParticlePool droplet_particle_pool; // every droplet particle body; live ones are also in droplet_particles
   std::vector<std::shared_ptr<PhysBodySync>> droplet_particles;
-  std::vector<std::shared_ptr<Droplet>> droplets;
-  std::vector<btVector3> st_pos, st_vel, st_acc; // reused scratch for pairwise surface-tension (no per-frame alloc)
+  bool fluid_active = DROPLET_PBF;                 // droplet particles live in fluid (position-based) instead of droplet_particles (Bullet)
+  launcher::PbfSolver fluid;
+  std::vector<launcher::PbfCollider> fluid_colliders; // one per phys_bodies entry (ground + leaves), refreshed every physics step
+  std::vector<std::shared_ptr<Droplet>> droplets;      // live droplets, in tracker order (oldest first)
+  std::vector<std::shared_ptr<Droplet>> droplet_slots; // by tracker slot
+  std::vector<uint32_t> created_droplet_slots;         // slots the tracking task created, lit by apply_droplet_tracking
+  launcher::CohesionParticles cohesion_particles; // reused SoA scratch for pairwise surface tension (no per-frame alloc)
+  launcher::CohesionSolver cohesion;              // cell-list neighbour search + cohesion/viscosity kernel
+  launcher::DropletTracker droplet_tracker; // particle->droplet tracking with stable droplet ids
   Material droplet_material;
   Material droplet_fluid_material;
   Material sky_material;
@@ -628,11 +1465,15 @@ struct World::Impl: RigidBodyWorldCommonData
   Material flower_material; // procedural flowers/branches (vertex-colour lit; tag "flower")
   Material leaf_render_material; // generated leaves, textured with the real leaf_color.png (tag ""/forward_lighting)
   std::vector<std::shared_ptr<Plant>> plants;
+  MaterialList plant_materials; // the renderer's material list; a growing plant and a leaf batch add their own material
+  std::vector<std::unique_ptr<LeafBatch>> leaf_batches; // generated leaves, by blade variant (leaf_batch)
+  size_t plants_created = 0;    // names the plants' materials
   float wind_time = 0.0f; // accumulates dt; drives the wind gusts on the branch skeleton
   btRigidBody* grabbed_object;
   btVector3 grabbed_object_pos_world;
   btVector3 grabbed_object_pos_local;
-  clock_t last_frame_time = 0;
+  double world_time = 0.0;     // seconds of update() dt so far; the game clock (reproducible, unlike clock())
+  clock_t last_frame_time = 0; // world_time in clock ticks
   clock_t last_droplet_generated_time = 0;
   clock_t last_debug_dump_time = 0;
   RigidBodyInfo droplet_rigid_body_info;
@@ -642,28 +1483,57 @@ struct World::Impl: RigidBodyWorldCommonData
   WaterSurface water_surface;
   scene::Mesh::Pointer sky;
   std::vector<Firefly> fireflies;
-  LiveTuning live; // droplet knobs, refreshed from the in-page sliders each frame (web)
+  launcher::TuningRegistry tuning; // live parameters: the in-page sliders (web), assignments (native)
+  uint32_t live_version = 0;       // tuning.version() live was derived at
+  LiveTuning live;
+  WorldPhaseTimings timings; // wall time of the last update's phases
+  WorldSettleCounters settle_counters; // entities skipped at rest in the last update
+  WorldContactStats contact_stats; // droplet/leaf contacts of the last update
+  WorldDropletLodCounters droplet_lod_counters; // shown droplets per level of detail in the last update
+  common::JobSystem jobs;              // worker pool of the update graph (inline without threads)
+  common::TaskGraph update_graph;      // the update's concurrent phases (build_update_graph)
+  float update_dt = 0.0f;              // clamped frame time the graph's tasks advance by
+  math::vec3f view_eye;                // camera position for the graph's tasks (droplet brick resolution)
+  float view_scale = 1.0f;             // camera's 1 / tan(fov_y / 2)
+#ifdef WORLD_BULLET_MT
+  JobTaskScheduler physics_scheduler;  // Bullet's btParallelFor on jobs
+#endif
+  bool physics_threads_active = false; // physics_scheduler installed (switch_physics_threads)
 
   Impl(scene::Node::Pointer scene_root, SceneRenderer& scene_renderer, const scene::Camera::Pointer& camera)
     : leaf_model(media::geometry::MeshFactory::load_obj_model(LEAF_MESH))
     , plant_model(media::geometry::MeshFactory::load_obj_model(PLANT_MESH))
     , scene_root(scene_root)
     , camera(camera)
+    , render_device(scene_renderer.device())
+    , render_properties(scene_renderer.properties())
     , collision_configuration(new btDefaultCollisionConfiguration())
-    , dispatcher(new btCollisionDispatcher(collision_configuration.get()))
+    , dispatcher(new DynamicsDispatcher(collision_configuration.get()))
     , broadphase(new btDbvtBroadphase())
-    , solver(new btSequentialImpulseConstraintSolver())
-    , dynamics_world(new btDiscreteDynamicsWorld(dispatcher.get(), broadphase.get(), solver.get(), collision_configuration.get()))
+#ifdef WORLD_BULLET_MT
+    , solver_pool(new btConstraintSolverPoolMt(int(UPDATE_WORKERS_MAX) + 1))
+    , solver(new DynamicsSolver())
+    , dynamics_world(new FixedRateDynamicsWorld(dispatcher.get(), broadphase.get(), solver_pool.get(), solver.get(), collision_configuration.get()))
+#else
+    , solver(new DynamicsSolver())
+    , dynamics_world(new FixedRateDynamicsWorld(dispatcher.get(), broadphase.get(), solver.get(), collision_configuration.get()))
+#endif
     , droplet_debug_particle_mesh(media::geometry::MeshFactory::create_sphere("mtl1", DROPLET_PARTICLE_RADIUS))
     , grabbed_object(0)
     , droplet_rigid_body_info(COLLISION_GROUP_DROPLET, last_frame_time, *this)
     , ground_rigid_body_info(COLLISION_GROUP_GROUND, last_frame_time, *this)
+    , tuning(LIVE_PARAMETERS, LIVE_PARAMETERS_COUNT)
+    , jobs(std::min(common::JobSystem::default_workers_count(), UPDATE_WORKERS_MAX))
+#ifdef WORLD_BULLET_MT
+    , physics_scheduler(jobs)
+#endif
   {
       //load materials
 
-    Device render_device = scene_renderer.device();
     MaterialList materials = scene_renderer.materials();
 
+    plant_materials = materials;
+
     load_materials(leaf_model, materials, render_device);
     load_materials(plant_model, materials, render_device);
 
@@ -724,6 +1594,8 @@ struct World::Impl: RigidBodyWorldCommonData
     materials.insert("flower", flower_material);
     materials.insert("leaf", leaf_render_material);
 
+    water_surface.bind_material(render_device, water_material); // ripple textures + swell/grid uniforms
+
       //scale meshes
 
     scale_model(leaf_model, LEAVES_SCALE);
@@ -739,6 +1611,7 @@ struct World::Impl: RigidBodyWorldCommonData
 
     //dynamics_world->setGravity(btVector3(0, -10, 0));
     dynamics_world->setGravity(btVector3(0, -15, 0));
+    dynamics_world->setInternalTickCallback(physics_step_callback, this); // record every step's transforms for interpolation
 
     droplet_particle_shape.reset(new btSphereShape(btScalar(DROPLET_PARTICLE_RADIUS)));
     static_bind_shape.reset(new btSphereShape(btScalar(0.01f)));
@@ -749,6 +1622,21 @@ struct World::Impl: RigidBodyWorldCommonData
 
     //droplet_particle_shape->setMargin(COLLISION_MARGIN);
 
+    droplet_particle_pool.create(MAX_PARTICLES_COUNT, droplet_particle_shape, droplet_particle_local_intertia, scene_root, droplet_debug_particle_mesh, dynamics_world);
+    droplet_particles.reserve(MAX_PARTICLES_COUNT);
+    fluid.reserve(PBF_MAX_PARTICLES_COUNT);
+
+    launcher::DropletTrackerParams tracker_params;
+
+    tracker_params.keep_factor       = DROPLET_KEEP_FACTOR;
+    tracker_params.min_particles     = MIN_DROPLET_PARTICLES_COUNT;
+    tracker_params.remove_frames     = DROPLET_REMOVE_COUNTER_THRESHOLD;
+    tracker_params.preferred_max     = PREFERRED_MAX_DROPLETS_COUNT;
+    tracker_params.merge_steps       = CLUSTERIZE_STEPS_COUNT;
+    tracker_params.merge_step_factor = CLUSTERIZE_STEP_FACTOR;
+
+    droplet_tracker.set_params(tracker_params);
+
     sky = scene::Mesh::create();
     
     sky->set_mesh(media::geometry::MeshFactory::create_sphere(SKY_MATERIAL, SKY_RADIUS, math::vec3f(0.0f)));
@@ -757,6 +1645,7 @@ struct World::Impl: RigidBodyWorldCommonData
     setup_ground();
     setup_fireflies(scene_renderer);
     spawn_initial_plant();
+    build_update_graph();
 
     if (!gContactAddedCallback)
     {
@@ -764,6 +1653,11 @@ struct World::Impl: RigidBodyWorldCommonData
     }
   }
 
+  ~Impl()
+  {
+    switch_physics_threads(false); // Bullet's task scheduler is global: do not leave it on this world's pool
+  }
+
   void setup_fireflies(SceneRenderer& scene_renderer)
   {
     static const float TWO_PI = 6.2831853f;
@@ -1129,74 +2023,114 @@ struct World::Impl: RigidBodyWorldCommonData
     return q2 * q1;
   }
 
-  // Spawn one PROCEDURAL leaf (petiole "leg" + textured blade, generated per-seed for diversity) as a
-  // physics body pinned at its leg base. The collision is a CONCAVE V-trough COMPOUND (so droplets
-  // collect in the leaf instead of rolling off a convex hull). `length` = blade length in world units;
-  // the geometry is already at that size with the attach point at the origin.
-  void spawn_leaf(const math::vec3f& world_pos, const math::quatf& rotation, float length, uint32_t seed)
+  // A batch of the leaf variant with a free instance; a new one (mesh, material, palette) when all are full
+  LeafBatch& leaf_batch(uint32_t variant)
   {
-    media::geometry::Mesh leaf_mesh;
-    launcher::generate_leaf(leaf_mesh, seed, length, "leaf");
+    for (std::unique_ptr<LeafBatch>& batch : leaf_batches)
+      if (batch->variant == variant && batch->count < LEAF_BATCH_CAPACITY)
+        return *batch;
 
-    uint32_t lvc = leaf_mesh.vertices_count();
-    if (lvc == 0)
-      return;
+    std::unique_ptr<LeafBatch> batch = std::make_unique<LeafBatch>();
 
-      //blade centroid (for droplet spawn aim)
-    const media::geometry::Vertex* lv = leaf_mesh.vertices_data();
-    math::vec3f centroid(0.0f);
-    for (uint32_t i = 0; i < lvc; i++)
-      centroid += lv[i].position;
-    centroid /= (float) lvc;
-
-      //compound collision: a row of convex flaps forming a concave V-channel (see generate_leaf_collision)
-    std::vector<std::vector<math::vec3f>> pieces;
-    launcher::generate_leaf_collision(seed, length, pieces);
-
-    btCompoundShape* compound = new btCompoundShape();
-    std::vector<std::shared_ptr<btCollisionShape>> children;
-    btTransform child_tm;
-    child_tm.setIdentity();
-    for (size_t pi = 0; pi < pieces.size(); pi++)
-    {
-      const std::vector<math::vec3f>& piece = pieces[pi];
-      if (piece.size() < 4)
-        continue;
-      btConvexHullShape* ch = new btConvexHullShape();
-      for (size_t k = 0; k < piece.size(); k++)
-        ch->addPoint(btVector3(piece[k][0], piece[k][1], piece[k][2]), false);
-      ch->recalcLocalAabb();
-      children.push_back(std::shared_ptr<btCollisionShape>(ch));
-      compound->addChildShape(child_tm, ch);
-    }
-    if (children.empty())
+    batch->variant       = variant;
+    batch->material_name = "leaf_batch_" + std::to_string(leaf_batches.size());
+    batch->instances.assign(LEAF_BATCH_CAPACITY * 16, 0.0f);
+
+    batch->palette = std::make_unique<Texture>(render_device.create_texture2d(4, LEAF_BATCH_CAPACITY, PixelFormat_RGBA32F, 1));
+
+    batch->palette->set_min_filter(TextureFilter_Point);
+    batch->palette->set_mag_filter(TextureFilter_Point);
+    batch->palette->set_data(0, 0, 0, 4, LEAF_BATCH_CAPACITY, batch->instances.data()); // unused instances collapse
+
+    batch->material.set_shader_tags("leaf");
+
+    TextureList textures = batch->material.textures();
+    textures.insert("diffuseTexture", leaf_render_material.textures().get("diffuseTexture"));
+    textures.insert("instancePalette", *batch->palette);
+
+    PropertyMap properties = batch->material.properties();
+    properties.set("instanceCount", (float) LEAF_BATCH_CAPACITY);
+
+    plant_materials.insert(batch->material_name.c_str(), batch->material);
+
+      //the variant's blade at unit length (generate_leaf scales linearly with it), copied per instance
+
+    media::geometry::Mesh blade;
+    launcher::generate_leaf(blade, variant, 1.0f, batch->material_name.c_str());
+
+    const media::geometry::Vertex*           blade_verts   = blade.vertices_data();
+    const media::geometry::Mesh::index_type* blade_indices = blade.indices_data();
+    uint32_t blade_verts_count = blade.vertices_count(), blade_indices_count = blade.indices_count();
+
+    for (uint32_t i = 0; i < blade_verts_count; i++)
+      batch->centroid += blade_verts[i].position;
+    batch->centroid /= (float) blade_verts_count;
+
+    std::vector<media::geometry::Vertex>           verts;
+    std::vector<media::geometry::Mesh::index_type> indices;
+
+    verts.reserve(blade_verts_count * LEAF_BATCH_CAPACITY);
+    indices.reserve(blade_indices_count * LEAF_BATCH_CAPACITY);
+
+    for (size_t instance = 0; instance < LEAF_BATCH_CAPACITY; instance++)
     {
-      delete compound;
-      return;
+      size_t base = verts.size();
+
+      for (uint32_t i = 0; i < blade_verts_count; i++)
+      {
+        media::geometry::Vertex v = blade_verts[i];
+        v.color.w = (float) instance; // leaf.glsl ignores the vertex colour otherwise
+        verts.push_back(v);
+      }
+
+      for (uint32_t i = 0; i < blade_indices_count; i++)
+        indices.push_back((media::geometry::Mesh::index_type) (base + blade_indices[i]));
     }
-    std::shared_ptr<btCollisionShape> shape(compound);
+
+    media::geometry::Mesh mesh;
+    mesh.add_primitive(batch->material_name.c_str(), media::geometry::PrimitiveType_TriangleList,
+      &verts[0], (media::geometry::Mesh::index_type) verts.size(), &indices[0], (uint32_t) indices.size());
+
+    batch->mesh = scene::Mesh::create();
+    batch->mesh->set_mesh(mesh);
+    batch->mesh->bind_to_parent(*scene_root);
+
+    leaf_batches.push_back(std::move(batch));
+
+    return *leaf_batches.back();
+  }
+
+  // Spawn one PROCEDURAL leaf (petiole "leg" + textured blade) as a physics body pinned at its leg base.
+  // The seed picks one of LEAF_VARIANTS blade shapes, drawn as an instance of that variant's LeafBatch;
+  // a random tint and wilt keep the leaves diverse. The collision is a CONCAVE V-trough COMPOUND of the
+  // same shape (so droplets collect in the leaf instead of rolling off a convex hull). `length` = blade
+  // length in world units; the attach point is at the origin.
+  void spawn_leaf(const math::vec3f& world_pos, const math::quatf& rotation, float length, uint32_t seed)
+  {
+    if (length <= 1e-4f)
+      return;
+
+    uint32_t variant = seed % LEAF_VARIANTS;
+
+      //compound collision, shared with the leaves of the variant and about the same length
+    std::shared_ptr<btCollisionShape> shape = leaf_shapes.acquire(variant, length);
+    if (!shape)
+      return;
 
     btVector3 bt_inertia(0, 0, 0);
     shape->calculateLocalInertia(LEAF_MASS, bt_inertia);
     math::vec3f local_inertia(bt_inertia.x(), bt_inertia.y(), bt_inertia.z());
 
-      //textured render node. The leaf grows in via the RENDER node scale only (collision stays full
-      //size -- scaling a compound's children is awkward, and the brief grow-in mismatch is harmless).
-    scene::Mesh::Pointer mesh = scene::Mesh::create();
-    mesh->set_mesh(leaf_mesh);
-    mesh->set_position(world_pos);
-    mesh->set_orientation(rotation);
-    mesh->set_scale(math::vec3f(LEAF_GROW_START));
-    mesh->bind_to_parent(*scene_root);
+      //no render node: the leaf is drawn by its batch (pose_leaf)
+    phys_bodies.push_back(std::make_shared<PhysBodySync>(shape, LEAF_MASS, local_inertia, world_pos, rotation, scene::Mesh::Pointer(), COLLISION_GROUP_LEAF, COLLISION_MASK_LEAF, dynamics_world));
 
-    phys_bodies.push_back(std::make_shared<PhysBodySync>(shape, LEAF_MASS, local_inertia, world_pos, rotation, mesh, COLLISION_GROUP_LEAF, COLLISION_MASK_LEAF, dynamics_world));
+    LeafBatch& batch = leaf_batch(variant);
 
     Leaf leaf(last_frame_time, *this);
     leaf.phys_body = phys_bodies.back();
-    leaf.hull_children = children; // keep the compound's child shapes alive for the leaf's lifetime
     leaf.target_transform = leaf.phys_body->body->getWorldTransform();
-    leaf.local_center   = centroid;                          // blade centre (for droplet spawn aim)
-    leaf.initial_center = rotation * centroid + world_pos;
+    leaf.local_center   = batch.centroid * length;           // blade centre (for droplet spawn aim)
+    leaf.initial_center = rotation * leaf.local_center + world_pos;
     leaf.phys_body->body->setUserPointer(leaf.rigid_body_info.get());
     leaf.phys_body->body->setFriction(crand(LEAF_MIN_FRICTION, LEAF_MAX_FRICTION));
     // no gravity on generated leaves: they're pinned only at the spine base, so gravity would swing
@@ -1221,17 +2155,34 @@ struct World::Impl: RigidBodyWorldCommonData
       pivot, btVector3(0, 0, 0));
     dynamics_world->addConstraint(leaf.constraint.get(), true);
 
-      //leaf growth: ramp scale 0->1 over a random duration (diversity). Geometry is already world-size
-      //so full node scale is 1.
-    leaf.full_scale    = 1.0f;
+      //leaf growth: ramp the blade scale up to its length over a random duration (diversity). The
+      //collision stays full size -- scaling a compound's children is awkward, and the brief grow-in
+      //mismatch is harmless.
+    leaf.full_scale    = length;
+    leaf.render_scale  = length * LEAF_GROW_START;
     leaf.grow_age      = 0.0f;
     leaf.grow_duration = crand(LEAF_GROW_MIN_SECONDS, LEAF_GROW_MAX_SECONDS);
 
+      //take an instance of the batch: tint and wilt are set once, the transform every frame it moves
+    leaf.batch    = &batch;
+    leaf.instance = batch.count++;
+
+    float  shade  = crand(LEAF_MIN_SHADE, LEAF_MAX_SHADE);
+    float  yellow = crand(0.0f, LEAF_MAX_YELLOW);
+    float* extra  = &batch.instances[leaf.instance * 16 + 12];
+
+    extra[0] = shade * (1.0f + yellow);
+    extra[1] = shade;
+    extra[2] = shade * (1.0f - yellow);
+    extra[3] = crand(0.0f, LEAF_MAX_WILT);
+
+    pose_leaf(leaf);
+
     leaves.push_back(leaf);
   }
 
-  // Grow each freshly-spawned leaf in: ramp its render-node scale and collision-hull scale from
-  // LEAF_GROW_START up to full over its (random) grow_duration. Called once per frame.
+  // Grow each freshly-spawned leaf in: ramp its blade scale from LEAF_GROW_START up to full over its
+  // (random) grow_duration. Called once per frame.
   void update_leaf_growth(float dt)
   {
     for (Leaf& leaf : leaves)
@@ -1245,8 +2196,37 @@ struct World::Impl: RigidBodyWorldCommonData
       float e  = t * t * (3.0f - 2.0f * t);                 // smoothstep ease
       float f  = LEAF_GROW_START + (1.0f - LEAF_GROW_START) * e;
 
-      leaf.phys_body->mesh->set_scale(math::vec3f(leaf.full_scale * f)); // visual grow-in only
+      leaf.render_scale = leaf.full_scale * f; // visual grow-in only
+    }
+  }
+
+  // Write a batched leaf's instance transform: its body interpolated between the last two physics steps,
+  // scaled by its blade scale. Writes the leaf's own instance only (update graph, World::plants).
+  void pose_leaf(Leaf& leaf)
+  {
+    const btTransform  T    = leaf.phys_body->states.at(physics_alpha);
+    const btMatrix3x3& R    = T.getBasis();
+    const btVector3&   O    = T.getOrigin();
+    float*             rows = &leaf.batch->instances[leaf.instance * 16];
+
+    for (int r = 0; r < 3; r++, rows += 4)
+    {
+      rows[0] = R[r].x() * leaf.render_scale;
+      rows[1] = R[r].y() * leaf.render_scale;
+      rows[2] = R[r].z() * leaf.render_scale;
+      rows[3] = O[r];
     }
+
+    leaf.batch->dirty = true;
+  }
+
+  // Send a leaf batch's changed instances to its palette texture (GL: main thread)
+  void upload_leaf_palette(LeafBatch& batch)
+  {
+    if (batch.count)
+      batch.palette->set_data(0, 0, 0, 4, batch.count, batch.instances.data());
+
+    batch.dirty = false;
   }
 
   // One growing plant at the scene centre, sprouting from g=0 (see update_plants for the growth).
@@ -1264,7 +2244,7 @@ struct World::Impl: RigidBodyWorldCommonData
       std::shared_ptr<Plant> pl = plants.back();
       pl->growth = 1.0f;
       pl->age = PLANT_GROW_SECONDS;
-      rebuild_plant(pl);
+      set_plant_growth(pl);
       for (size_t i = 0; i < pl->slots.size(); i++)
       {
         const launcher::LeafSlot& slot = pl->slots[i];
@@ -1277,28 +2257,26 @@ struct World::Impl: RigidBodyWorldCommonData
 #endif
   }
 
-  // Remove the oldest n droplet particles (front of droplet_particles == generation order) from both
-  // droplet_particles and the master phys_bodies, so ~PhysBodySync removes them from the Bullet world.
+  // Retire the oldest n droplet particles (front of droplet_particles == generation order): their bodies
+  // go back to the pool (parked, not destroyed). The fluid solver keeps its particles in generation order too.
   void retire_oldest_droplet_particles(size_t n)
   {
+    if (fluid_active)
+    {
+      fluid.retire_front(n);
+      return;
+    }
+
     if (n > droplet_particles.size())
       n = droplet_particles.size();
 
     if (!n)
       return;
 
-    std::vector<PhysBodySync*> retiring;
-    retiring.reserve(n);
-
     for (size_t i = 0; i < n; i++)
-      retiring.push_back(droplet_particles[i].get());
+      droplet_particle_pool.retire(*droplet_particles[i]);
 
     droplet_particles.erase(droplet_particles.begin(), droplet_particles.begin() + n);
-
-    phys_bodies.erase(std::remove_if(phys_bodies.begin(), phys_bodies.end(),
-      [&](const std::shared_ptr<PhysBodySync>& b) {
-        return std::find(retiring.begin(), retiring.end(), b.get()) != retiring.end();
-      }), phys_bodies.end());
   }
 
   void generate_droplet()
@@ -1314,8 +2292,11 @@ struct World::Impl: RigidBodyWorldCommonData
     // cap and then stalled all new droplets, leaving the top leaf permanently empty after a while.
     const size_t per_droplet = (size_t) std::max(1, live.particles_per_droplet);
 
-    if (droplet_particles.size() + per_droplet > MAX_PARTICLES_COUNT)
-      retire_oldest_droplet_particles(droplet_particles.size() + per_droplet - MAX_PARTICLES_COUNT);
+    const size_t count  = droplet_particles_count();
+    const size_t budget = fluid_active ? PBF_MAX_PARTICLES_COUNT : MAX_PARTICLES_COUNT;
+
+    if (count + per_droplet > budget)
+      retire_oldest_droplet_particles(count + per_droplet - budget);
 
     last_droplet_generated_time = last_frame_time;
 
@@ -1330,7 +2311,7 @@ struct World::Impl: RigidBodyWorldCommonData
     }
     float band = y_hi - 0.15f * (y_hi - y_lo); // only the highest ~15% of leaves
 
-    std::vector<size_t> top_leaves;
+    top_leaves.clear();
     for (size_t i = 0; i < leaves.size(); i++)
       if (leaves[i].phys_body->body->getWorldTransform().getOrigin().y() >= band)
         top_leaves.push_back(i);
@@ -1353,12 +2334,17 @@ struct World::Impl: RigidBodyWorldCommonData
   {
     float friction_factor = crand(DROPLET_MIN_FRICTION_FACTOR, DROPLET_MAX_FRICTION_FACTOR);
 
-    // (re)build the per-particle collision shape at the current physical radius, so new droplets pick up
+    // rebuild the per-particle collision shape when the physical radius changed, so new droplets pick up
     // the live "physical radius" slider. Existing particles keep their own shape (shared_ptr) -> stable.
-    droplet_particle_shape.reset(new btSphereShape(btScalar(live.physical_radius)));
-    btVector3 bt_local_inertia(0, 0, 0);
-    droplet_particle_shape->calculateLocalInertia(DROPLET_PARTICLE_MASS, bt_local_inertia);
-    droplet_particle_local_intertia = math::vec3f(bt_local_inertia.getX(), bt_local_inertia.getY(), bt_local_inertia.getZ());
+    if (live.physical_radius != droplet_particle_shape_radius)
+    {
+      droplet_particle_shape.reset(new btSphereShape(btScalar(live.physical_radius)));
+      droplet_particle_shape_radius = live.physical_radius;
+
+      btVector3 bt_local_inertia(0, 0, 0);
+      droplet_particle_shape->calculateLocalInertia(DROPLET_PARTICLE_MASS, bt_local_inertia);
+      droplet_particle_local_intertia = math::vec3f(bt_local_inertia.getX(), bt_local_inertia.getY(), bt_local_inertia.getZ());
+    }
 
     // generate exactly live.particles_per_droplet particles, distributed over concentric shells in a
     // small ball whose radius scales with the physical radius (was DROPLET_RADIUS/8 = physical*2.5).
@@ -1390,44 +2376,42 @@ struct World::Impl: RigidBodyWorldCommonData
     }
   }
 
+  // Take a parked body from the pool and launch it at offset (no allocation, no world add); with the
+  // fluid solver, just add a particle there
   void generate_droplet_particle(const math::vec3f& offset, float friction_factor)
   {
-    scene::Mesh::Pointer mesh; // particles are never rendered unless debug-drawing -> don't allocate/sync a scene mesh
-
-    if (DROPLET_DEBUG_DRAW)
+    if (fluid_active)
     {
-      mesh = scene::Mesh::create();
-      mesh->set_mesh(droplet_debug_particle_mesh);
-      mesh->bind_to_parent(*scene_root);
+      fluid.add(offset[0], offset[1], offset[2], 0.0f, 0.0f, 0.0f);
+      return;
     }
 
-    phys_bodies.push_back(std::make_shared<PhysBodySync>(droplet_particle_shape, DROPLET_PARTICLE_MASS, droplet_particle_local_intertia, offset, math::quatf(), mesh, COLLISION_GROUP_DROPLET, COLLISION_MASK_DROPLET, dynamics_world));
+    const math::vec3f& inertia = droplet_particle_local_intertia;
+    float              friction = crand(DROPLET_PARTICLE_MIN_FRICTION, DROPLET_PARTICLE_MAX_FRICTION) * friction_factor;
 
-    PhysBodySync& particle = *phys_bodies.back();
+    std::shared_ptr<PhysBodySync> particle = droplet_particle_pool.spawn(offset, droplet_particle_shape, btVector3(inertia[0], inertia[1], inertia[2]), friction);
 
-    particle.body->setUserPointer(&droplet_rigid_body_info);
-    particle.body->setFriction(crand(DROPLET_PARTICLE_MIN_FRICTION, DROPLET_PARTICLE_MAX_FRICTION) * friction_factor);
-    //particle.body->setSleepingThresholds(DROPLET_PARTICLE_LINEAR_SLEEPING_THRESHOLD, DROPLET_PARTICLE_ANGULAR_SLEEPING_THRESHOLD);
-    //particle.body->setAngularFactor(btVector3(0.0f, 0.0f, 0.0f));
+    if (!particle) // more than MAX_PARTICLES_COUNT live (particles per droplet above the budget)
+      return;
 
-    particle.droplet_particle = std::make_shared<DropletParticle>();
+    particle->body->setUserPointer(&droplet_rigid_body_info);
+    //particle->body->setSleepingThresholds(DROPLET_PARTICLE_LINEAR_SLEEPING_THRESHOLD, DROPLET_PARTICLE_ANGULAR_SLEEPING_THRESHOLD);
+    //particle->body->setAngularFactor(btVector3(0.0f, 0.0f, 0.0f));
 
-    droplet_particles.push_back(phys_bodies.back());
+    droplet_particles.push_back(particle);
   }
 
-  // (Re)build a plant's branch geometry for its current growth and push it to the GPU.
-  void rebuild_plant(const std::shared_ptr<Plant>& plant)
+  // Show a growing plant's mature mesh up to its current growth (a uniform: no re-tessellation)
+  void set_plant_growth(const std::shared_ptr<Plant>& plant)
   {
-    media::geometry::Mesh mesh;
-    launcher::generate_plant_mesh(mesh, plant->params, plant->growth);
-    if (mesh.primitives_count() > 0)
-      plant->mesh->set_mesh(mesh);
-    plant->built_growth = plant->growth;
+    PropertyMap properties = plant->material.properties();
+
+    properties.set("plantGrowth", plant->growth);
   }
 
-  // Once the plant is fully grown, build a PHYSICS SKELETON: one kinematic rigid body per branch, baked
-  // into world space. From here the branch mesh follows the bodies (rebuild_skeleton_mesh). Phase 1 keeps
-  // the bodies kinematic at rest -> renders identically; later phases make them dynamic + jointed (wind/drag).
+  // Once the plant is fully grown, build a PHYSICS SKELETON: one jointed rigid body per branch, baked
+  // into world space, and the branch mesh skinned to it: a static mesh in the rest pose whose vertices
+  // name their bones (see flower.glsl), posed on the GPU from the bone palette pose_skeleton fills.
   void finalize_skeleton(const std::shared_ptr<Plant>& plant)
   {
     std::vector<launcher::Bone> bones;
@@ -1439,29 +2423,52 @@ struct World::Impl: RigidBodyWorldCommonData
     plant->bones.clear();
     plant->bones.reserve(bones.size());
 
+    std::vector<media::geometry::Vertex>           skin_verts;
+    std::vector<media::geometry::Mesh::index_type> skin_indices;
+
     for (size_t i = 0; i < bones.size(); i++)
     {
       const launcher::Bone& src = bones[i];
 
       BoneBody bb;
       bb.parent  = src.parent;
-      bb.indices = src.indices;
-      bb.verts   = src.verts;
-      for (size_t v = 0; v < bb.verts.size(); v++)
-        bb.verts[v].position = bb.verts[v].position * s;     // bone-local, scaled to world units
 
       math::vec3f origin_world = base + src.rest_base * s;    // bone origin = the joint to its parent
 
+      bb.rest_origin = btVector3(origin_world.x, origin_world.y, origin_world.z);
+
       btConvexHullShape* hull = new btConvexHullShape();
-      for (size_t v = 0; v < bb.verts.size(); v++)
-        hull->addPoint(btVector3(bb.verts[v].position.x, bb.verts[v].position.y, bb.verts[v].position.z), false);
+      for (size_t v = 0; v < src.verts.size(); v++)
+      {
+        math::vec3f p = src.verts[v].position * s;            // bone-local, scaled to world units
+        hull->addPoint(btVector3(p.x, p.y, p.z), false);
+      }
       hull->recalcLocalAabb();
+
+        //the bone's share of the skinned mesh, in the rest pose (uint16 index budget)
+      if (skin_verts.size() + src.verts.size() <= 64000)
+      {
+        uint32_t base_idx = (uint32_t) skin_verts.size();
+        float    parent   = (float) (src.parent >= 0 ? src.parent : (int) i);
+
+        for (size_t v = 0; v < src.verts.size(); v++)
+        {
+          media::geometry::Vertex o = src.verts[v];
+          o.position  = origin_world + src.verts[v].position * s;
+          o.tex_coord = math::vec2f((float) i, parent);
+          o.color.w   = src.weights[v];
+          skin_verts.push_back(o);
+        }
+        for (size_t k = 0; k < src.indices.size(); k++)
+          skin_indices.push_back((media::geometry::Mesh::index_type) (base_idx + src.indices[k]));
+      }
       bb.shape = std::shared_ptr<btCollisionShape>(hull);
 
       btTransform t;
       t.setIdentity();
       t.setOrigin(btVector3(origin_world.x, origin_world.y, origin_world.z));
       bb.motion = std::make_shared<btDefaultMotionState>(t);
+      bb.states.reset(t);
 
       bool is_root = (bb.parent < 0);
 
@@ -1556,51 +2563,65 @@ struct World::Impl: RigidBodyWorldCommonData
     }
 
     plant->skeletonized = true;
-    plant->mesh->set_position(math::vec3f(0.0f)); // the rebuilt skeleton mesh is already in world space
+    plant->mesh->set_position(math::vec3f(0.0f)); // the skinned mesh's rest pose is in world space
     plant->mesh->set_scale(math::vec3f(1.0f));
-    rebuild_skeleton_mesh(plant);
+
+      //the growth mesh's material now skins: the palette replaces the growth uniform
+
+    plant->bone_palette = std::make_unique<Texture>(render_device.create_texture2d(3, plant->bones.size(), PixelFormat_RGBA32F, 1));
+
+    plant->bone_palette->set_min_filter(TextureFilter_Point);
+    plant->bone_palette->set_mag_filter(TextureFilter_Point);
+
+    TextureList textures = plant->material.textures();
+    textures.insert("bonePalette", *plant->bone_palette);
+
+    PropertyMap properties = plant->material.properties();
+    properties.set("plantGrowth", -1.0f);
+    properties.set("boneCount", (float) plant->bones.size());
+
+    if (!skin_verts.empty())
+    {
+      media::geometry::Mesh mesh;
+      mesh.add_primitive(plant->material_name.c_str(), media::geometry::PrimitiveType_TriangleList,
+        &skin_verts[0], (media::geometry::Mesh::index_type) skin_verts.size(), &skin_indices[0], (uint32_t) skin_indices.size());
+      plant->mesh->set_mesh(mesh);
+    }
+
+    pose_skeleton(plant);
+    upload_bone_palette(plant);
   }
 
-  // Rebuild the branch mesh from the live bone-body transforms (the skeleton drives the geometry).
-  void rebuild_skeleton_mesh(const std::shared_ptr<Plant>& plant)
+  // Pose the skeleton for the GPU: each bone's skinning matrix (rest pose -> its body transform
+  // interpolated between the last two physics steps, like every other body) as three rows. Writes the
+  // plant's own matrices only, so plants are posed in parallel (update graph).
+  void pose_skeleton(const std::shared_ptr<Plant>& plant)
   {
-    std::vector<media::geometry::Vertex>           verts;
-    std::vector<media::geometry::Mesh::index_type> indices;
+    plant->bone_matrices.resize(plant->bones.size() * 12);
 
-    for (size_t b = 0; b < plant->bones.size(); b++)
-    {
-      const BoneBody& bb = plant->bones[b];
-      if (verts.size() + bb.verts.size() > 64000)
-        break; // uint16 index budget
+    float* rows = plant->bone_matrices.data();
 
-      const btTransform& T = bb.body->getWorldTransform();
+    for (const BoneBody& bb : plant->bones)
+    {
+      const btTransform  T = bb.states.at(physics_alpha);
       const btMatrix3x3& R = T.getBasis();
-      const btVector3&   O = T.getOrigin();
-      uint32_t base_idx = (uint32_t) verts.size();
+      const btVector3    t = T.getOrigin() - R * bb.rest_origin; // rest bones are unrotated: p -> R (p - rest) + origin
 
-      for (size_t v = 0; v < bb.verts.size(); v++)
+      for (int r = 0; r < 3; r++, rows += 4)
       {
-        const math::vec3f& lp = bb.verts[v].position;
-        const math::vec3f& ln = bb.verts[v].normal;
-        btVector3 wp = T * btVector3(lp.x, lp.y, lp.z);
-        btVector3 wn = R * btVector3(ln.x, ln.y, ln.z);
-        media::geometry::Vertex o = bb.verts[v];
-        o.position = math::vec3f(wp.x(), wp.y(), wp.z());
-        o.normal   = math::vec3f(wn.x(), wn.y(), wn.z());
-        verts.push_back(o);
+        rows[0] = R[r].x();
+        rows[1] = R[r].y();
+        rows[2] = R[r].z();
+        rows[3] = t[r];
       }
-      (void) O;
-      for (size_t k = 0; k < bb.indices.size(); k++)
-        indices.push_back((media::geometry::Mesh::index_type) (base_idx + bb.indices[k]));
     }
+  }
 
-    if (verts.empty())
-      return;
-
-    media::geometry::Mesh mesh;
-    mesh.add_primitive("flower", media::geometry::PrimitiveType_TriangleList,
-      &verts[0], (media::geometry::Mesh::index_type) verts.size(), &indices[0], (uint32_t) indices.size());
-    plant->mesh->set_mesh(mesh);
+  // Send the posed bone matrices to the palette texture (GL: main thread)
+  void upload_bone_palette(const std::shared_ptr<Plant>& plant)
+  {
+    if (plant->bone_palette && !plant->bones.empty())
+      plant->bone_palette->set_data(0, 0, 0, 3, plant->bones.size(), plant->bone_matrices.data());
   }
 
   // Joint spring stiffness for a bone: scales with mass^2 so a thick structural joint (carrying a big
@@ -1653,7 +2674,8 @@ struct World::Impl: RigidBodyWorldCommonData
     }
   }
 
-  // Advance every still-growing plant by dt; re-mesh when growth moved enough (called each frame).
+  // Advance every still-growing plant by dt, push the skeletons and spawn the leaves (called each frame,
+  // on the main thread: it adds bodies to the Bullet world). The skeletons are posed in pose_skeleton.
   void update_plants(float dt)
   {
     wind_time += dt;
@@ -1666,14 +2688,14 @@ struct World::Impl: RigidBodyWorldCommonData
         {
           plant->age   += dt;
           plant->growth = std::min(1.0f, plant->age / PLANT_GROW_SECONDS);
-          rebuild_plant(plant); // rebuild every frame while growing -> smooth, continuous growth
+
+          set_plant_growth(plant);
         }
       }
       else
       {
         update_joint_params(plant); // live stiffness/damping sliders
         apply_wind(plant);
-        rebuild_skeleton_mesh(plant); // branch mesh follows the physics skeleton
       }
 
         //spawn a real leaf-blade physics body for each slot whose birth has been reached
@@ -1725,10 +2747,18 @@ struct World::Impl: RigidBodyWorldCommonData
     plant->age           = 0.0f;
     plant->growth        = 0.0f;
 
-      //size the plant so its MATURE structure (branches stack past the trunk) reaches target_height.
-      //Measured once from a full-growth build; the node scale then holds while the geometry grows in.
+      //the mature branch mesh, built once with its own material: the growth uniform reveals it
+    plant->material_name = "plant_" + std::to_string(plants_created++);
+
+    plant->material.set_shader_tags("flower");
+    plant_materials.insert(plant->material_name.c_str(), plant->material);
+    set_plant_growth(plant);
+
     media::geometry::Mesh full;
-    launcher::generate_plant_mesh(full, plant->params, 1.0f);
+    launcher::generate_plant_mesh(full, plant->params, plant->material_name.c_str());
+
+      //size the plant so its MATURE structure (branches stack past the trunk) reaches target_height.
+      //Measured on the mature mesh; the node scale then holds while the geometry grows in.
     float full_height = 0.0f;
     for (uint32_t i = 0, n = full.vertices_count(); i < n; i++)
       full_height = std::max(full_height, full.vertices_data()[i].position.y);
@@ -1742,101 +2772,342 @@ struct World::Impl: RigidBodyWorldCommonData
 
     plant->mesh->set_position(position);
     plant->mesh->set_scale(math::vec3f(plant->scale));
-    rebuild_plant(plant);
+    plant->mesh->set_mesh(full);
     plant->mesh->bind_to_parent(*scene_root);
 
     plants.push_back(plant);
   }
 
-  int last_substeps = 0; // number of fixed physics substeps run this frame (drives the water at the same rate)
+  int last_substeps = 0; // number of fixed physics substeps run this frame
+  float water_step_time = 0.0f; // frame time accumulated towards the next water update
+  btScalar physics_alpha = 0; // where this frame is rendered between the last two physics steps, [0, 1)
 
-  // Pull live droplet knobs from the in-page sliders (window.DROPLET.*) once per frame; each falls back
-  // to its compile-time constant when the slider/page hasn't set it. No-op off the web.
-  void refresh_live_tuning()
+  // After every fixed physics step: shift the bodies' recorded states so rendering can interpolate
+  static void physics_step_callback(btDynamicsWorld* world, btScalar time_step)
   {
-#ifdef __EMSCRIPTEN__
-    live.metaball_radius = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.metaballRadius != null) ? window.DROPLET.metaballRadius : $0; }, (double) DROPLET_RAYMARCH_PARTICLE_RADIUS);
-    live.influence       = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.influence      != null) ? window.DROPLET.influence      : $0; }, (double) DROPLET_INFLUENCE_RADIUS);
-    live.iso             = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.iso            != null) ? window.DROPLET.iso            : $0; }, (double) DROPLET_ISO_THRESHOLD);
-    live.force           = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.force          != null) ? window.DROPLET.force          : $0; }, (double) DROPLET_SURFACE_TENSION);
-    live.damping         = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.damping        != null) ? window.DROPLET.damping        : $0; }, (double) DROPLET_VISCOSITY);
-    live.cohesion_radius = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.cohesionRadius != null) ? window.DROPLET.cohesionRadius : $0; }, (double) DROPLET_COHESION_RADIUS);
-    live.particles_per_droplet = EM_ASM_INT({ return (window.DROPLET && window.DROPLET.particlesPerDroplet != null) ? (window.DROPLET.particlesPerDroplet | 0) : $0; }, 20);
-    live.physical_radius = (float) EM_ASM_DOUBLE({ return (window.DROPLET && window.DROPLET.physicalRadius  != null) ? window.DROPLET.physicalRadius  : $0; }, (double) DROPLET_PARTICLE_RADIUS);
-    live.wind_accel      = (float) EM_ASM_DOUBLE({ return (window.WIND && window.WIND.accel      != null) ? window.WIND.accel      : $0; }, (double) WIND_ACCEL);
-    live.joint_stiffness = (float) EM_ASM_DOUBLE({ return (window.WIND && window.WIND.stiffness  != null) ? window.WIND.stiffness  : $0; }, (double) JOINT_STIFFNESS_BASE);
-    live.joint_damping   = (float) EM_ASM_DOUBLE({ return (window.WIND && window.WIND.damping    != null) ? window.WIND.damping    : $0; }, (double) JOINT_DAMPING);
-#endif
+    Impl* impl = static_cast<Impl*>(world->getWorldUserInfo());
+
+    for (std::shared_ptr<PhysBodySync>& body : impl->phys_bodies)
+      body->states.push(body->body->getWorldTransform());
+
+    for (std::shared_ptr<PhysBodySync>& particle : impl->droplet_particles) // live ones only; parked bodies don't move
+      particle->states.push(particle->body->getWorldTransform());
+
+    for (std::shared_ptr<Plant>& plant : impl->plants)
+      for (BoneBody& bone : plant->bones)
+        bone.states.push(bone.body->getWorldTransform());
+
+    if (impl->fluid_active)
+      impl->step_fluid(time_step); // in lockstep with the leaves it collides with
   }
 
-  // SPH-style surface tension (Akinci et al. 2013): for every near pair of particles within a droplet,
-  // a COHESION force pulls them together with a kernel that is zero at contact and at the cohesion
-  // radius h and peaks in between (so the cluster minimises surface area without imploding), plus a
-  // VISCOSITY force that damps only their RELATIVE velocity (internal jiggle settles, bulk fall kept).
-  // Bullet's sphere collisions provide the short-range repulsion. O(n^2) per cluster; clustering keeps
-  // n modest and the particle budget caps the worst case.
-  void apply_droplet_surface_tension()
-  {
-    const float h = live.cohesion_radius;
-    if (h <= 1.0e-4f)
-      return;
-    const float h2    = h * h;
-    const float gamma = live.force;   // cohesion strength (surface tension)
-    const float visc  = live.damping; // relative-velocity damping
+  // Droplet particles alive in the active solver
+  size_t droplet_particles_count() const { return fluid_active ? fluid.size() : droplet_particles.size(); }
 
-    for (std::shared_ptr<Droplet>& droplet : droplets)
+  math::vec3f droplet_particle_position(size_t i) const
+  {
+    if (fluid_active)
     {
-      std::vector<std::shared_ptr<PhysBodySync>>& b = droplet->bodies;
-      const size_t n = b.size();
-      if (n < 2)
-        continue;
+      const launcher::PbfParticles& p = fluid.particles();
 
-      st_pos.clear(); st_vel.clear();
-      st_pos.reserve(n); st_vel.reserve(n);
-      st_acc.assign(n, btVector3(0.0f, 0.0f, 0.0f));
-      for (size_t i = 0; i < n; i++)
-      {
-        st_pos.push_back(b[i]->body->getWorldTransform().getOrigin());
-        st_vel.push_back(b[i]->body->getLinearVelocity());
-      }
+      return math::vec3f(p.px[i], p.py[i], p.pz[i]);
+    }
+
+    const btVector3& position = droplet_particles[i]->body->getWorldTransform().getOrigin();
+
+    return math::vec3f(position.getX(), position.getY(), position.getZ());
+  }
+
+  // Droplet a live particle was tracked into (a label resolved by droplet_tracker)
+  uint32_t droplet_particle_label(size_t i) const
+  {
+    return fluid_active ? fluid.particles().tag[i] : droplet_particles[i]->droplet_particle->droplet;
+  }
+
+  void set_droplet_particle_label(size_t i, uint32_t label)
+  {
+    if (fluid_active) fluid.set_tag(i, label);
+    else              droplet_particles[i]->droplet_particle->droplet = label;
+  }
+
+  // One fluid step: every ground/leaf body becomes an oriented box (its shape's local AABB) moving with the
+  // body; the leaves the fluid touched are recorded as contacts like the Bullet particles' ones
+  void step_fluid(btScalar time_step)
+  {
+    fluid_colliders.resize(phys_bodies.size());
+
+    for (size_t i=0, count=phys_bodies.size(); i<count; i++)
+    {
+      const btRigidBody&   body = *phys_bodies[i]->body;
+      const btTransform&   transform = body.getWorldTransform();
+      launcher::PbfCollider& collider = fluid_colliders[i];
+
+      btVector3 local_min, local_max;
+
+      body.getCollisionShape()->getAabb(btTransform::getIdentity(), local_min, local_max);
+
+      btVector3 center   = transform * ((local_min + local_max) * 0.5f);
+      btVector3 half     = (local_max - local_min) * 0.5f;
+      btVector3 velocity = body.getVelocityInLocalPoint(center - transform.getOrigin());
+
+      for (int k=0; k<3; k++)
+      {
+        btVector3 axis = transform.getBasis().getColumn(k);
+
+        collider.center[k]           = center[k];
+        collider.half_extent[k]      = half[k];
+        collider.linear_velocity[k]  = velocity[k];
+        collider.angular_velocity[k] = body.getAngularVelocity()[k];
+
+        for (int m=0; m<3; m++)
+          collider.axes[k][m] = axis[m];
+      }
+
+      collider.friction = body.getFriction() * 0.5f * (DROPLET_PARTICLE_MIN_FRICTION + DROPLET_PARTICLE_MAX_FRICTION); // Bullet multiplies the pair's frictions
+    }
+
+    fluid.step(time_step, fluid_colliders.data(), fluid_colliders.size());
+
+    for (size_t i=0, count=phys_bodies.size(); i<count; i++)
+    {
+      RigidBodyInfo* info = static_cast<RigidBodyInfo*>(phys_bodies[i]->body->getUserPointer());
+
+      if (!fluid_colliders[i].contacts || !info || info->collision_group != COLLISION_GROUP_LEAF)
+        continue;
+
+      const float* center = fluid_colliders[i].center;
+
+      contact_events.push({nullptr, phys_bodies[i]->body.get(), btVector3(center[0], center[1], center[2]), btScalar(0)});
+    }
+  }
+
+  // Handle the contacts the physics steps of this frame recorded, once per droplet/leaf pair (the
+  // substeps and a manifold's points repeat a pair). A leaf counts towards the contact sound when it had
+  // no droplet contact during PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING.
+  void drain_contact_events()
+  {
+    std::sort(contact_events.begin(), contact_events.end(), [](const ContactEvent& a, const ContactEvent& b) {
+      return a.leaf != b.leaf ? std::less<const btCollisionObject*>()(a.leaf, b.leaf) : std::less<const btCollisionObject*>()(a.droplet, b.droplet);
+    });
+
+    contact_stats.events    = contact_events.size();
+    contact_stats.dropped   = contact_events.dropped();
+    contact_stats.pairs     = 0;
+    contact_stats.max_speed = 0.0f;
+
+    for (ContactEvent *event = contact_events.begin(), *end = contact_events.end(); event != end;)
+    {
+      ContactEvent* pair_end = event + 1;
+      btScalar      speed    = event->speed;
+
+      for (; pair_end != end && pair_end->leaf == event->leaf && pair_end->droplet == event->droplet; ++pair_end)
+        speed = std::max(speed, pair_end->speed);
+
+      contact_stats.pairs++;
+      contact_stats.max_speed = std::max(contact_stats.max_speed, float(speed));
+
+      RigidBodyInfo* info = static_cast<RigidBodyInfo*>(event->leaf->getUserPointer());
+
+      if (last_frame_time - info->prev_droplet_contact_time > PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING)
+        leaves_collisions_count += 2; // the droplet and the leaf
+
+      info->prev_droplet_contact_time = last_frame_time;
+
+      event = pair_end;
+    }
+
+    contact_events.clear();
+  }
+
+  // Step Bullet on the job system's workers or on the calling thread. The multithreaded world with
+  // Bullet's sequential scheduler steps like the single-threaded one; builds without WORLD_BULLET_MT
+  // always step on the calling thread.
+  void switch_physics_threads(bool threads)
+  {
+#ifdef WORLD_BULLET_MT
+    btSetTaskScheduler(threads ? static_cast<btITaskScheduler*>(&physics_scheduler) : btGetSequentialTaskScheduler());
+#endif
+
+    physics_threads_active = threads;
+  }
+
+  // Move the droplets to the other particle solver: the current particles are dropped (their droplets
+  // empty out and are removed as usual) and new droplets spawn into the selected one
+  void switch_droplet_solver(bool pbf)
+  {
+    retire_oldest_droplet_particles(droplet_particles_count());
+
+    fluid_active = pbf;
+  }
+
+  // Re-derive the live knobs and what depends on them (the fluid and tracker parameters) when a tuning
+  // parameter changed since the last call: the page writes the registry's block directly, so an
+  // unchanged frame costs one compare
+  void refresh_live_tuning()
+  {
+    if (tuning.version() == live_version)
+      return;
+
+    live_version = tuning.version();
+
+    live.metaball_radius       = tuning.value(LIVE_METABALL_RADIUS);
+    live.influence             = tuning.value(LIVE_INFLUENCE);
+    live.iso                   = tuning.value(LIVE_ISO);
+    live.force                 = tuning.value(LIVE_FORCE);
+    live.damping               = tuning.value(LIVE_DAMPING);
+    live.cohesion_radius       = tuning.value(LIVE_COHESION_RADIUS);
+    live.particles_per_droplet = (int) tuning.value(LIVE_PARTICLES_PER_DROPLET);
+    live.physical_radius       = tuning.value(LIVE_PHYSICAL_RADIUS);
+    live.pbf                   = (int) tuning.value(LIVE_PBF);
+    live.bricks                = (int) tuning.value(LIVE_BRICKS);
+    live.lod_reduced           = tuning.value(LIVE_LOD_REDUCED);
+    live.lod_impostor          = tuning.value(LIVE_LOD_IMPOSTOR);
+    live.resolution_divisor    = (int) tuning.value(LIVE_RESOLUTION_DIVISOR);
+    live.wind_accel            = tuning.value(LIVE_WIND_ACCEL);
+    live.joint_stiffness       = tuning.value(LIVE_JOINT_STIFFNESS);
+    live.joint_damping         = tuning.value(LIVE_JOINT_DAMPING);
+    live.physics_rate          = tuning.value(LIVE_PHYSICS_RATE);
+    live.max_substeps          = (int) tuning.value(LIVE_MAX_SUBSTEPS);
+    live.physics_threads       = (int) tuning.value(LIVE_PHYSICS_THREADS);
+
+    launcher::PbfParams params;
+
+    params.particle_radius  = live.physical_radius;
+    params.smoothing_radius = live.cohesion_radius;
+    params.iterations       = PBF_ITERATIONS;
+    params.gravity          = dynamics_world->getGravity().getY();
+    params.cohesion         = live.force;
+    params.viscosity        = live.damping;
+
+    fluid.set_params(params);
+
+    launcher::DropletTrackerParams tracker_params = droplet_tracker.params();
+
+    tracker_params.radius = live.physical_radius * 20.0f; // was DROPLET_RADIUS (= physical * 20)
+
+    droplet_tracker.set_params(tracker_params);
+
+    render_properties.set("dropletResolutionDivisor", float(live.resolution_divisor)); // read by the forward pass
+  }
+
+  // SPH-style surface tension (Akinci et al. 2013): for every near pair of particles within a droplet,
+  // a COHESION force pulls them together with a kernel that is zero at contact and at the cohesion
+  // radius h and peaks in between (so the cluster minimises surface area without imploding), plus a
+  // VISCOSITY force that damps only their RELATIVE velocity (internal jiggle settles, bulk fall kept).
+  // Bullet's sphere collisions provide the short-range repulsion. Neighbours come from a cell list over
+  // a reused SoA buffer (see droplet_cohesion.h), so the cost grows linearly with the droplet size.
+  void apply_droplet_surface_tension()
+  {
+    launcher::CohesionParams params;
+
+    params.radius    = live.cohesion_radius;
+    params.cohesion  = live.force;   // cohesion strength (surface tension)
+    params.viscosity = live.damping; // relative-velocity damping
+
+    if (params.radius <= 1.0e-4f || fluid_active) // the fluid solver applies its own cohesion
+      return;
+
+    for (std::shared_ptr<Droplet>& droplet : droplets)
+    {
+      std::vector<std::shared_ptr<PhysBodySync>>& b = droplet->bodies;
+      const size_t n = b.size();
+      if (n < 2 || droplet->settled) // settled: no force and no activate(), so Bullet can put it to sleep
+        continue;
+
+      cohesion_particles.resize(n);
 
-      // each unordered pair once (j>i); the pair's accel is equal-and-opposite (equal masses), so apply
-      // +to i and -to j -> half the work of the naive i!=j double loop, same result.
       for (size_t i = 0; i < n; i++)
       {
-        const btVector3& pi = st_pos[i];
-        const btVector3& vi = st_vel[i];
-        for (size_t j = i + 1; j < n; j++)
-        {
-          btVector3 d  = pi - st_pos[j];
-          float     r2 = d.length2();
-          if (r2 >= h2 || r2 < 1.0e-10f)
-            continue;
-          float r   = std::sqrt(r2);
-          float x   = r / h;                    // 0..1
-          float w   = 4.0f * x * (1.0f - x);    // cohesion kernel: 0 at contact & at h, peak mid
-          btVector3 dir = d / r;                // from j to i
-          btVector3 ai  = dir * (-gamma * w)              // cohesion: pull i toward j
-                        + (st_vel[j] - vi) * (visc * w);  // viscosity: match neighbour velocity
-          st_acc[i] += ai;
-          st_acc[j] -= ai;                      // Newton's 3rd law (equal masses)
-        }
+        const btVector3& p = b[i]->body->getWorldTransform().getOrigin();
+        const btVector3& v = b[i]->body->getLinearVelocity();
+
+        cohesion_particles.px[i] = p.x(); cohesion_particles.py[i] = p.y(); cohesion_particles.pz[i] = p.z();
+        cohesion_particles.vx[i] = v.x(); cohesion_particles.vy[i] = v.y(); cohesion_particles.vz[i] = v.z();
       }
 
-      // st_acc is an ACCELERATION; multiply by the particle mass so the tiny mass (0.002) doesn't blow
+      cohesion.compute(cohesion_particles, params);
+
+      // the result is an ACCELERATION; multiply by the particle mass so the tiny mass (0.002) doesn't blow
       // it up. gamma/visc therefore read as accelerations, independent of the mass value.
       for (size_t i = 0; i < n; i++)
       {
         float inv_m = b[i]->body->getInvMass();
         float m     = inv_m > 0.0f ? 1.0f / inv_m : DROPLET_PARTICLE_MASS;
-        b[i]->body->applyCentralForce(st_acc[i] * m);
+        b[i]->body->applyCentralForce(btVector3(cohesion_particles.ax[i], cohesion_particles.ay[i], cohesion_particles.az[i]) * m);
         b[i]->body->activate(true);
       }
     }
   }
 
+  // At rest: at its spring target (a swaying branch moves the target) and asleep in Bullet or slower
+  // than the settle thresholds, all scaled by factor
+  bool leaf_at_rest(const Leaf& leaf, float factor) const
+  {
+    const btRigidBody& body      = *leaf.phys_body->body;
+    const btTransform& transform = body.getWorldTransform();
+
+    float distance      = LEAF_SETTLE_DISTANCE * factor;
+    float angle         = LEAF_SETTLE_ANGLE * factor;
+    float speed         = LEAF_SETTLE_SPEED * factor;
+    float angular_speed = LEAF_SETTLE_ANGULAR_SPEED * factor;
+
+    if (transform.getOrigin().distance2(leaf.target_transform.getOrigin()) >= distance * distance
+     || transform.getRotation().angleShortestPath(leaf.target_transform.getRotation()) >= angle)
+      return false;
+
+    return !body.isActive()
+        || (body.getLinearVelocity().length2() < speed * speed && body.getAngularVelocity().length2() < angular_speed * angular_speed);
+  }
+
+  static bool body_at_rest(const btRigidBody& body, float speed)
+  {
+    return !body.isActive() || body.getLinearVelocity().length2() < speed * speed;
+  }
+
+  // Live droplet particle i at rest (asleep in Bullet or slower than speed)
+  bool droplet_particle_at_rest(size_t i, float speed) const
+  {
+    if (!fluid_active)
+      return body_at_rest(*droplet_particles[i]->body, speed);
+
+    const launcher::PbfParticles& p = fluid.particles();
+
+    return p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i] + p.vz[i] * p.vz[i] < speed * speed;
+  }
+
+  bool droplet_at_rest(const Droplet& droplet) const
+  {
+    for (const std::shared_ptr<PhysBodySync>& body : droplet.bodies)
+      if (!body_at_rest(*body->body, DROPLET_SETTLE_SPEED))
+        return false;
+
+    for (uint32_t i : droplet.fluid_particles)
+      if (!droplet_particle_at_rest(i, DROPLET_SETTLE_SPEED))
+        return false;
+
+    return true;
+  }
+
+  // Settled droplet a particle label belongs to (nullptr if none or not settled)
+  Droplet* settled_droplet(uint32_t label) const
+  {
+    if (label == launcher::DropletTracker::NONE)
+      return nullptr;
+
+    uint32_t slot = launcher::DropletTracker::slot_of(label);
+
+    if (slot >= droplet_slots.size() || !droplet_slots[slot])
+      return nullptr;
+
+    Droplet* droplet = droplet_slots[slot].get();
+
+    return droplet->settled && droplet->id == label ? droplet : nullptr;
+  }
+
   // Metaball-raymarch surface update for one droplet: position+scale the proxy box to enclose the
-  // particle cluster, and upload the particle field (centres+radius) as per-node shader uniforms.
+  // particle cluster, pick the level of detail from the box's size on screen, and write the particle
+  // field (centres+radius) into the droplet's raymarch block.
+  // Only what changed is marked for upload (upload_droplet_raymarch); no allocation per frame.
   // Replaces the convex-hull build for raymarch droplets; the cubemap reflection/refraction is
   // unchanged (rendered from the droplet centre as before).
   void update_droplet_raymarch(const std::shared_ptr<Droplet>& droplet)
@@ -1844,86 +3115,237 @@ struct World::Impl: RigidBodyWorldCommonData
     if (!droplet->hull_mesh || droplet->points.empty())
       return;
 
-    std::vector<math::vec4f> particles;
-    particles.reserve(MAX_DROPLET_RAYMARCH_PARTICLES);
+    DropletUniforms& block = droplet->raymarch;
 
-      //evenly sample up to the shader's fixed array size from the (now denser) cluster.
-      //spreads MAX picks across the whole set, so a 100-particle droplet actually uses all 64
-      //(the old stride-by-ceil only used ~50 of 100).
+      //the cluster's extent (this step's particle positions) sizes the box and selects the LOD
+
+    float max_dist = 0.0f, sum_dist = 0.0f;
+
+    for (const math::vec3f& p : droplet->points)
+    {
+      float dist = length(p - droplet->center);
+
+      max_dist  = std::max(max_dist, dist);
+      sum_dist += dist;
+    }
+
+    float      box_half = (max_dist + live.metaball_radius + live.influence) * DROPLET_RAYMARCH_BOX_MARGIN;
+    DropletLod lod      = droplet_lod(droplet->center, box_half);
+
+    droplet->hull_mesh->set_position(droplet->center);
+    droplet->hull_mesh->set_scale(math::vec3f(box_half));
+
+    if (!DROPLET_REFLECT_SKYBOX)
+      droplet->hull_mesh->set_environment_map_local_point(math::vec3f(0.0f)); // node sits at the centre -> dynamic cubemap eye = centre
+
+    write_raymarch(*droplet, block.center, droplet->center);
+    write_raymarch(*droplet, block.box_half_extent, box_half);
+    write_raymarch(*droplet, block.influence, live.influence);
+    write_raymarch(*droplet, block.iso, live.iso);
+    write_raymarch(*droplet, block.lod, int32_t(lod));
+    write_raymarch(*droplet, block.max_steps, int32_t(lod == DROPLET_LOD_FULL ? DROPLET_LOD_FULL_STEPS : DROPLET_LOD_REDUCED_STEPS));
+
+      //impostor: one sphere around the centre, as wide as the particles' mean spread plus a metaball
 
     size_t count = droplet->points.size();
-    size_t used  = count < MAX_DROPLET_RAYMARCH_PARTICLES ? count : MAX_DROPLET_RAYMARCH_PARTICLES;
 
-    float max_dist = 0.0f;
+    if (lod == DROPLET_LOD_IMPOSTOR)
+    {
+      float radius = sum_dist / float(count) + live.metaball_radius + live.iso;
+
+      write_raymarch(*droplet, block.particles[0], math::vec4f(droplet->center[0], droplet->center[1], droplet->center[2], radius));
+      write_raymarch(*droplet, block.particles_count, int32_t(1));
+      write_raymarch(*droplet, block.brick_resolution, int32_t(0));
+
+      return;
+    }
+
+      //evenly sample up to the shader's fixed array size (fewer when reduced) from the (now denser) cluster.
+      //spreads MAX picks across the whole set, so a 100-particle droplet actually uses all 64
+      //(the old stride-by-ceil only used ~50 of 100). Particles are drawn in between the last two
+      //physics steps (bodies[i] / fluid_particles[i] is points[i]'s), like the synced meshes.
+
+    size_t max_used = lod == DROPLET_LOD_FULL ? MAX_DROPLET_RAYMARCH_PARTICLES : DROPLET_LOD_REDUCED_PARTICLES;
+    size_t used     = count < max_used ? count : max_used;
 
     for (size_t k = 0; k < used; k++)
     {
-      size_t i = (count <= MAX_DROPLET_RAYMARCH_PARTICLES) ? k : (k * count) / used;
-      const math::vec3f& p = droplet->points[i];
-      particles.push_back(math::vec4f(p[0], p[1], p[2], live.metaball_radius));
-      max_dist = std::max(max_dist, length(p - droplet->center));
+      size_t i = (count <= max_used) ? k : (k * count) / used;
+      math::vec3f p;
+
+      if (fluid_active)
+      {
+        fluid.position_at(droplet->fluid_particles[i], physics_alpha, &p[0]);
+      }
+      else
+      {
+        btVector3 bt_p = droplet->bodies[i]->states.origin_at(physics_alpha);
+
+        p = math::vec3f(bt_p.x(), bt_p.y(), bt_p.z());
+      }
+
+      write_raymarch(*droplet, block.particles[k], math::vec4f(p[0], p[1], p[2], live.metaball_radius));
     }
 
-    int particle_count = (int)particles.size();
+      //entries past particles_count keep whatever they held; the shader breaks at particleCount
 
-      //pad to the shader array size; padding entries are never sampled (the shader breaks at particleCount)
+    write_raymarch(*droplet, block.particles_count, int32_t(used));
 
-    particles.resize(MAX_DROPLET_RAYMARCH_PARTICLES, math::vec4f(0.0f));
+      //baked field: the brick's resolution follows the box's share of the view height
 
-    float box_half = (max_dist + live.metaball_radius + live.influence) * DROPLET_RAYMARCH_BOX_MARGIN;
+    size_t brick_resolution = 0;
 
-    droplet->hull_mesh->set_position(droplet->center);
-    droplet->hull_mesh->set_scale(math::vec3f(box_half));
+    if (live.bricks)
+    {
+      brick_resolution = launcher::DropletBrick::resolution_for(droplet_screen_fraction(droplet->center, box_half),
+        DROPLET_BRICK_VOXELS_PER_SCREEN);
 
-    if (!DROPLET_REFLECT_SKYBOX)
-      droplet->hull_mesh->set_environment_map_local_point(math::vec3f(0.0f)); // node sits at the centre -> dynamic cubemap eye = centre
+      droplet->brick.splat(&block.particles[0][0], used, &droplet->center[0], box_half, brick_resolution,
+        {live.influence, live.iso});
 
-    common::PropertyMap props;
-    props.set("particles", particles);
-    props.set("particleCount", particle_count);
-    props.set("dropletCenter", droplet->center);
-    props.set("influenceRadius", live.influence);
-    props.set("isoThreshold", live.iso);
-    props.set("boxHalfExtent", box_half);
+      droplet->brick_dirty = true;
+    }
 
-    droplet->hull_mesh->set_user_data(props);
+    write_raymarch(*droplet, block.brick_resolution, int32_t(brick_resolution));
   }
 
-  void update(float dt)
+  // Share of the view height a droplet's proxy box covers (view_eye / view_scale of this frame)
+  float droplet_screen_fraction(const math::vec3f& center, float box_half) const
   {
-    last_frame_time = clock();
+    return box_half * view_scale / std::max(length(center - view_eye), 1.0e-3f);
+  }
 
-    // keep the skybox centred on the camera so it reads as infinitely far (no parallax during movement)
-    sky->set_position(math::vec3f(camera->world_tm() * math::vec4f(0.0f, 0.0f, 0.0f, 1.0f)));
+  DropletLod droplet_lod(const math::vec3f& center, float box_half) const
+  {
+    float fraction = droplet_screen_fraction(center, box_half);
 
-    refresh_live_tuning(); // pull droplet knobs from the in-page sliders (web)
+    if (fraction < live.lod_impostor) return DROPLET_LOD_IMPOSTOR;
+    if (fraction < live.lod_reduced)  return DROPLET_LOD_REDUCED;
 
-      //debug dump
+    return DROPLET_LOD_FULL;
+  }
 
-    if (last_frame_time - last_debug_dump_time > DEBUG_DUMP_INTERVAL)
-    {
-      last_debug_dump_time = last_frame_time;
-      engine_log_debug("Droplets count: %d (particles count %d)", droplets.size(), droplet_particles.size());
-    }
+  // Set a field of a droplet's raymarch block, widening the byte range to upload if it changed
+  template <class T>
+  static void write_raymarch(Droplet& droplet, T& field, const T& value)
+  {
+    if (!memcmp(&field, &value, sizeof(T)))
+      return;
 
-      //step the simulation with the real frame time (clamped to avoid a spiral of death), advancing
-      //by a fixed 1/60 substep so behaviour is frame-rate independent (was hardcoded 1/60 per frame ->
-      //0.5x speed at 30fps, 2x at 120Hz). Bullet's substep count then drives the water at the same rate.
+    field = value;
 
-    float clamped_dt = dt < (1.f / 4.f) ? dt : (1.f / 4.f);
+    size_t begin = reinterpret_cast<const char*>(&field) - reinterpret_cast<const char*>(&droplet.raymarch);
 
-    last_substeps = dynamics_world->stepSimulation(clamped_dt, 10, 1.f / 60.f);
+    droplet.raymarch_dirty_begin = std::min(droplet.raymarch_dirty_begin, begin);
+    droplet.raymarch_dirty_end   = std::max(droplet.raymarch_dirty_end, begin + sizeof(T));
+  }
 
-      //generate droplets
+  // Send the changed bytes of a droplet's raymarch block to its uniform buffer, created by the first
+  // call and bound as the proxy box's user data (GL: main thread)
+  void upload_droplet_raymarch(Droplet& droplet)
+  {
+    if (!droplet.raymarch_buffer)
+      droplet.raymarch_buffer = &droplet.hull_mesh->set_user_data(render_device.create_uniform_buffer(sizeof(DropletUniforms)));
 
-    generate_droplet();
+    const char* data = reinterpret_cast<const char*>(&droplet.raymarch);
 
-      //advance procedural plant growth (time-driven branch growth) + leaf unfurl
+    droplet.raymarch_buffer->set_data(droplet.raymarch_dirty_begin, droplet.raymarch_dirty_end - droplet.raymarch_dirty_begin,
+      data + droplet.raymarch_dirty_begin);
 
-    update_plants(clamped_dt);
-    update_leaf_growth(clamped_dt);
+    droplet.raymarch_dirty_begin = sizeof(DropletUniforms);
+    droplet.raymarch_dirty_end   = 0;
+  }
+
+  // Send a droplet's splatted brick to its 3D texture, (re)created as the proxy box's user data when the
+  // resolution changes (GL: main thread)
+  void upload_droplet_brick(Droplet& droplet)
+  {
+    const size_t resolution = droplet.brick.resolution();
+
+    if (!droplet.brick_texture || droplet.brick_texture->width() != resolution)
+      droplet.brick_texture = &droplet.hull_mesh->set_user_data(render_device.create_texture3d(resolution, resolution, resolution, PixelFormat_R16F));
+
+    droplet.brick_texture->set_data(0, 0, 0, resolution, resolution, resolution, droplet.brick.data());
+
+    droplet.brick_dirty = false;
+  }
+
+  // Render side for a tracker slot: proxy box, created once per slot (its light after the update graph,
+  // the raymarch buffer on its first upload)
+  std::shared_ptr<Droplet>& droplet_slot(uint32_t id)
+  {
+    uint32_t slot = launcher::DropletTracker::slot_of(id);
+
+    if (slot >= droplet_slots.size())
+      droplet_slots.resize(slot + 1);
+
+    std::shared_ptr<Droplet>& droplet = droplet_slots[slot];
+
+    if (droplet)
+      return droplet;
+
+    droplet = std::make_shared<Droplet>();
+
+    droplet->hull_mesh = scene::Mesh::create();
+
+    // per-droplet dynamic env-map prerendering; skipped when reflecting the static skybox (saves the
+    // whole-scene cubemap re-render per droplet).
+    if (!DROPLET_REFLECT_SKYBOX)
+      droplet->hull_mesh->set_environment_map_required(true);
+
+    // proxy box (unit cube [-1,1]); positioned at the centre + scaled to enclose the metaball each frame.
+    // The fragment shader raymarches the particle SDF inside it; the cube itself is never seen.
+    droplet->hull_mesh->set_mesh(media::geometry::MeshFactory::create_box(DROPLET_FLUID_MATERIAL, 2.f, 2.f, 2.f));
+
+    created_droplet_slots.push_back(slot); // its light draws random_engine: main thread
+
+    return droplet;
+  }
+
+  // A new droplet slot's point light, with a random colour, intensity and range
+  void create_droplet_light(Droplet& droplet)
+  {
+    droplet.point_light = scene::PointLight::create();
+
+    droplet.point_light->set_light_color(math::vec3f(crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY), crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY), crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY)));
+    droplet.point_light->set_attenuation(LIGHTS_ATTENUATION);
+    droplet.point_light->set_intensity(crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY));
+    droplet.point_light->set_range(crand(LIGHTS_MIN_RANGE, LIGHTS_MAX_RANGE));
+    droplet.point_light->set_position(math::vec3f(0, 0.2, 0));
+    //droplet.point_light->bind_to_parent(*droplet.hull_mesh); //note: hull mesh is in world coords, point light should be moved separately
+  }
+
+  // The tracking task's scene changes, on the main thread after the update graph: lights for the droplet
+  // slots it created (in creation order, so the random sequence does not depend on the workers) and the
+  // droplets it showed or hid bound to / unbound from the scene
+  void apply_droplet_tracking()
+  {
+    for (uint32_t slot : created_droplet_slots)
+      create_droplet_light(*droplet_slots[slot]);
+
+    created_droplet_slots.clear();
+
+    if (DROPLET_DEBUG_DRAW)
+      return;
+
+    for (std::shared_ptr<Droplet>& droplet : droplet_slots)
+    {
+      if (!droplet || droplet->shown == droplet->visible)
+        continue;
+
+      if (droplet->visible) droplet->hull_mesh->bind_to_parent(*scene_root);
+      else                  droplet->hull_mesh->unbind();
+
+      droplet->shown = droplet->visible;
+    }
+  }
 
-      //update leaves
+  // Spring the leaves back to their (branch-relative) rest pose; settled ones skip the spring and the mesh
+  // sync until they move or are grabbed
+  void update_leaves()
+  {
+    settle_counters.leaves         = leaves.size();
+    settle_counters.leaves_settled = 0;
 
     for (Leaf& leaf : leaves)
     {
@@ -1933,6 +3355,22 @@ struct World::Impl: RigidBodyWorldCommonData
         leaf.target_transform = leaf.skeleton_bone->getWorldTransform() * leaf.rest_local;
 
       btRigidBody* body = leaf.phys_body->body.get();
+      bool grabbed = body == grabbed_object;
+
+      if (leaf.phys_body->settled)
+      {
+        if (!grabbed && leaf_at_rest(leaf, SETTLE_WAKE_FACTOR))
+        {
+          settle_counters.leaves_settled++;
+          continue;
+        }
+
+        leaf.phys_body->settled = false;
+        leaf.calm_frames        = 0;
+
+        body->activate(true);
+      }
+
       float inv_mass = body->getInvMass();
       float mass = inv_mass == 0.0f ? 0.0f : 1.0f / inv_mass;
 
@@ -1953,8 +3391,26 @@ struct World::Impl: RigidBodyWorldCommonData
 
       body->applyCentralForce(force);
       body->applyTorque(torque);
+
+      bool growing = leaf.grow_age < leaf.grow_duration;
+
+      leaf.calm_frames = !grabbed && !growing && leaf_at_rest(leaf, 1.0f) ? leaf.calm_frames + 1 : 0;
+
+      if (leaf.calm_frames >= SETTLE_FRAMES)
+      {
+          //let Bullet put it to sleep too (it stays awake while its island holds a moving body)
+
+        leaf.phys_body->settled = true;
+
+        body->setActivationState(ISLAND_SLEEPING);
+      }
     }
+  }
 
+  // Retire fallen droplet particles, track the rest into droplets, gather every droplet's particles and
+  // settle the droplets at rest
+  void update_droplet_tracking()
+  {
       //remove fallen droplets
 
     for (std::shared_ptr<PhysBodySync>& particle : droplet_particles)
@@ -1970,234 +3426,200 @@ struct World::Impl: RigidBodyWorldCommonData
       fallen_droplet_particles_count++;
 
         //a droplet reaching the water surface no longer disturbs it (no impact ripple)
+
+      droplet_particle_pool.retire(*particle); // parks it far below -> dropped from the list right after
     }
 
     droplet_particles.erase(std::remove_if(droplet_particles.begin(), droplet_particles.end(), [](const std::shared_ptr<PhysBodySync>& particle) {
-      return particle->body->getWorldTransform().getOrigin().getY() < MIN_DROPLET_PARTICLE_HEIGHT;
+      return particle->droplet_particle->fallen;
     }), droplet_particles.end());
 
-      //and drop them from the master list too, so ~PhysBodySync removes the rigid body from the Bullet world
-      //(only droplet particles; ground/leaf bodies have no droplet_particle and are left untouched)
+    if (fluid_active)
+      fallen_droplet_particles_count += fluid.retire_below(MIN_DROPLET_PARTICLE_HEIGHT);
 
-    phys_bodies.erase(std::remove_if(phys_bodies.begin(), phys_bodies.end(), [](const std::shared_ptr<PhysBodySync>& body) {
-      return body->droplet_particle && body->droplet_particle->fallen;
-    }), phys_bodies.end());
+      //track droplet particles into droplets: a particle keeps the droplet it was in while it stays
+      //near it, only the ones that left (and new ones) look for a droplet; ids and slots are stable
 
-      //clusterize droplet particles to droplets
+    droplet_tracker.begin();
 
-    float cluster_radius = live.physical_radius * 20.0f; // was DROPLET_RADIUS (= physical * 20)
+    const size_t particles_count = droplet_particles_count();
 
-    for (size_t i=0; i<CLUSTERIZE_STEPS_COUNT; i++)
+    for (size_t k=0; k<particles_count; k++)
     {
-        //clear clusters
+      uint32_t label   = droplet_particle_label(k);
+      Droplet* settled = settled_droplet(label);
 
-      for (std::shared_ptr<Droplet>& droplet : droplets)
+      if (settled)
       {
-        droplet->points.clear();
-        droplet->bodies.clear(); // was never cleared -> bodies accumulated across passes/frames, ramping cohesion force and leaking refs
-      }
-
-        //clusterization step
-
-      for (std::shared_ptr<PhysBodySync>& particle : droplet_particles)
-      {
-        btVector3 bt_position = particle->body->getWorldTransform().getOrigin();
-        math::vec3f position(bt_position.getX(), bt_position.getY(), bt_position.getZ());
-        bool added = false;
-
-        for (std::shared_ptr<Droplet>& droplet : droplets)
+        if (droplet_particle_at_rest(k, DROPLET_SETTLE_SPEED * SETTLE_WAKE_FACTOR))
         {
-          float distance = length(droplet->center - position);
+          settled->held_particles++; // keeps its label, counted at the droplet's last centre
+          continue;
+        }
 
-          if (distance < cluster_radius)
-          {
-            droplet->points.push_back(position);
-            droplet->bodies.push_back(particle);
+        settled->woken = true;
+      }
 
-            droplet->center = math::vec3f(0.0f, 0.0f, 0.0f);
+      set_droplet_particle_label(k, droplet_tracker.track(droplet_particle_position(k), label));
+    }
 
-            for (const math::vec3f& point : droplet->points)
-              droplet->center += point;
+    settle_counters.droplet_particles_held = 0;
 
-            droplet->center /= droplet->points.size();
+    for (std::shared_ptr<Droplet>& droplet : droplets) // last frame's
+    {
+      droplet_tracker.hold(droplet->id, droplet->held_particles);
 
-            added = true;
-            break;
-          }
-        }
+      settle_counters.droplet_particles_held += droplet->held_particles;
+      droplet->held_particles                 = 0;
+    }
+
+    droplet_tracker.end();
 
-        if (!added)
+    for (const launcher::DropletEvent& event : droplet_tracker.events())
+    {
+      switch (event.type)
+      {
+        case launcher::DropletEventType::created:
+        case launcher::DropletEventType::split:
         {
-          std::shared_ptr<Droplet> droplet = std::make_shared<Droplet>();
+          Droplet& droplet = *droplet_slot(event.droplet);
+
+          droplet.id          = event.droplet;
+          droplet.settled     = false;
+          droplet.calm_frames = 0;
+          droplet.woken       = false;
 
-          droplet->center = position;
-          droplet->points.push_back(position);
-          droplet->bodies.push_back(particle);
-          
-          droplets.push_back(droplet);
+          break;
         }
+        case launcher::DropletEventType::merged:
+        case launcher::DropletEventType::removed:
+          droplet_slot(event.droplet)->visible = false;
+          break;
       }
+    }
 
-      size_t fake_droplets = 0;
-
-      for (std::shared_ptr<Droplet>& droplet : droplets)
-      {
-        if (droplet->points.size() < MIN_DROPLET_PARTICLES_COUNT && droplet->remove_counter != 0)
-          fake_droplets++;
-      }
+      //gather the droplets' particles (labels of merged droplets forward to the survivor)
 
-      size_t normal_droplets = droplets.size() - fake_droplets;
+    droplets.clear();
 
-//      engine_log_debug("step=%d, radius=%f, droplets=%d/%d", i, cluster_radius, normal_droplets, droplets.size());
+    for (size_t i=0, count=droplet_tracker.droplets_count(); i<count; i++)
+    {
+      const launcher::TrackedDroplet& tracked = droplet_tracker.droplet(i);
+      std::shared_ptr<Droplet>&       droplet = droplet_slot(tracked.id);
 
-      if (normal_droplets <= PREFERRED_MAX_DROPLETS_COUNT)
-        break;
+      droplet->center = tracked.center;
 
-        //cleanup clusterization step
+      droplet->points.clear();
+      droplet->bodies.clear();
+      droplet->fluid_particles.clear();
 
-      droplets.erase(std::remove_if(droplets.begin(), droplets.end(), [](const std::shared_ptr<Droplet>& droplet) {
-        return droplet->hull_mesh == nullptr;
-      }), droplets.end());
+      droplet->visible = tracked.visible;
 
-      cluster_radius *= CLUSTERIZE_STEP_FACTOR;
+      droplets.push_back(droplet);
     }
 
-      //create hulls
-
-    for (std::shared_ptr<Droplet>& droplet : droplets)
+    for (size_t k=0; k<particles_count; k++)
     {
-      if (droplet->hull_mesh)
-        continue;
+      uint32_t label = droplet_tracker.resolve(droplet_particle_label(k));
 
-      droplet->hull_mesh = scene::Mesh::create();
+      set_droplet_particle_label(k, label);
 
-      // per-droplet dynamic env-map prerendering; skipped when reflecting the static skybox (saves the
-      // whole-scene cubemap re-render per droplet).
-      if (!DROPLET_REFLECT_SKYBOX)
-        droplet->hull_mesh->set_environment_map_required(true);
+      if (label == launcher::DropletTracker::NONE)
+        continue;
 
-      // proxy box (unit cube [-1,1]); positioned at the centre + scaled to enclose the metaball each frame.
-      // The fragment shader raymarches the particle SDF inside it; the cube itself is never seen.
-      droplet->hull_mesh->set_mesh(media::geometry::MeshFactory::create_box(DROPLET_FLUID_MATERIAL, 2.f, 2.f, 2.f));
+      Droplet& droplet = *droplet_slots[launcher::DropletTracker::slot_of(label)];
 
-      droplet->point_light = scene::PointLight::create();
+      droplet.points.push_back(droplet_particle_position(k));
 
-      droplet->point_light->set_light_color(math::vec3f(crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY), crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY), crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY)));
-      droplet->point_light->set_attenuation(LIGHTS_ATTENUATION);
-      droplet->point_light->set_intensity(crand(LIGHTS_MIN_INTENSITY, LIGHTS_MAX_INTENSITY));
-      droplet->point_light->set_range(crand(LIGHTS_MIN_RANGE, LIGHTS_MAX_RANGE));
-      droplet->point_light->set_position(math::vec3f(0, 0.2, 0));
+      if (fluid_active) droplet.fluid_particles.push_back(uint32_t(k));
+      else              droplet.bodies.push_back(droplet_particles[k]);
+    }
 
-      if (!DROPLET_DEBUG_DRAW)
-      {
-        droplet->hull_mesh->bind_to_parent(*scene_root);
-        //droplet->point_light->bind_to_parent(*droplet->hull_mesh); //note: hull mesh is in world coords, point light should be moved separately
-      }
+      //settle droplets at rest; wake settled ones that moved or gained / lost particles
 
-        //find largest droplet
+    settle_counters.droplets         = droplets.size();
+    settle_counters.droplets_settled = 0;
 
-      Droplet* largest_droplet = nullptr;
+    for (size_t i=0, count=droplets.size(); i<count; i++)
+    {
+      const launcher::TrackedDroplet& tracked = droplet_tracker.droplet(i);
+      Droplet&                        droplet = *droplets[i];
 
-      for (auto& droplet : droplets)
+      if (droplet.settled && (droplet.woken || tracked.particles != droplet.settled_particles))
       {
-        if (!largest_droplet || droplet->points.size() > largest_droplet->points.size())
-          largest_droplet = droplet.get();
+        droplet.settled     = false;
+        droplet.calm_frames = 0;
       }
-
-        //synchronize camera
-
-      if (largest_droplet)
+      else if (!droplet.settled)
       {
-        math::vec3f center = largest_droplet->center;
-
-        static float TARGET_DISTANCE = 2;
-        static float POSITION_INTERPOLATION_FACTOR = 0.0001f;
-        static float TARGET_INTERPOLATION_FACTOR = 0.00001f;
-
-        math::vec3f required_camera_position = center + normalize(math::vec3f(1, 0.5, 0)) * TARGET_DISTANCE;
-        math::vec3f required_camera_target = center;
-        math::vec3f current_camera_position = math::vec3f(camera->world_tm() * math::vec4f(0, 0, 0, 1));
-        math::vec3f current_camera_target = current_camera_position + math::vec3f(camera->world_tm() * math::vec4f(0, 1, 0, 0));
-        math::vec3f new_camera_position = current_camera_position + (required_camera_position - current_camera_position) * POSITION_INTERPOLATION_FACTOR;
-        math::vec3f new_camera_target = current_camera_target + (required_camera_target - current_camera_target) * TARGET_INTERPOLATION_FACTOR;
+        droplet.calm_frames = tracked.visible && droplet_at_rest(droplet) ? droplet.calm_frames + 1 : 0;
 
-        //camera->set_position(inverse(camera->parent()->world_tm()) * new_camera_position);
-        //camera->world_look_to(-new_camera_target, math::vec3f(0, 1, 0));
+        if (droplet.calm_frames >= SETTLE_FRAMES)
+        {
+          droplet.settled           = true;
+          droplet.settled_particles = tracked.particles;
+        }
       }
-    }
 
-    //configure droplets
+      droplet.woken = false;
 
-    for (std::shared_ptr<Droplet>& droplet : droplets)
-    {
-      math::vec3f center(0.0f);
-
-      if (droplet->points.empty())
-      {
-        droplet->center = center;
-        droplet->prev_centers.push_back(center);
-        continue;
-      }
-      
-      for (const math::vec3f& point : droplet->points)
-      {
-        center += point;
-      }
-      
-      droplet->center = center / droplet->points.size();
-      droplet->prev_centers.push_back(droplet->center);
+      if (droplet.settled)
+        settle_counters.droplets_settled++;
     }
+  }
 
-    for (std::shared_ptr<Droplet>& droplet : droplets)
-    {
-      if (droplet->prev_centers.size() > DROPLET_CENTER_APPROXIMATION_STEPS_COUNT)
-        droplet->prev_centers.pop_front();
+  // World::update's phases that do not touch each other's state, as a task graph on the worker pool
+  // (inline, in this order, without threads):
+  //   plants:          leaf springs and instance poses (leaf bodies, leaf batches), then the skeleton
+  //                    poses, one plant per job
+  //   clustering:      fallen particles, droplet tracking and settling (droplet particles and slots; their
+  //                    scene nodes and lights are applied after the graph, apply_droplet_tracking)
+  //   raymarch upload: after clustering, one droplet per job
+  //   cohesion:        after clustering, forces on the droplet particles
+  //   water:           the ripple steps (water grids, with their own random generator)
+  // Bodies are added to the Bullet world, scene nodes bound, random_engine drawn and GL touched on the
+  // main thread only, before or after the graph. Each task times its own phase.
+  void build_update_graph()
+  {
+    typedef common::TaskGraph::TaskId TaskId;
 
-      math::vec3f center(0.0f);
+    update_graph.add("World::plants", [this] {
+      uint64_t start = common::profiler::timestamp();
 
-      for (const math::vec3f& prev_center : droplet->prev_centers)
-        center += prev_center;
+      update_leaves();
 
-      center /= droplet->prev_centers.size();
+      for (Leaf& leaf : leaves)
+        if (leaf.batch && !leaf.phys_body->settled) // a settled leaf's instance is still in place
+          pose_leaf(leaf);
 
-      droplet->center = center;
-    }
+      jobs.parallel_for(0, plants.size(), 1, [this](size_t i) {
+        if (plants[i]->skeletonized) // a growing plant's mesh is static (set_plant_growth)
+          pose_skeleton(plants[i]);
+      });
 
-    //remove empty droplets
+      timings.plants += milliseconds_since(start); // after update_plants' share
+    });
 
-    for (std::shared_ptr<Droplet>& droplet : droplets)
-    {
-      if (droplet->points.size() < MIN_DROPLET_PARTICLES_COUNT)
-      {
-        droplet->remove_counter++;
+    TaskId clustering = update_graph.add("World::clustering", [this] {
+      uint64_t start = common::profiler::timestamp();
 
-        if (!DROPLET_DEBUG_DRAW)
-          droplet->hull_mesh->unbind();
-      }
-      else
-      {
-        if (!DROPLET_DEBUG_DRAW)
-          droplet->hull_mesh->bind_to_parent(*scene_root);
-        droplet->remove_counter = 0;
-      }
-    }
+      update_droplet_tracking();
 
-      //a single procedural plant grows from startup (see spawn_initial_plant / update_plants); the old
-      //water-triggered multi-plant spawning is disabled. Keep the droplet-landing chime.
+      timings.clustering = milliseconds_since(start);
+    });
 
-    if (fallen_droplet_particles_count > PLANT_FALLEN_DROPLET_PARTICLES_COUNT_THRESHOLD)
-    {
-      SoundPlayer::play_sound(SoundId::droplet_ground);
-      fallen_droplet_particles_count = 0;
-    }
+      //build droplet surfaces (metaball raymarch)
 
-    droplets.erase(std::remove_if(droplets.begin(), droplets.end(), [](const std::shared_ptr<Droplet>& droplet) { return droplet->remove_counter > DROPLET_REMOVE_COUNTER_THRESHOLD; }),
-      droplets.end());
+    TaskId raymarch_upload = update_graph.add("World::raymarch_upload", [this] {
+      uint64_t start = common::profiler::timestamp();
 
-    //build droplet surfaces (metaball raymarch)
+      jobs.parallel_for(0, droplets.size(), 1, [this](size_t i) {
+        if (!droplets[i]->settled) // a settled droplet's block is still in place
+          update_droplet_raymarch(droplets[i]);
+      });
 
-    for (std::shared_ptr<Droplet>& droplet : droplets)
-      update_droplet_raymarch(droplet);
+      timings.raymarch_upload = milliseconds_since(start);
+    });
 
     //surface tension: SPH-style PAIRWISE cohesion + viscosity between neighbouring particles within
     //each droplet (Akinci et al. 2013). Cohesion attracts near pairs with a kernel that is 0 at contact
@@ -2207,37 +3629,144 @@ struct World::Impl: RigidBodyWorldCommonData
     //jiggle settles while the droplet's bulk fall is preserved. Bullet's sphere collisions supply the
     //short-range repulsion, so equilibrium spacing sits near contact.
 
-    apply_droplet_surface_tension();
+    TaskId cohesion_task = update_graph.add("World::cohesion", [this] {
+      uint64_t start = common::profiler::timestamp();
 
-      //sync bodies with scene
+      apply_droplet_surface_tension();
+
+      timings.cohesion = milliseconds_since(start);
+    });
+
+      //water surface: fixed WATER_STEP_RATE steps over the same (clamped) frame time as the physics,
+      //capped at WATER_MAX_STEPS per frame like the physics substeps (the rest of a long frame is dropped)
+
+    update_graph.add("World::water", [this] {
+      uint64_t    start      = common::profiler::timestamp();
+      const float water_step = 1.f / WATER_STEP_RATE;
+
+      water_step_time = std::min(water_step_time + update_dt, water_step * WATER_MAX_STEPS);
+
+      for (; water_step_time >= water_step; water_step_time -= water_step) // real-time, fps- and physics-rate-independent
+        water_surface.update();
+
+      timings.water = milliseconds_since(start);
+    });
+
+    update_graph.depend(raymarch_upload, clustering);
+    update_graph.depend(cohesion_task, clustering);
+  }
+
+  void update(float dt)
+  {
+    engine_profile_zone("World::update");
 
-    for (std::shared_ptr<PhysBodySync>& particle : phys_bodies)
+    PhaseStopwatch stopwatch;
+    double         other = 0.0; // live tuning, lights, sounds, body sync, fireflies
+
+    world_time += dt;
+    last_frame_time = clock_t(world_time * CLOCKS_PER_SEC);
+
+    // keep the skybox centred on the camera so it reads as infinitely far (no parallax during movement)
+    sky->set_position(math::vec3f(camera->world_tm() * math::vec4f(0.0f, 0.0f, 0.0f, 1.0f)));
+
+    refresh_live_tuning(); // re-derive the knobs if a slider or assignment changed one
+
+    if ((live.pbf != 0) != fluid_active)
+      switch_droplet_solver(live.pbf != 0);
+
+    if ((live.physics_threads != 0) != physics_threads_active)
+      switch_physics_threads(live.physics_threads != 0);
+
+      //debug dump
+
+    if (last_frame_time - last_debug_dump_time > DEBUG_DUMP_INTERVAL)
     {
-      if (!particle->mesh) // invisible droplet particle (debug draw off) -> nothing to sync
-        continue;
+      last_debug_dump_time = last_frame_time;
+      const DropletParticlePoolStats& pool = droplet_particle_pool.stats;
+
+      engine_log_debug("Droplets count: %d (particles count %d, %s)", droplets.size(), droplet_particles_count(), fluid_active ? "fluid" : "bullet");
+      engine_log_debug("Settled: %u/%u droplets (%u particles held), %u/%u leaves",
+        (unsigned) settle_counters.droplets_settled, (unsigned) settle_counters.droplets, (unsigned) settle_counters.droplet_particles_held,
+        (unsigned) settle_counters.leaves_settled, (unsigned) settle_counters.leaves);
+      engine_log_debug("Droplet LOD: %u full, %u reduced, %u impostor",
+        (unsigned) droplet_lod_counters.full, (unsigned) droplet_lod_counters.reduced, (unsigned) droplet_lod_counters.impostor);
+      engine_log_debug("Contacts: %u events, %u pairs, %u dropped",
+        (unsigned) contact_stats.events, (unsigned) contact_stats.pairs, (unsigned) contact_stats.dropped);
+      engine_log_debug("Leaf shapes: %u cached (%u KB), %u hits, %u misses, %u uncached, %u evicted",
+        (unsigned) leaf_shapes.stats.shapes, (unsigned) (leaf_shapes.stats.bytes / 1024), (unsigned) leaf_shapes.stats.hits,
+        (unsigned) leaf_shapes.stats.misses, (unsigned) leaf_shapes.stats.uncached, (unsigned) leaf_shapes.stats.evictions);
+      engine_log_debug("Particle pool: %u bodies created, %u spawned, %u retired, %u refused",
+        (unsigned) pool.bodies_created, (unsigned) pool.spawned, (unsigned) pool.retired, (unsigned) pool.exhausted);
+    }
 
-      btTransform transform;
+      //step the simulation with the real frame time in fixed 1 / rate steps, so behaviour is frame-rate
+      //independent. The frame time is clamped to the substep budget (spiral-of-death cap: a long frame
+      //runs at most max_substeps steps and the rest of it is dropped). The renderer interpolates between
+      //the last two steps (physics_alpha).
 
-      if (particle->body && particle->body->getMotionState())
-      {
-        particle->body->getMotionState()->getWorldTransform(transform);
-      }
-      else
-      {
-        transform = particle->body->getWorldTransform();
-      }
+    const float physics_step = 1.f / std::max(live.physics_rate, 1.f);
+    const int   max_substeps = std::max(live.max_substeps, 1);
+
+    float clamped_dt = std::min(dt, physics_step * max_substeps);
 
-      particle->mesh->set_position(math::vec3f(transform.getOrigin().getX(), transform.getOrigin().getY(), transform.getOrigin().getZ()));
-      particle->mesh->set_orientation(math::quatf(transform.getRotation().getX(), transform.getRotation().getY(), transform.getRotation().getZ(), transform.getRotation().getW()));
+    other += stopwatch.lap("World::tuning");
 
-	  //engine_log_debug("world pos object = %f,%f,%f\n", float(transform.getOrigin().getX()), float(transform.getOrigin().getY()), float(transform.getOrigin().getZ())); 
+    last_substeps = dynamics_world->stepSimulation(clamped_dt, max_substeps, physics_step);
+    physics_alpha = std::min(dynamics_world->step_remainder() / physics_step, btScalar(1));
+
+    drain_contact_events();
+
+    timings.step = stopwatch.lap("World::step");
+
+      //generate droplets
+
+    generate_droplet();
+
+    timings.spawn = stopwatch.lap("World::spawn");
+
+      //advance procedural plant growth (time-driven branch growth) + leaf unfurl
+
+    update_plants(clamped_dt);
+    update_leaf_growth(clamped_dt);
+
+    timings.plants = stopwatch.lap("World::plants");
+
+      //the phases that run concurrently (build_update_graph): leaf springs + plant meshes, droplet
+      //tracking -> raymarch upload / cohesion, water ripple steps
+
+    update_dt  = clamped_dt;
+    view_eye   = math::vec3f(camera->world_tm() * math::vec4f(0.0f, 0.0f, 0.0f, 1.0f));
+    view_scale = camera->projection_matrix()[1][1];
+
+    update_graph.run(jobs);
+    apply_droplet_tracking();
+
+    timings.parallel = stopwatch.lap("World::parallel");
+
+      //a single procedural plant grows from startup (see spawn_initial_plant / update_plants); the old
+      //water-triggered multi-plant spawning is disabled. Keep the droplet-landing chime.
+
+    if (fallen_droplet_particles_count > PLANT_FALLEN_DROPLET_PARTICLES_COUNT_THRESHOLD)
+    {
+      SoundPlayer::play_sound(SoundId::droplet_ground);
+      fallen_droplet_particles_count = 0;
     }
 
+      //sync bodies with scene
+
+    for (std::shared_ptr<PhysBodySync>& body : phys_bodies)
+      if (!body->settled)
+        body->sync_mesh(physics_alpha); // in between the last two physics steps
+
+    if (DROPLET_DEBUG_DRAW)
+      for (std::shared_ptr<PhysBodySync>& particle : droplet_particle_pool.bodies) // parked ones too (moved away)
+        particle->sync_mesh(physics_alpha);
+
       //move point lights for droplets
 
     for (std::shared_ptr<Droplet>& droplet : droplets)
     {
-      if (droplet->point_light)
+      if (droplet->point_light && !droplet->settled)
         droplet->point_light->set_position(droplet->center);
     }
 
@@ -2277,7 +3806,7 @@ struct World::Impl: RigidBodyWorldCommonData
 
       //play sound for interactions between droplets and leaves
 
-    if (clock() - last_leaf_contact_sound_played_time > PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING)
+    if (last_frame_time - last_leaf_contact_sound_played_time > PLAY_CONTACT_SOUND_IF_NO_CONTACTS_DURING)
     {
       if (leaves_collisions_count >= PLAY_CONTACT_SOUND_COLLISIONS_COUNT)
       {
@@ -2286,18 +3815,58 @@ struct World::Impl: RigidBodyWorldCommonData
         engine_log_debug("Droplet-leaf contact sound played");
 
         leaves_collisions_count = 0;
-        last_leaf_contact_sound_played_time = clock();
+        last_leaf_contact_sound_played_time = last_frame_time;
       }
     }
 
-      //update water surface
+      //upload the bone and leaf palettes the graph posed (GL: main thread)
 
-    for (int s = 0; s < last_substeps; ++s) // run the wave/swell sim once per fixed physics substep -> real-time, fps-independent
-      water_surface.update();
+    for (std::shared_ptr<Plant>& plant : plants)
+      if (plant->skeletonized)
+        upload_bone_palette(plant);
+
+    for (std::unique_ptr<LeafBatch>& batch : leaf_batches)
+      if (batch->dirty)
+        upload_leaf_palette(*batch);
+
+      //settled droplets skip the graph's raymarch update: refresh one only when the camera moved it to
+      //another LOD. Then upload the droplets' changed raymarch blocks and bricks (GL: main thread)
+
+    droplet_lod_counters = WorldDropletLodCounters();
+
+    for (std::shared_ptr<Droplet>& droplet : droplets)
+    {
+      if (droplet->settled && droplet->raymarch.lod != droplet_lod(droplet->center, droplet->raymarch.box_half_extent))
+        update_droplet_raymarch(droplet);
+
+      if (droplet->shown)
+        switch (droplet->raymarch.lod)
+        {
+          case DROPLET_LOD_FULL:     droplet_lod_counters.full++; break;
+          case DROPLET_LOD_REDUCED:  droplet_lod_counters.reduced++; break;
+          case DROPLET_LOD_IMPOSTOR: droplet_lod_counters.impostor++; break;
+        }
+
+      if (droplet->raymarch_dirty_begin < droplet->raymarch_dirty_end)
+        upload_droplet_raymarch(*droplet);
+
+      if (droplet->brick_dirty)
+        upload_droplet_brick(*droplet);
+    }
+
+    other += stopwatch.lap("World::sync");
+
+      //upload the water surface the graph stepped (GL: main thread)
+
+    water_surface.upload(math::vec3f(camera->world_tm() * math::vec4f(0.0f, 0.0f, 0.0f, 1.0f)));
+
+    timings.water += stopwatch.lap("World::water_upload");
 
       //update fireflies
 
     update_fireflies();
+
+    timings.other = other + stopwatch.lap("World::fireflies");
   }
 
   /// Input control
@@ -2392,3 +3961,60 @@ void World::inputRelease()
 {
   impl->inputRelease();
 }
+
+/// Profiling
+const WorldPhaseTimings& World::phase_timings() const
+{
+  return impl->timings;
+}
+
+const WorldSettleCounters& World::settle_counters() const
+{
+  return impl->settle_counters;
+}
+
+const WorldContactStats& World::contact_stats() const
+{
+  return impl->contact_stats;
+}
+
+const WorldDropletLodCounters& World::droplet_lod_counters() const
+{
+  return impl->droplet_lod_counters;
+}
+
+const WorldLeafShapeStats& World::leaf_shape_stats() const
+{
+  return impl->leaf_shapes.stats;
+}
+
+size_t World::droplet_particles_count() const
+{
+  return impl->droplet_particles_count();
+}
+
+/// Tuning
+void World::set_wind_accel(float accel)
+{
+  impl->tuning.set(LIVE_WIND_ACCEL, accel);
+}
+
+void World::set_physics_threads(bool threads)
+{
+  impl->tuning.set(LIVE_PHYSICS_THREADS, threads ? 1.0f : 0.0f);
+}
+
+bool World::assign_tuning(const char* assignment)
+{
+  return impl->tuning.assign(assignment);
+}
+
+void World::load_tuning(const char* path)
+{
+  impl->tuning.load_file(path);
+}
+
+void World::seed_random(unsigned int seed)
+{
+  random_engine.seed(seed);
+}
@@ -173,3 +173,34 @@ void IndexBuffer::resize(size_t new_count)
 {
   impl->resize(new_count);
 }
+
+///
+/// UniformBuffer
+///
+
+UniformBuffer::UniformBuffer(const DeviceContextPtr& context, size_t size)
+  : impl(std::make_shared<BufferImpl>(context, GL_UNIFORM_BUFFER, size, 1))
+{
+  impl->set_usage(GL_DYNAMIC_DRAW); // rewritten in place while it lives
+}
+
+size_t UniformBuffer::size() const
+{
+  return impl->count;
+}
+
+void UniformBuffer::set_data(size_t offset, size_t size, const void* data)
+{
+  engine_check(offset + size <= impl->count);
+
+  impl->set_data(offset, size, data);
+}
+
+void UniformBuffer::bind(size_t binding) const
+{
+  impl->context->make_current();
+
+  glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(binding), impl->vbo_id);
+
+  impl->context->check_errors();
+}
@@ -140,6 +140,11 @@ Texture Device::create_texture_cubemap(size_t width, size_t height, PixelFormat
   return Texture(impl->context, width, height, 6, format, mips_count);
 }
 
+Texture Device::create_texture3d(size_t width, size_t height, size_t depth, PixelFormat format)
+{
+  return Texture(impl->context, width, height, 1, format, 1, depth);
+}
+
 Texture Device::create_texture2d(const char* image_path, size_t mips_count)
 {
   media::image::Image image(image_path);
@@ -213,6 +218,11 @@ IndexBuffer Device::create_index_buffer(size_t count)
   return IndexBuffer(impl->context, count);
 }
 
+UniformBuffer Device::create_uniform_buffer(size_t size)
+{
+  return UniformBuffer(impl->context, size);
+}
+
 Shader Device::create_vertex_shader(const char* name, const char* source_code, int lineno_offset)
 {
   return Shader(impl->context, ShaderType_Vertex, name, source_code, lineno_offset);
@@ -52,6 +52,9 @@ struct RenderTarget
     {
       case PixelFormat_RGBA8:
       case PixelFormat_RGB16F:
+      case PixelFormat_R16F:
+      case PixelFormat_R32F:
+      case PixelFormat_RGBA32F:
         is_colored = true;
         attachment = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + render_target_index);
         break;
@@ -76,6 +79,9 @@ struct RenderTarget
     {
       case PixelFormat_RGBA8:
       case PixelFormat_RGB16F:
+      case PixelFormat_R16F:
+      case PixelFormat_R32F:
+      case PixelFormat_RGBA32F:
         is_colored = true;
         attachment = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + render_target_index);
         break;
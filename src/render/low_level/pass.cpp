@@ -94,12 +94,14 @@ struct PassPrimitive: public Primitive
   math::mat4f model_tm;
   PropertyMap properties;
   TextureList textures;
+  const UniformBuffer* uniform_buffer; //not owned
 
-  PassPrimitive(const Primitive& primitive, const math::mat4f& tm, const PropertyMap& properties, const TextureList& textures)
+  PassPrimitive(const Primitive& primitive, const math::mat4f& tm, const PropertyMap& properties, const TextureList& textures, const UniformBuffer* uniform_buffer)
     : Primitive(primitive)
     , model_tm(tm)
     , properties(properties)
     , textures(textures)
+    , uniform_buffer(uniform_buffer)
   {
 
   }
@@ -223,6 +225,7 @@ struct Pass::Impl
       //setup shader parameters and textures
 
     bind_program_parameters(program, bindings);
+    bind_uniform_block(program, primitive);
 
       //setup buffers
 
@@ -322,6 +325,23 @@ struct Pass::Impl
     }
   }
 
+  void bind_uniform_block(const Program& program, const PassPrimitive& primitive)
+  {
+    const ProgramUniformBlock* block = program.uniform_block();
+
+    if (!block)
+      return;
+
+    if (!primitive.uniform_buffer)
+      throw Exception::format("Can't find shader program '%s' uniform block '%s'", program.name(), block->name.c_str());
+
+    if (primitive.uniform_buffer->size() < block->size)
+      throw Exception::format("Program '%s' uniform block '%s' size mismatch: expected %u bytes, got %u",
+        program.name(), block->name.c_str(), (unsigned int)block->size, (unsigned int)primitive.uniform_buffer->size());
+
+    primitive.uniform_buffer->bind(block->binding);
+  }
+
   void bind_sampler(const Program& program, const ProgramParameter& param, const Texture& texture, GLint active_texture)
   {
       //bind texture
@@ -641,20 +661,20 @@ TextureList& Pass::default_primitive_textures()
   return instance;
 }
 
-void Pass::add_primitive(const Primitive& primitive, const math::mat4f& model_tm, const PropertyMap& properties, const TextureList& textures)
+void Pass::add_primitive(const Primitive& primitive, const math::mat4f& model_tm, const PropertyMap& properties, const TextureList& textures, const UniformBuffer* uniform_buffer)
 {
-  impl->primitives.push_back(PassPrimitive(primitive, model_tm, properties, textures));
+  impl->primitives.push_back(PassPrimitive(primitive, model_tm, properties, textures, uniform_buffer));
 }
 
 /// Add mesh to a pass
-void Pass::add_mesh(const Mesh& mesh, const math::mat4f& model_tm, size_t first_primitive, size_t primitives_count, const PropertyMap& properties, const TextureList& textures)
+void Pass::add_mesh(const Mesh& mesh, const math::mat4f& model_tm, size_t first_primitive, size_t primitives_count, const PropertyMap& properties, const TextureList& textures, const UniformBuffer* uniform_buffer)
 {
   for (size_t i=0, max_count = mesh.primitives_count(); i < primitives_count; i++)
   {
     if (first_primitive + i >= max_count)
       break;
 
-    add_primitive(mesh.primitive(i + first_primitive), model_tm, properties, textures);
+    add_primitive(mesh.primitive(i + first_primitive), model_tm, properties, textures, uniform_buffer);
   }
 }
 
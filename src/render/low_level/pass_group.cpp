@@ -124,7 +124,8 @@ void PassGroup::add_mesh(
   size_t first_primitive,
   size_t primitives_count,
   const PropertyMap& properties,
-  const TextureList& textures)
+  const TextureList& textures,
+  const UniformBuffer* uniform_buffer)
 {
   for (size_t i=0, max_count = mesh.primitives_count(); i < primitives_count; i++)
   {
@@ -153,7 +154,7 @@ void PassGroup::add_mesh(
     Pass pass = entry->pass;
     int priority = entry->priority;
 
-    pass.add_primitive(primitive, model_tm, properties, textures);
+    pass.add_primitive(primitive, model_tm, properties, textures, uniform_buffer);
   }
 }
 
@@ -35,6 +35,15 @@ struct RenderBuffer::Impl
         case PixelFormat_RGB16F:
           gl_internal_format = GL_RGB16F;
           break;
+        case PixelFormat_R16F:
+          gl_internal_format = GL_R16F;
+          break;
+        case PixelFormat_R32F:
+          gl_internal_format = GL_R32F;
+          break;
+        case PixelFormat_RGBA32F:
+          gl_internal_format = GL_RGBA32F;
+          break;
         case PixelFormat_D24:
           gl_internal_format = GL_DEPTH_COMPONENT24; //sized format required for renderbuffer storage in GL ES 3.0 / WebGL2
           break;
@@ -47,13 +47,36 @@ struct engine::render::low_level::ShaderImpl
 
     shader_id = glCreateShader(gl_type);
 
+      //a #version directive must stay the first line: move it ahead of the #line
+      //(GL ES 3.00 sources are compiled as 4.10 core by the desktop context; the syntax is a subset)
+
+    std::string version;
+    const char* first_line = source_code + strspn(source_code, " \t\r\n");
+
+    if (!strncmp(first_line, "#version", 8))
+    {
+      const char* line_end = strchr(first_line, '\n');
+
+      source_code = line_end ? line_end + 1 : first_line + strlen(first_line);
+
+      version.assign(first_line, source_code);
+
+#ifndef __EMSCRIPTEN__
+      if (version.find("300 es") != std::string::npos)
+        version = "#version 410 core";
+#endif
+
+      version += '\n';
+      lineno_offset++;
+    }
+
       //compile shader
 
     char line_number_buffer[64];
     engine::common::xsnprintf(line_number_buffer, sizeof line_number_buffer, "#line %d\n", lineno_offset);
 
-    const char* sources[2] = {line_number_buffer, source_code};
-    GLint sources_length[2] = {(int)strlen(sources[0]), (int)strlen(sources[1])};
+    const char* sources[3] = {version.c_str(), line_number_buffer, source_code};
+    GLint sources_length[3] = {(int)strlen(sources[0]), (int)strlen(sources[1]), (int)strlen(sources[2])};
 
     glShaderSource(shader_id, sizeof sources / sizeof *sources, sources, sources_length);
     glCompileShader(shader_id);
@@ -166,6 +189,7 @@ struct Program::Impl
   std::string name; //program name
   GLuint program_id; //GL program ID
   ProgramParameterArray parameters;
+  std::unique_ptr<ProgramUniformBlock> uniform_block; //per-primitive uniform block, if any
 
   Impl(const DeviceContextPtr& context, const char* name, const Shader& vertex_shader, const Shader& pixel_shader)
     : context(context)
@@ -267,6 +291,16 @@ struct Program::Impl
         
       parameter_name.resize(name_length);
 
+        //members of a uniform block come with its buffer
+
+      GLuint uniform_index = GLuint(i);
+      GLint  block_index   = -1;
+
+      glGetActiveUniformsiv(program_id, 1, &uniform_index, GL_UNIFORM_BLOCK_INDEX, &block_index);
+
+      if (block_index >= 0)
+        continue;
+
       if (strstr(parameter_name.c_str(), "[0]") == &*parameter_name.end() - 3)
         parameter_name.resize(parameter_name.size () - 3);
 
@@ -330,6 +364,33 @@ struct Program::Impl
       parameters.emplace_back(std::move(parameter));
     }
 
+      //get the uniform block: data of one primitive, bound per draw (see Pass)
+
+    GLint blocks_count = 0;
+
+    glGetProgramiv(program_id, GL_ACTIVE_UNIFORM_BLOCKS, &blocks_count);
+
+    if (blocks_count > 1)
+      throw Exception::format("Program '%s' has %d uniform blocks; one per-primitive block is supported", name, blocks_count);
+
+    if (blocks_count)
+    {
+      GLint  block_size = 0;
+      GLchar block_name[128] = "";
+
+      glGetActiveUniformBlockiv(program_id, 0, GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
+      glGetActiveUniformBlockName(program_id, 0, sizeof block_name, nullptr, block_name);
+      glUniformBlockBinding(program_id, 0, 0);
+
+      uniform_block.reset(new ProgramUniformBlock);
+
+      uniform_block->name    = block_name;
+      uniform_block->binding = 0;
+      uniform_block->size    = size_t(block_size);
+
+      engine_log_debug("...uniform block '%s' (%u bytes) at binding %u", block_name, unsigned(block_size), 0u);
+    }
+
       //check errors
 
     context->check_errors();
@@ -426,3 +487,8 @@ const ProgramParameter* Program::parameters() const
 
   return &impl->parameters[0];
 }
+
+const ProgramUniformBlock* Program::uniform_block() const
+{
+  return impl->uniform_block.get();
+}
@@ -27,6 +27,7 @@ extern "C"
 #include <emscripten.h>
 #define GL_GLEXT_PROTOTYPES
 #define EGL_EGLEXT_PROTOTYPES
+#define GLFW_INCLUDE_ES3 //WebGL2: uniform buffers
 #include <GLFW/glfw3.h>
 #endif
 
@@ -212,4 +213,17 @@ struct ProgramParameter
   { }
 };
 
+/// Program uniform block
+struct ProgramUniformBlock
+{
+  std::string name; //block name
+  size_t binding; //binding point of the block's buffer
+  size_t size; //minimal buffer size in bytes
+
+  ProgramUniformBlock()
+    : binding()
+    , size()
+  { }
+};
+
 }}}
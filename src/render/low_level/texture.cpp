@@ -30,6 +30,7 @@ struct Texture::Impl
   size_t width; //texture width
   size_t height; //texture height
   size_t layers; //number of layers
+  size_t depth; //depth of a 3D texture (1 otherwise)
   size_t mips_count; //number of mipmaps
   PixelFormat format; //pixel format
   TextureFilter min_filter; //minimal filter
@@ -46,11 +47,13 @@ struct Texture::Impl
        size_t height,
        size_t layers,
        PixelFormat format,
-       size_t mips_count)
+       size_t mips_count,
+       size_t depth)
     : context(context)
     , width(width)
     , height(height)
     , layers(layers)
+    , depth(depth)
     , mips_count(mips_count)
     , format(format)
     , min_filter(TextureFilter_Linear)
@@ -84,6 +87,21 @@ struct Texture::Impl
         gl_uncompressed_format = GL_RGB;
         gl_uncompressed_type = GL_FLOAT;
         break;
+      case PixelFormat_R16F:
+        gl_internal_format = GL_R16F; //filterable in WebGL2; accepts GL_FLOAT uploads
+        gl_uncompressed_format = GL_RED;
+        gl_uncompressed_type = GL_FLOAT;
+        break;
+      case PixelFormat_R32F:
+        gl_internal_format = GL_R32F; //not filterable without OES_texture_float_linear -> sample with TextureFilter_Point
+        gl_uncompressed_format = GL_RED;
+        gl_uncompressed_type = GL_FLOAT;
+        break;
+      case PixelFormat_RGBA32F:
+        gl_internal_format = GL_RGBA32F; //same: TextureFilter_Point
+        gl_uncompressed_format = GL_RGBA;
+        gl_uncompressed_type = GL_FLOAT;
+        break;
       case PixelFormat_D24:
         gl_internal_format = GL_DEPTH_COMPONENT24; //sized format required for an attachable/renderable depth texture in GL ES 3.0 / WebGL2
         gl_uncompressed_format = GL_DEPTH_COMPONENT;
@@ -98,7 +116,20 @@ struct Texture::Impl
         throw Exception::format("Invalid texture pixel format %d", format);
     }
 
-    switch (layers)
+    if (depth > 1)
+    {
+      engine_check(layers == 1);
+
+      target           = GL_TEXTURE_3D;
+      mips_count       = 1; //volumes are sampled at one level
+      this->mips_count = 1;
+
+      bind();
+
+      glTexImage3D(target, 0, gl_internal_format, static_cast<GLsizei>(width), static_cast<GLsizei>(height), static_cast<GLsizei>(depth), 0,
+        gl_uncompressed_format, gl_uncompressed_type, nullptr);
+    }
+    else switch (layers)
     {
       case 1:
       {
@@ -227,13 +258,20 @@ struct Texture::Impl
       glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 #endif
     }
+    else if (target == GL_TEXTURE_3D)
+    {
+      //volumes cover a bounded region: no wrap-around at its faces
+      glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    }
 
     need_reapply_sampler = false;
   }
 };
 
-Texture::Texture(const DeviceContextPtr& context, size_t width, size_t height, size_t layers, PixelFormat format, size_t mips_count)
-  : impl(std::make_shared<Impl>(context, width, height, layers, format, mips_count))
+Texture::Texture(const DeviceContextPtr& context, size_t width, size_t height, size_t layers, PixelFormat format, size_t mips_count, size_t depth)
+  : impl(std::make_shared<Impl>(context, width, height, layers, format, mips_count, depth))
 {
 }
 
@@ -252,6 +290,11 @@ size_t Texture::layers() const
   return impl->layers;
 }
 
+size_t Texture::depth() const
+{
+  return impl->depth;
+}
+
 size_t Texture::mips_count() const
 {
   return impl->mips_count;
@@ -270,6 +313,7 @@ TextureFilter Texture::min_filter() const
 void Texture::set_min_filter(TextureFilter filter)
 {
   impl->min_filter = filter;
+  impl->need_reapply_sampler = true; //the constructor's bind() already applied the defaults
 }
 
 TextureFilter Texture::mag_filter() const
@@ -280,6 +324,7 @@ TextureFilter Texture::mag_filter() const
 void Texture::set_mag_filter(TextureFilter filter)
 {
   impl->mag_filter = filter;
+  impl->need_reapply_sampler = true;
 }
 
 void Texture::set_data(size_t layer, size_t x, size_t y, size_t width, size_t height, const void* data)
@@ -291,6 +336,7 @@ void Texture::set_data(size_t layer, size_t x, size_t y, size_t width, size_t he
     case 1:
     {
       engine_check(layer == 0);
+      engine_check(impl->depth == 1);
 
       glTexSubImage2D (GL_TEXTURE_2D, 0, (GLint)x, (GLint)y, (GLint)width, (GLint)height, impl->gl_uncompressed_format, impl->gl_uncompressed_type, data);
       break;
@@ -317,6 +363,16 @@ void Texture::set_data(size_t layer, size_t x, size_t y, size_t width, size_t he
   }
 }
 
+void Texture::set_data(size_t x, size_t y, size_t z, size_t width, size_t height, size_t depth, const void* data)
+{
+  engine_check(impl->depth > 1);
+
+  bind();
+
+  glTexSubImage3D(GL_TEXTURE_3D, 0, (GLint)x, (GLint)y, (GLint)z, (GLint)width, (GLint)height, (GLint)depth,
+    impl->gl_uncompressed_format, impl->gl_uncompressed_type, data);
+}
+
 void Texture::get_data(size_t layer, size_t x, size_t y, size_t width, size_t height, void* data)
 {
   unimplemented();
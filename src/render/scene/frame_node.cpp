@@ -126,6 +126,8 @@ size_t FrameNode::rendered_enumeration_id() const
 
 void FrameNode::render(ScenePassContext& context)
 {
+  engine_profile_zone("FrameNode::render");
+
     //render dependencies
 
   FrameId current_frame_id = context.current_frame_id();
@@ -147,9 +147,13 @@ namespace
     PassArray dependencies;          // dependent scene passes
     size_t prerendered_enumeration_id; // prerendered subframe ID
     size_t rendered_enumeration_id;    // rendered subframe ID
+    const char *prerender_zone;      // profiler zone names
+    const char *render_zone;
 
     PassEntry(const char *name, const ScenePassPtr &pass, int priority)
         : pass(pass), name(name), priority(priority), prerendered_enumeration_id(), rendered_enumeration_id()
+        , prerender_zone(engine::common::profiler::intern(engine::common::format("prerender: %s", name).c_str()))
+        , render_zone(engine::common::profiler::intern(engine::common::format("render: %s", name).c_str()))
     {
     }
 
@@ -249,6 +253,8 @@ struct SceneRenderer::Impl : ISceneRenderer, public std::enable_shared_from_this
 
   void prerender_viewport(SceneRenderQueueEntry &entry)
   {
+    engine_profile_zone("SceneRenderer::prerender_viewport");
+
     struct RenderQueueGuard
     {
       SceneRenderer::Impl &impl;
@@ -319,6 +325,8 @@ struct SceneRenderer::Impl : ISceneRenderer, public std::enable_shared_from_this
 
   void render_viewport(SceneRenderQueueEntry &entry)
   {
+    engine_profile_zone("SceneRenderer::render_viewport");
+
     // recursive render children entries
 
     for (auto child = entry.first_child; child; child = child->next_child)
@@ -397,7 +405,11 @@ struct SceneRenderer::Impl : ISceneRenderer, public std::enable_shared_from_this
 
     // render pass
 
-    pass_entry->pass->prerender(context);
+    {
+      engine_profile_zone(pass_entry->prerender_zone);
+
+      pass_entry->pass->prerender(context);
+    }
 
     // update frame info
 
@@ -418,7 +430,11 @@ struct SceneRenderer::Impl : ISceneRenderer, public std::enable_shared_from_this
 
     // render pass
 
-    pass_entry->pass->render(context);
+    {
+      engine_profile_zone(pass_entry->render_zone);
+
+      pass_entry->pass->render(context);
+    }
 
     // update frame info
 
@@ -649,6 +665,8 @@ void SceneRenderer::render(const SceneViewport &scene_viewport)
     return;
   }
 
+  engine_profile_zone("SceneRenderer::render");
+
   // set root render queue entry
 
   impl->render_queue_root.subframe_id = ++impl->current_subframe_id;
@@ -6,6 +6,7 @@
 #include <common/exception.h>
 #include <common/string.h>
 #include <common/log.h>
+#include <common/profiler.h>
 
 #include <unordered_set>
 
@@ -1,5 +1,7 @@
 #include "shared.h"
 
+#include <common/file.h>
+
 using namespace engine::render::scene;
 using namespace engine::render::low_level;
 using namespace engine::scene;
@@ -20,8 +22,36 @@ static const char* SKY_PROGRAM_FILE = "media/shaders/sky.glsl";
 static const char* WATER_PROGRAM_FILE = "media/shaders/water.glsl";
 static const char* FIREFLY_PROGRAM_FILE = "media/shaders/firefly.glsl";
 static const char* DROPLET_FLUID_PROGRAM_FILE = "media/shaders/droplet_fluid.glsl";
+static const char* DROPLET_COMPOSITE_PROGRAM_FILE = "media/shaders/droplet_composite.glsl";
 static const char* FLOWER_PROGRAM_FILE = "media/shaders/flower.glsl";
 static const char* LEAF_PROGRAM_FILE = "media/shaders/leaf.glsl";
+static const char* DROPLET_RESOLUTION_DIVISOR_PROPERTY = "dropletResolutionDivisor"; // renderer property: droplets raymarched at 1/N resolution (1: directly in the view)
+static const size_t MAX_DROPLET_RESOLUTION_DIVISOR = 4;
+static const char* DROPLET_OFFSCREEN_DEFINE = "DROPLET_OFFSCREEN_TARGET"; // droplet_fluid.glsl's variant for the reduced-resolution target
+
+///
+/// Utilities
+///
+
+/// Program from a shader file with a #define added to each stage, right after its #version line
+/// (which must stay first); error line numbers of the variant are one off
+static Program create_program_variant(Device& device, const char* file_name, const char* variant_name, const char* define)
+{
+  std::string source_code = load_file_as_string(file_name);
+  std::string define_line = format("#define %s\n", define);
+
+  for (size_t pos=source_code.find("#version"); pos!=std::string::npos; pos=source_code.find("#version", pos))
+  {
+    pos = source_code.find('\n', pos);
+
+    if (pos == std::string::npos)
+      break;
+
+    source_code.insert(++pos, define_line);
+  }
+
+  return device.create_program_from_source(variant_name, source_code.c_str());
+}
 
 ///
 /// Forward lighting pass
@@ -37,6 +67,8 @@ struct ForwardLightingPass : IScenePass
       , water_program(device.create_program_from_file(WATER_PROGRAM_FILE))
       , firefly_program(device.create_program_from_file(FIREFLY_PROGRAM_FILE))
       , droplet_fluid_program(device.create_program_from_file(DROPLET_FLUID_PROGRAM_FILE))
+      , droplet_offscreen_program(create_program_variant(device, DROPLET_FLUID_PROGRAM_FILE, "droplet_fluid_offscreen", DROPLET_OFFSCREEN_DEFINE))
+      , droplet_composite_program(device.create_program_from_file(DROPLET_COMPOSITE_PROGRAM_FILE))
       , flower_program(device.create_program_from_file(FLOWER_PROGRAM_FILE))
       , leaf_program(device.create_program_from_file(LEAF_PROGRAM_FILE))
       , forward_lighting_pass(device.create_pass(forward_lighting_program))
@@ -45,8 +77,12 @@ struct ForwardLightingPass : IScenePass
       , water_pass(device.create_pass(water_program))
       , firefly_pass(device.create_pass(firefly_program))
       , droplet_fluid_pass(device.create_pass(droplet_fluid_program))
+      , droplet_offscreen_pass(device.create_pass(droplet_offscreen_program))
+      , droplet_composite_pass(device.create_pass(droplet_composite_program))
       , flower_pass(device.create_pass(flower_program))
       , leaf_pass(device.create_pass(leaf_program))
+      , droplet_composite_plane(device.create_plane(Material()))
+      , shared_properties(renderer.properties())
     {
       // procedural flowers/branches: opaque, depth-tested, two-sided. MUST NOT clear the framebuffer
       // (it draws on top of the forward-lighting scene) -- without Clear_None it wipes whatever the
@@ -54,10 +90,15 @@ struct ForwardLightingPass : IScenePass
       flower_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
       flower_pass.set_rasterizer_state(RasterizerState(false));
       flower_pass.set_clear_flags(Clear_None);
+      flower_pass.properties().set("plantGrowth", -1.0f); // a growing plant's material overrides it (flower.glsl)
+      flower_pass.properties().set("boneCount", 0.0f);    // a skinned plant's material overrides both
+      flower_pass.textures().insert("bonePalette", device.create_texture2d(3, 1, PixelFormat_RGBA32F, 1));
       // procedural leaves: same (textured, two-sided blades)
       leaf_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
       leaf_pass.set_rasterizer_state(RasterizerState(false));
       leaf_pass.set_clear_flags(Clear_None);
+      leaf_pass.properties().set("instanceCount", 0.0f); // a leaf batch's material overrides it and instancePalette (leaf.glsl)
+      leaf_pass.textures().insert("instancePalette", device.create_texture2d(4, 1, PixelFormat_RGBA32F, 1));
 
       forward_lighting_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
       // no back-face culling: the planar water-reflection render mirrors the scene (flips winding),
@@ -75,6 +116,22 @@ struct ForwardLightingPass : IScenePass
       droplet_fluid_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
       droplet_fluid_pass.set_rasterizer_state(RasterizerState(false));
       droplet_fluid_pass.set_clear_flags(Clear_None);
+      droplet_fluid_pass.textures().insert("distanceBrick", device.create_texture3d(2, 2, 2, PixelFormat_R16F)); // a baked droplet's own brick overrides it
+
+      // reduced-resolution droplets: the same raymarch (plus the hit's depth) into droplet_target, cleared
+      // only in the frames it is bound (see setup_droplet_target; an idle pass still clears its frame
+      // buffer); its depth test keeps the nearest droplet per texel
+      droplet_offscreen_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
+      droplet_offscreen_pass.set_rasterizer_state(RasterizerState(false));
+      droplet_offscreen_pass.set_clear_color(math::vec4f(0.0f));
+      droplet_offscreen_pass.set_clear_flags(Clear_None);
+      droplet_offscreen_pass.textures().insert("distanceBrick", device.create_texture3d(2, 2, 2, PixelFormat_R16F));
+
+      // ... then one fullscreen plane upsamples that target into the view. It writes the droplets' depth
+      // per pixel, so the scene's depth test keeps edges against leaves sharp.
+      droplet_composite_pass.set_depth_stencil_state(DepthStencilState(true, true, CompareMode_Less));
+      droplet_composite_pass.set_rasterizer_state(RasterizerState(false));
+      droplet_composite_pass.set_clear_flags(Clear_None);
 
       // sky is pinned to the far plane (z = w in the shader); LessEqual lets it pass against the cleared
       // background depth, and depth-write is off so it never occludes the scene at any camera distance
@@ -98,6 +155,8 @@ struct ForwardLightingPass : IScenePass
       pass_group.add_pass("leaf", leaf_pass, 0);       // procedural leaves (textured)
       pass_group.add_pass("fresnel", fresnel_pass, 1); // opaque droplets (convex-hull surface)
       pass_group.add_pass("droplet_fluid", droplet_fluid_pass, 1); // opaque droplets (metaball raymarch surface)
+      pass_group.add_pass("droplet_offscreen", droplet_offscreen_pass, 1); // reduced-resolution droplets (no material: fed by render_mesh)
+      pass_group.add_pass("droplet_composite", droplet_composite_pass, 1); // after droplet_offscreen (same priority, added later): those droplets into the view
       pass_group.add_pass("sky", sky_pass, 2);         // sky fills the background
       pass_group.add_pass("water", water_pass, 3);     // transparent water blends over everything
       pass_group.add_pass("firefly", firefly_pass, 4); // additive firefly glows on top
@@ -138,6 +197,8 @@ struct ForwardLightingPass : IScenePass
       leaf_pass.set_frame_buffer(context.default_frame_buffer());
       fresnel_pass.set_frame_buffer(context.default_frame_buffer());
       droplet_fluid_pass.set_frame_buffer(context.default_frame_buffer());
+      droplet_offscreen_pass.set_frame_buffer(context.default_frame_buffer());
+      droplet_composite_pass.set_frame_buffer(context.default_frame_buffer());
       sky_pass.set_frame_buffer(context.default_frame_buffer());
       water_pass.set_frame_buffer(context.default_frame_buffer());
       firefly_pass.set_frame_buffer(context.default_frame_buffer());
@@ -149,6 +210,8 @@ struct ForwardLightingPass : IScenePass
       leaf_pass.remove_all_primitives();
       fresnel_pass.remove_all_primitives();
       droplet_fluid_pass.remove_all_primitives();
+      droplet_offscreen_pass.remove_all_primitives();
+      droplet_composite_pass.remove_all_primitives();
       sky_pass.remove_all_primitives();
       water_pass.remove_all_primitives();
       firefly_pass.remove_all_primitives();
@@ -174,6 +237,10 @@ struct ForwardLightingPass : IScenePass
         break;
       }
 
+        //droplets at reduced resolution: raymarched into droplet_target, composited by droplet_composite_pass
+
+      setup_droplet_target(context);
+
         //configure params
 
       setup_point_lights(visitor.point_lights(), context);
@@ -215,16 +282,16 @@ struct ForwardLightingPass : IScenePass
 
       RenderableMesh* renderable_mesh = RenderableMesh::get(mesh.mesh(), context);
 
-        //metaball-raymarch droplets carry a per-node PropertyMap (their particle field); that marks
-        //them for the screen-space refraction + reflection-cubemap binding here and supplies their uniforms.
+        //metaball-raymarch droplets carry a per-node uniform buffer (their particle field, the shader's
+        //uniform block); that marks them for the screen-space refraction + reflection-cubemap binding here.
 
-      common::PropertyMap* node_props = mesh.find_user_data<common::PropertyMap>();
-      EnvironmentMap*      envmap     = EnvironmentMap::find(mesh);
-      WaterReflection*     water_rt   = WaterReflection::find(mesh);
+      UniformBuffer*   droplet_block = mesh.find_user_data<UniformBuffer>();
+      EnvironmentMap*  envmap        = EnvironmentMap::find(mesh);
+      WaterReflection* water_rt      = WaterReflection::find(mesh);
 
       TextureList prim_textures;
 
-      if (node_props)
+      if (droplet_block)
       {
           //droplet: screen-space refraction of the scene behind it (the leaf), plus a reflection cubemap
           //from the per-droplet dynamic env-map if present, else the skybox carried by the droplet material.
@@ -233,6 +300,9 @@ struct ForwardLightingPass : IScenePass
 
         if (envmap)
           prim_textures.insert("environmentMap", envmap->portal_texture);
+
+        if (Texture* brick = mesh.find_user_data<Texture>()) // baked distance brick (brickResolution in the block)
+          prim_textures.insert("distanceBrick", *brick);
       }
       else if (envmap)
         prim_textures = envmap->textures;
@@ -241,13 +311,65 @@ struct ForwardLightingPass : IScenePass
       else
         prim_textures = Pass::default_primitive_textures();
 
-      const common::PropertyMap& prim_properties = node_props ? *node_props
-                                                              : Pass::default_primitive_properties();
+        //add mesh to pass (a reduced-resolution droplet to the offscreen raymarch instead of its material's pass)
+
+      if (droplet_block && droplet_divisor > 1)
+        droplet_offscreen_pass.add_mesh(renderable_mesh->mesh, mesh.world_tm(), mesh.first_primitive(), mesh.primitives_count(),
+          Pass::default_primitive_properties(), prim_textures, droplet_block);
+      else
+        pass_group.add_mesh(renderable_mesh->mesh, mesh.world_tm(), mesh.first_primitive(), mesh.primitives_count(),
+          Pass::default_primitive_properties(), prim_textures, droplet_block);
+    }
+
+    void setup_droplet_target(ScenePassContext& context)
+    {
+        //divisor from the renderer's shared properties (set by the application; 1 if absent)
+
+      droplet_divisor = 1;
+
+      if (const common::Property* property = shared_properties.find(DROPLET_RESOLUTION_DIVISOR_PROPERTY))
+      {
+        float divisor = property->get<float>();
+
+        if (divisor > 1.0f)
+          droplet_divisor = std::min(size_t(divisor), MAX_DROPLET_RESOLUTION_DIVISOR);
+      }
+
+        //only when this view has droplets (the nested water / cubemap renders exclude them)
+
+      bool droplets = false;
+
+      for (auto& mesh : visitor.meshes())
+        if (mesh->find_user_data<UniformBuffer>())
+        {
+          droplets = true;
+          break;
+        }
 
-        //add mesh to pass
+      if (!droplets)
+        droplet_divisor = 1;
+
+      if (droplet_divisor == 1)
+      {
+        droplet_offscreen_pass.set_clear_flags(Clear_None);
+        return;
+      }
+
+        //target at 1/divisor of this view; its depth (cleared to 1) marks the texels without a droplet
+
+      if (ScaledRenderTarget::fit(droplet_target, context.device(), context.default_frame_buffer().viewport(), droplet_divisor, PixelFormat_RGBA8))
+      {
+        droplet_composite_pass.textures().remove("dropletTarget");
+        droplet_composite_pass.textures().remove("dropletDepth");
+        droplet_composite_pass.textures().insert("dropletTarget", droplet_target->color_texture);
+        droplet_composite_pass.textures().insert("dropletDepth", droplet_target->depth_texture);
+
+        engine_log_debug("Droplet target has been created: %ux%u", (unsigned) droplet_target->width, (unsigned) droplet_target->height);
+      }
 
-      pass_group.add_mesh(renderable_mesh->mesh, mesh.world_tm(), mesh.first_primitive(), mesh.primitives_count(), prim_properties,
-        prim_textures);
+      droplet_offscreen_pass.set_frame_buffer(droplet_target->frame_buffer);
+      droplet_offscreen_pass.set_clear_flags(Clear_All);
+      droplet_composite_pass.add_primitive(droplet_composite_plane);
     }
 
     void setup_point_lights(const PointLightArray& lights, ScenePassContext& context)
@@ -399,6 +521,8 @@ struct ForwardLightingPass : IScenePass
     Program water_program;
     Program firefly_program;
     Program droplet_fluid_program;
+    Program droplet_offscreen_program;
+    Program droplet_composite_program;
     Program flower_program;
     Program leaf_program;
     Pass forward_lighting_pass;
@@ -407,9 +531,15 @@ struct ForwardLightingPass : IScenePass
     Pass water_pass;
     Pass firefly_pass;
     Pass droplet_fluid_pass;
+    Pass droplet_offscreen_pass;
+    Pass droplet_composite_pass;
     Pass flower_pass;
     Pass leaf_pass;
+    Primitive droplet_composite_plane; // fullscreen plane for droplet_composite_pass
     PassGroup pass_group;
+    common::PropertyMap shared_properties; // the renderer's (dropletResolutionDivisor)
+    std::unique_ptr<ScaledRenderTarget> droplet_target; // reduced-resolution droplets, created on first use
+    size_t droplet_divisor = 1;           // this render's droplet resolution divisor (1: droplets drawn in the view)
     const low_level::Texture* scene_refraction_texture = nullptr; // water pass's scene-minus-droplets target, for droplet refraction
     FrameNode frame;    
     SceneVisitor visitor;
@@ -76,6 +76,11 @@ struct Shadow
 
     shadow_pass.set_frame_buffer(shadow_frame_buffer);
     shadow_pass.set_depth_stencil_state(low_level::DepthStencilState(true, true, low_level::CompareMode_Less));
+    shadow_pass.properties().set("plantGrowth", -1.0f); // a growing plant's material overrides it (shadow.glsl)
+    shadow_pass.properties().set("boneCount", 0.0f);    // a skinned plant's material overrides both
+    shadow_pass.textures().insert("bonePalette", device.create_texture2d(3, 1, low_level::PixelFormat_RGBA32F, 1));
+    shadow_pass.properties().set("instanceCount", 0.0f); // a leaf batch's material overrides it and instancePalette
+    shadow_pass.textures().insert("instancePalette", device.create_texture2d(4, 1, low_level::PixelFormat_RGBA32F, 1));
   }
 };
 
@@ -194,6 +199,60 @@ struct WaterReflection
   }
 };
 
+/// Offscreen colour + depth render target sized relative to a viewport: 1 / divisor of its size,
+/// rounded up. Both are textures (point-sampled), so a later pass can read the depth too. Re-created
+/// (fit) whenever that size changes
+struct ScaledRenderTarget
+{
+  low_level::Texture color_texture;
+  low_level::Texture depth_texture;
+  low_level::FrameBuffer frame_buffer;
+  size_t width;
+  size_t height;
+
+  ScaledRenderTarget(engine::render::low_level::Device& device, size_t w, size_t h, low_level::PixelFormat color_format)
+    : color_texture(device.create_texture2d(w, h, color_format, 1))
+    , depth_texture(device.create_texture2d(w, h, low_level::PixelFormat_D24, 1))
+    , frame_buffer(device.create_frame_buffer())
+    , width(w)
+    , height(h)
+  {
+    color_texture.set_min_filter(low_level::TextureFilter_Point);
+    color_texture.set_mag_filter(low_level::TextureFilter_Point);
+    depth_texture.set_min_filter(low_level::TextureFilter_Point); //depth textures are not filterable in WebGL2
+    depth_texture.set_mag_filter(low_level::TextureFilter_Point);
+
+    frame_buffer.attach_color_target(color_texture);
+    frame_buffer.attach_depth_buffer(depth_texture);
+    frame_buffer.reset_viewport();
+  }
+
+  /// Extent of a viewport side scaled down by divisor (at least one pixel)
+  static size_t scaled_size(int extent, size_t divisor)
+  {
+    size_t size = extent > 0 ? (size_t(extent) + divisor - 1) / divisor : 0;
+
+    return size ? size : 1;
+  }
+
+  /// Make target cover the viewport scaled down by divisor; true if it had to be (re)created
+  static bool fit(std::unique_ptr<ScaledRenderTarget>& target, engine::render::low_level::Device& device,
+    const low_level::Viewport& viewport, size_t divisor, low_level::PixelFormat color_format)
+  {
+    engine_check(divisor > 0);
+
+    size_t w = scaled_size(viewport.width, divisor);
+    size_t h = scaled_size(viewport.height, divisor);
+
+    if (target && target->width == w && target->height == h)
+      return false;
+
+    target.reset(new ScaledRenderTarget(device, w, h, color_format));
+
+    return true;
+  }
+};
+
 /// Projectile render data
 struct RenderableProjectile
 {